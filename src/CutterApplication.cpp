@@ -5,6 +5,8 @@
 #include "CutterConfig.h"
 #include "common/Decompiler.h"
 #include "common/ResourcePaths.h"
+#include "common/StartupProfiler.h"
+#include "common/GuiBenchmark.h"
 
 #include <QApplication>
 #include <QFileOpenEvent>
@@ -85,6 +87,13 @@ CutterApplication::CutterApplication(int &argc, char **argv) : QApplication(argc
         std::exit(1);
     }
 
+    if (!clOptions.startupProfilePath.isEmpty()) {
+        StartupProfiler::instance()->enable(clOptions.startupProfilePath);
+    }
+    if (!clOptions.guiBenchmarkPath.isEmpty()) {
+        GuiBenchmark::instance()->enable(clOptions.guiBenchmarkPath, clOptions.guiBenchmarkSteps);
+    }
+
     // Check rizin version
     QString rzversion = rz_core_version();
     QString localVersion = CUTTER_COMPILE_TIME_RZ_VERSION;
@@ -108,31 +117,49 @@ CutterApplication::CutterApplication(int &argc, char **argv) : QApplication(argc
     if (!clOptions.pythonHome.isEmpty()) {
         Python()->setPythonHome(clOptions.pythonHome);
     }
-    Python()->initialize();
+    {
+        StartupProfiler::Phase phase("startup", "Python()->initialize");
+        Python()->initialize();
+    }
 #endif
 
-    Core()->initialize(clOptions.enableRizinPlugins);
-    Core()->setSettings();
-    Config()->loadInitial();
-    Core()->loadCutterRC();
+    {
+        StartupProfiler::Phase phase("startup", "Core()->initialize");
+        Core()->initialize(clOptions.enableRizinPlugins);
+        Core()->setSettings();
+        Config()->loadInitial();
+    }
+    {
+        StartupProfiler::Phase phase("startup", "loadCutterRC");
+        Core()->loadCutterRC();
+    }
 
     Config()->setOutputRedirectionEnabled(clOptions.outputRedirectionEnabled);
 
-    if (JSDecDecompiler::isAvailable()) {
-        Core()->registerDecompiler(new JSDecDecompiler(Core()));
-    }
+    {
+        StartupProfiler::Phase phase("startup", "registerDecompilers");
+        if (JSDecDecompiler::isAvailable()) {
+            Core()->registerDecompiler(new JSDecDecompiler(Core()));
+        }
 
 #if CUTTER_RZGHIDRA_STATIC
-    Core()->registerDecompiler(new RzGhidraDecompiler(Core()));
+        Core()->registerDecompiler(new RzGhidraDecompiler(Core()));
 #endif
+    }
 
-    Plugins()->loadPlugins(clOptions.enableCutterPlugins);
+    {
+        StartupProfiler::Phase phase("startup", "Plugins()->loadPlugins");
+        Plugins()->loadPlugins(clOptions.enableCutterPlugins);
 
-    for (auto &plugin : Plugins()->getPlugins()) {
-        plugin->registerDecompilers();
+        for (auto &plugin : Plugins()->getPlugins()) {
+            plugin->registerDecompilers();
+        }
     }
 
-    mainWindow = new MainWindow();
+    {
+        StartupProfiler::Phase phase("startup", "MainWindow");
+        mainWindow = new MainWindow();
+    }
     installEventFilter(mainWindow);
 
     // set up context menu shortcut display fix
@@ -204,6 +231,8 @@ CutterApplication::CutterApplication(int &argc, char **argv) : QApplication(argc
 
 CutterApplication::~CutterApplication()
 {
+    // No file was opened, report what was collected until now
+    StartupProfiler::instance()->finish();
     Plugins()->destroyPlugins();
     delete mainWindow;
 #ifdef CUTTER_ENABLE_PYTHON
@@ -372,6 +401,27 @@ bool CutterApplication::parseCommandLineOptions()
                                            QObject::tr("Do not load rizin plugins"));
     cmd_parser.addOption(disableRizinPlugins);
 
+    QCommandLineOption profileStartupOption(
+            "profile-startup",
+            QObject::tr("Measure the phases of startup, file loading and analysis and write "
+                        "them as JSON to the given file"),
+            QObject::tr("file"));
+    cmd_parser.addOption(profileStartupOption);
+
+    QCommandLineOption benchmarkGuiOption(
+            "benchmark-gui",
+            QObject::tr("Scroll, pan, seek and step through the opened file, write frame times, "
+                        "rizin command and allocation counts as JSON to the given file and quit"),
+            QObject::tr("file"));
+    cmd_parser.addOption(benchmarkGuiOption);
+
+    QCommandLineOption benchmarkGuiStepsOption(
+            "benchmark-gui-steps",
+            QObject::tr("Number of pages, functions and debugger steps of each interaction of "
+                        "--benchmark-gui, 20 by default"),
+            QObject::tr("count"));
+    cmd_parser.addOption(benchmarkGuiStepsOption);
+
     cmd_parser.process(*this);
 
     CutterCommandLineOptions opts;
@@ -401,6 +451,26 @@ bool CutterApplication::parseCommandLineOptions()
         }
     }
 
+    if (cmd_parser.isSet(benchmarkGuiOption)) {
+        opts.guiBenchmarkPath = cmd_parser.value(benchmarkGuiOption);
+        if (cmd_parser.isSet(benchmarkGuiStepsOption)) {
+            bool stepsSpecified = false;
+            opts.guiBenchmarkSteps =
+                    cmd_parser.value(benchmarkGuiStepsOption).toInt(&stepsSpecified);
+            if (!stepsSpecified || opts.guiBenchmarkSteps < 1) {
+                fprintf(stderr, "%s\n",
+                        QObject::tr("Invalid number of benchmark steps.")
+                                .toLocal8Bit()
+                                .constData());
+                return false;
+            }
+        }
+        // The benchmark can't answer the initial options dialog
+        if (opts.analLevel == AutomaticAnalysisLevel::Ask) {
+            opts.analLevel = AutomaticAnalysisLevel::AAA;
+        }
+    }
+
     if (opts.args.empty() && opts.analLevel != AutomaticAnalysisLevel::Ask) {
         fprintf(stderr, "%s\n",
                 QObject::tr("Filename must be specified to start analysis automatically.")
@@ -458,6 +528,10 @@ bool CutterApplication::parseCommandLineOptions()
         opts.enableRizinPlugins = false;
     }
 
+    if (cmd_parser.isSet(profileStartupOption)) {
+        opts.startupProfilePath = cmd_parser.value(profileStartupOption);
+    }
+
     this->clOptions = opts;
     return true;
 }
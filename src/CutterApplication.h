@@ -19,6 +19,9 @@ struct CutterCommandLineOptions
     bool outputRedirectionEnabled = true;
     bool enableCutterPlugins = true;
     bool enableRizinPlugins = true;
+    QString startupProfilePath;
+    QString guiBenchmarkPath;
+    int guiBenchmarkSteps = 20;
 };
 
 class CutterApplication : public QApplication
@@ -5,6 +5,8 @@
 #include "CutterConfig.h"
 #include "common/CrashHandler.h"
 #include "common/SettingsUpgrade.h"
+#include "common/StartupProfiler.h"
+#include "common/FileDigestTask.h"
 
 #include <QJsonObject>
 #include <QJsonArray>
@@ -52,6 +54,9 @@ static void connectToConsole()
 
 int main(int argc, char *argv[])
 {
+    // Start the clock startup phases are measured against
+    StartupProfiler::instance();
+
 #ifdef CUTTER_ENABLE_CRASH_REPORTS
     if (argc >= 3 && QString::fromLocal8Bit(argv[1]) == "--start-crash-handler") {
         QApplication app(argc, argv);
@@ -69,6 +74,9 @@ int main(int argc, char *argv[])
 
     qRegisterMetaType<QList<StringDescription>>();
     qRegisterMetaType<QList<FunctionDescription>>();
+    qRegisterMetaType<QList<SearchDescription>>();
+    qRegisterMetaType<QVector<quint64>>();
+    qRegisterMetaType<FileDigest>();
 
     QCoreApplication::setOrganizationName("rizin");
     QCoreApplication::setApplicationName("cutter");
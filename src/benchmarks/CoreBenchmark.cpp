@@ -0,0 +1,405 @@
+/**
+ * @file CoreBenchmark.cpp
+ * @brief Measures the CutterCore data accessors the widgets are built on, without MainWindow.
+ *
+ * The reference binaries given on the command line are processed in order of size. Each one is
+ * loaded and analyzed in a child process of its own, so the binaries don't influence each other.
+ * Every accessor is called --repeat times and the latency of the first call and of all calls, the
+ * throughput in returned items per second, the growth of the peak resident set size (Linux only)
+ * and the core lock acquisitions and rizin commands per call are reported. The JSON written with
+ * --json contains the size and SHA-256 of every binary, results are only comparable between
+ * commits if those match.
+ */
+
+#include "CutterConfig.h"
+#include "common/Configuration.h"
+#include "core/Cutter.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTemporaryFile>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+
+namespace {
+
+struct Accessor
+{
+    QString name;
+    std::function<size_t()> call;
+};
+
+template<typename List>
+size_t itemCount(const List &list)
+{
+    return static_cast<size_t>(list.size());
+}
+
+size_t itemCount(const QJsonDocument &doc)
+{
+    return static_cast<size_t>(doc.isArray() ? doc.array().size() : doc.object().size());
+}
+
+size_t itemCount(const BlockStatistics &statistics)
+{
+    return static_cast<size_t>(statistics.blocks.size());
+}
+
+// The accessor is named after the call, e.g. "getXRefs(function, true, false)"
+#define CORE_ACCESSOR(...)                                                                         \
+    {                                                                                              \
+        QStringLiteral(#__VA_ARGS__), [=]() { return itemCount(Core()->__VA_ARGS__); }             \
+    }
+
+/**
+ * @param function the function with most basic blocks, for the accessors taking an address
+ */
+QVector<Accessor> coreAccessors(RVA function)
+{
+    return {
+        CORE_ACCESSOR(getAllFunctions()),
+        CORE_ACCESSOR(getAllImports()),
+        CORE_ACCESSOR(getAllExports()),
+        CORE_ACCESSOR(getAllSymbols()),
+        CORE_ACCESSOR(getAllHeaders()),
+        CORE_ACCESSOR(getAllZignatures()),
+        CORE_ACCESSOR(getAllComments("CCu")),
+        CORE_ACCESSOR(getAllRelocs()),
+        CORE_ACCESSOR(getAllStrings()),
+        CORE_ACCESSOR(getAllFlagspaces()),
+        CORE_ACCESSOR(getAllFlags()),
+        CORE_ACCESSOR(getAllSections(false)),
+        CORE_ACCESSOR(getAllSections(true)),
+        CORE_ACCESSOR(getAllSegments()),
+        CORE_ACCESSOR(getAllEntrypoint()),
+        CORE_ACCESSOR(getAllClassesFromBin()),
+        CORE_ACCESSOR(getAllClassesFromFlags()),
+        CORE_ACCESSOR(getAllResources()),
+        CORE_ACCESSOR(getAllVTables()),
+        CORE_ACCESSOR(getAllTypes()),
+        CORE_ACCESSOR(getAllPrimitiveTypes()),
+        CORE_ACCESSOR(getAllUnions()),
+        CORE_ACCESSOR(getAllStructs()),
+        CORE_ACCESSOR(getAllEnums()),
+        CORE_ACCESSOR(getAllTypedefs()),
+        CORE_ACCESSOR(getAllAnalClasses(true)),
+        CORE_ACCESSOR(getAllSearch("lib", "/j", "io.maps")),
+        CORE_ACCESSOR(getMemoryMap()),
+        CORE_ACCESSOR(getBreakpoints()),
+        CORE_ACCESSOR(getOpenedFiles()),
+        CORE_ACCESSOR(getFileInfo()),
+        CORE_ACCESSOR(getSignatureInfo()),
+        CORE_ACCESSOR(getBlockStatistics(1000)),
+        CORE_ACCESSOR(disassembleLines(function, 100)),
+        CORE_ACCESSOR(getXRefs(function, true, false)),
+        CORE_ACCESSOR(getXRefs(function, false, true)),
+        CORE_ACCESSOR(getAddrRefs(function, 6)),
+    };
+}
+
+#undef CORE_ACCESSOR
+
+/**
+ * @return the value of a field of /proc/self/status in KiB or -1 if it isn't available
+ */
+qint64 processStatusKb(const char *field)
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.startsWith(field)) {
+            QByteArray value = line.mid(static_cast<int>(std::strlen(field))).simplified();
+            return value.split(' ')[0].toLongLong();
+        }
+    }
+#else
+    Q_UNUSED(field)
+#endif
+    return -1;
+}
+
+/**
+ * @brief Let the peak resident set size start over at the current one
+ * @return false if the platform doesn't support it
+ */
+bool resetPeakRss()
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/clear_refs");
+    return file.open(QIODevice::WriteOnly) && file.write("5") == 1;
+#else
+    return false;
+#endif
+}
+
+double ms(qint64 ns)
+{
+    return ns / 1e6;
+}
+
+QJsonValue optionalKb(qint64 kb)
+{
+    return kb < 0 ? QJsonValue() : QJsonValue(static_cast<double>(kb));
+}
+
+QJsonObject measureAccessor(const Accessor &accessor, int repeat)
+{
+    bool peakReset = resetPeakRss();
+    qint64 rssBefore = processStatusKb("VmRSS:");
+    quint64 locksBefore = Core()->getCoreLockCount();
+    quint64 commandsBefore = Core()->getCommandCount();
+
+    QVector<double> latencies;
+    size_t items = 0;
+    QElapsedTimer timer;
+    for (int i = 0; i < repeat; i++) {
+        timer.start();
+        items = accessor.call();
+        latencies.append(ms(timer.nsecsElapsed()));
+    }
+
+    qint64 peakGrowth = -1;
+    if (peakReset && rssBefore >= 0) {
+        peakGrowth = std::max<qint64>(0, processStatusKb("VmHWM:") - rssBefore);
+    }
+    double calls = repeat;
+    double first = latencies.first();
+    std::sort(latencies.begin(), latencies.end());
+    double median = latencies[latencies.size() / 2];
+
+    QJsonObject result;
+    result["name"] = accessor.name;
+    result["items"] = static_cast<double>(items);
+    result["firstMs"] = first;
+    result["minMs"] = latencies.first();
+    result["medianMs"] = median;
+    result["maxMs"] = latencies.last();
+    result["itemsPerSecond"] = median > 0 ? QJsonValue(items / (median / 1000)) : QJsonValue();
+    result["peakRssGrowthKb"] = optionalKb(peakGrowth);
+    result["coreLocksPerCall"] = (Core()->getCoreLockCount() - locksBefore) / calls;
+    result["rizinCommandsPerCall"] = (Core()->getCommandCount() - commandsBefore) / calls;
+    return result;
+}
+
+/**
+ * @brief Load and analyze \a path, measure all accessors and write the results to \a outputPath
+ */
+int runBinary(const QString &path, const QString &outputPath, int repeat, const QString &analysis,
+              bool rizinPlugins, const QString &filter)
+{
+    Core()->initialize(rizinPlugins);
+    Core()->setSettings();
+    Config()->loadInitial();
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!Core()->loadFile(path, 0, 0, RZ_PERM_R, 1, true)) {
+        std::fprintf(stderr, "Cannot load %s\n", qUtf8Printable(path));
+        return 1;
+    }
+    double loadMs = ms(timer.nsecsElapsed());
+    timer.start();
+    Core()->cmdRaw(analysis);
+    double analysisMs = ms(timer.nsecsElapsed());
+    qint64 analysisPeakRss = processStatusKb("VmHWM:");
+
+    QList<FunctionDescription> functions = Core()->getAllFunctions();
+    RVA function = Core()->getOffset();
+    RVA blockCount = 0;
+    for (const FunctionDescription &description : functions) {
+        if (description.nbbs > blockCount) {
+            blockCount = description.nbbs;
+            function = description.offset;
+        }
+    }
+
+    QJsonArray accessorArray;
+    for (const Accessor &accessor : coreAccessors(function)) {
+        if (filter.isEmpty() || accessor.name.contains(filter)) {
+            accessorArray.append(measureAccessor(accessor, repeat));
+        }
+    }
+
+    QFile input(path);
+    QByteArray sha256;
+    if (input.open(QIODevice::ReadOnly)) {
+        sha256 = QCryptographicHash::hash(input.readAll(), QCryptographicHash::Sha256).toHex();
+    }
+
+    QJsonObject result;
+    result["file"] = QFileInfo(path).fileName();
+    result["sizeBytes"] = static_cast<double>(QFileInfo(path).size());
+    result["sha256"] = QString::fromLatin1(sha256);
+    result["loadMs"] = loadMs;
+    result["analysisMs"] = analysisMs;
+    result["analysisPeakRssKb"] = optionalKb(analysisPeakRss);
+    result["functions"] = functions.size();
+    result["largestFunctionBlocks"] = static_cast<double>(blockCount);
+    result["accessors"] = accessorArray;
+
+    QFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        std::fprintf(stderr, "Cannot write %s\n", qUtf8Printable(outputPath));
+        return 1;
+    }
+    output.write(QJsonDocument(result).toJson(QJsonDocument::Compact));
+    return 0;
+}
+
+/**
+ * @brief Run this executable for a single binary
+ * @return the results or an empty object if it failed
+ */
+QJsonObject measureBinary(const QString &path, const QStringList &options)
+{
+    QTemporaryFile output;
+    if (!output.open()) {
+        std::fprintf(stderr, "Cannot create a temporary file\n");
+        return QJsonObject();
+    }
+    QProcess child;
+    // rizin may print to stdout, keep the table readable
+    child.setStandardOutputFile(QProcess::nullDevice());
+    child.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    child.start(QCoreApplication::applicationFilePath(),
+                QStringList(options) << "--binary-output" << output.fileName() << path);
+    if (!child.waitForFinished(-1) || child.exitStatus() != QProcess::NormalExit
+        || child.exitCode() != 0) {
+        std::fprintf(stderr, "Measuring %s failed\n", qUtf8Printable(path));
+        return QJsonObject();
+    }
+    return QJsonDocument::fromJson(output.readAll()).object();
+}
+
+void printBinary(const QJsonObject &binary)
+{
+    std::printf("\n%s: %.0f bytes, %d functions, load %.1f ms, analysis %.1f ms\n",
+                qUtf8Printable(binary["file"].toString()), binary["sizeBytes"].toDouble(),
+                binary["functions"].toInt(), binary["loadMs"].toDouble(),
+                binary["analysisMs"].toDouble());
+    std::printf("%-40s %8s %10s %10s %12s %10s %8s %8s\n", "accessor", "items", "first ms",
+                "median ms", "items/s", "peak KiB", "locks", "commands");
+    for (const QJsonValue &value : binary["accessors"].toArray()) {
+        QJsonObject accessor = value.toObject();
+        std::printf("%-40s %8.0f %10.3f %10.3f %12.0f %10.0f %8.1f %8.1f\n",
+                    qUtf8Printable(accessor["name"].toString()), accessor["items"].toDouble(),
+                    accessor["firstMs"].toDouble(), accessor["medianMs"].toDouble(),
+                    accessor["itemsPerSecond"].toDouble(-1),
+                    accessor["peakRssGrowthKb"].toDouble(-1),
+                    accessor["coreLocksPerCall"].toDouble(),
+                    accessor["rizinCommandsPerCall"].toDouble());
+    }
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // Configuration needs a QGuiApplication, nothing is shown
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    // Don't pick up the settings of an installed Cutter
+    QCoreApplication::setOrganizationName("rizin");
+    QCoreApplication::setApplicationName("cutter-core-benchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measure the CutterCore data accessors on reference binaries");
+    parser.addHelpOption();
+    parser.addPositionalArgument("binaries", "Reference binaries, measured in order of size",
+                                 "binary...");
+    QCommandLineOption repeatOption({ "r", "repeat" }, "Call each accessor n times", "n", "5");
+    parser.addOption(repeatOption);
+    QCommandLineOption analysisOption({ "a", "analysis" },
+                                      "Analysis command run after loading a binary", "command",
+                                      "aaa");
+    parser.addOption(analysisOption);
+    QCommandLineOption filterOption({ "f", "filter" },
+                                    "Only measure accessors whose name contains the text", "text");
+    parser.addOption(filterOption);
+    QCommandLineOption jsonOption({ "j", "json" }, "Write the results as JSON to the file", "file");
+    parser.addOption(jsonOption);
+    QCommandLineOption rizinPluginsOption("rizin-plugins", "Load the rizin plugins");
+    parser.addOption(rizinPluginsOption);
+    QCommandLineOption binaryOutputOption("binary-output",
+                                          "Measure a single binary in this process and write the "
+                                          "results to the file",
+                                          "file");
+    binaryOutputOption.setFlags(QCommandLineOption::HiddenFromHelp);
+    parser.addOption(binaryOutputOption);
+    parser.process(app);
+
+    const int repeat = std::max(1, parser.value(repeatOption).toInt());
+    const QString analysis = parser.value(analysisOption);
+    const QString filter = parser.value(filterOption);
+    const bool rizinPlugins = parser.isSet(rizinPluginsOption);
+    QStringList binaries = parser.positionalArguments();
+
+    if (parser.isSet(binaryOutputOption)) {
+        if (binaries.size() != 1) {
+            std::fprintf(stderr, "Exactly one binary is measured per process\n");
+            return 2;
+        }
+        return runBinary(binaries.first(), parser.value(binaryOutputOption), repeat, analysis,
+                         rizinPlugins, filter);
+    }
+    if (binaries.isEmpty()) {
+        parser.showHelp(2);
+    }
+
+    std::stable_sort(binaries.begin(), binaries.end(), [](const QString &a, const QString &b) {
+        return QFileInfo(a).size() < QFileInfo(b).size();
+    });
+    QStringList options = { "--repeat", QString::number(repeat), "--analysis", analysis };
+    if (!filter.isEmpty()) {
+        options << "--filter" << filter;
+    }
+    if (rizinPlugins) {
+        options << "--rizin-plugins";
+    }
+
+    QJsonArray binaryArray;
+    int failures = 0;
+    for (const QString &path : binaries) {
+        QJsonObject binary = measureBinary(path, options);
+        if (binary.isEmpty()) {
+            failures++;
+            continue;
+        }
+        printBinary(binary);
+        binaryArray.append(binary);
+    }
+
+    if (parser.isSet(jsonOption)) {
+        QJsonObject report;
+        report["cutterVersion"] = QStringLiteral(CUTTER_VERSION_FULL);
+        report["rizinVersion"] = QString::fromUtf8(rz_core_version());
+        report["repeat"] = repeat;
+        report["analysis"] = analysis;
+        report["binaries"] = binaryArray;
+        QFile file(parser.value(jsonOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::fprintf(stderr, "Cannot write %s\n", qUtf8Printable(file.fileName()));
+            return 1;
+        }
+        file.write(QJsonDocument(report).toJson());
+    }
+    return failures ? 1 : 0;
+}
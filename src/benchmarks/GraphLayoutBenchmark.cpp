@@ -0,0 +1,706 @@
+/**
+ * @file GraphLayoutBenchmark.cpp
+ * @brief Measures the graph layout algorithms on a corpus of synthetic and real control flow
+ * graphs.
+ *
+ * For every graph and layout the time of each layout phase, the peak heap usage and a checksum of
+ * the resulting positions are reported, and the result is checked for overlapping blocks and
+ * detached edges. Comparing the checksums before and after a change shows whether the layout
+ * itself changed. Real graphs can be added with --graph using the JSON written by rizin's agfj
+ * command. The exit code is non-zero if any layout breaks an invariant.
+ */
+
+#include "widgets/GraphGridLayout.h"
+#ifdef CUTTER_ENABLE_GRAPHVIZ
+#    include "widgets/GraphvizLayout.h"
+#endif
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using Graph = GraphLayout::Graph;
+
+// Heap usage of everything allocated through operator new, i.e. the std containers of the
+// layouts. Qt containers such as the edge polylines allocate with malloc and aren't included.
+std::atomic<size_t> heapCurrent(0);
+std::atomic<size_t> heapPeak(0);
+
+// Keeps the allocations aligned for any type
+const size_t kAllocationHeader = alignof(std::max_align_t);
+
+void resetHeapPeak()
+{
+    heapPeak = heapCurrent.load();
+}
+
+/**
+ * @brief Pseudo random numbers that are the same on every platform, so the synthetic graphs and
+ * with them the checksums can be compared between machines.
+ */
+class Random
+{
+public:
+    explicit Random(quint64 seed) : state(seed) {}
+
+    quint64 next()
+    {
+        // splitmix64
+        quint64 z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * @return number in the range [low, high]
+     */
+    int range(int low, int high)
+    {
+        return low + static_cast<int>(next() % static_cast<quint64>(high - low + 1));
+    }
+
+    bool chance(int percent) { return range(0, 99) < percent; }
+
+private:
+    quint64 state;
+};
+
+struct TestGraph
+{
+    QString name;
+    Graph graph;
+    ut64 entry = 0;
+};
+
+class GraphBuilder
+{
+public:
+    explicit GraphBuilder(quint64 seed) : random(seed) {}
+
+    ut64 addBlock()
+    {
+        ut64 id = nextId++;
+        GraphLayout::GraphBlock &block = graph[id];
+        block.entry = id;
+        // Roughly the size of disassembly blocks with a few up to a hundred instructions
+        block.width = random.range(80, 420);
+        block.height = 14 * random.range(1, 40) + 10;
+        return id;
+    }
+
+    void addEdge(ut64 from, ut64 to) { graph[from].edges.emplace_back(to); }
+
+    TestGraph finish(const QString &name, ut64 entry = 0)
+    {
+        TestGraph result;
+        result.name = name;
+        result.graph = std::move(graph);
+        result.entry = entry;
+        graph.clear();
+        return result;
+    }
+
+    Random random;
+
+private:
+    Graph graph;
+    ut64 nextId = 0;
+};
+
+TestGraph makeChain(int length)
+{
+    GraphBuilder builder(1);
+    ut64 previous = builder.addBlock();
+    for (int i = 1; i < length; i++) {
+        ut64 block = builder.addBlock();
+        builder.addEdge(previous, block);
+        previous = block;
+    }
+    return builder.finish(QString("chain-%1").arg(length));
+}
+
+TestGraph makeSwitch(int cases)
+{
+    GraphBuilder builder(2);
+    ut64 entry = builder.addBlock();
+    ut64 exit = builder.addBlock();
+    for (int i = 0; i < cases; i++) {
+        ut64 caseBlock = builder.addBlock();
+        builder.addEdge(entry, caseBlock);
+        builder.addEdge(caseBlock, exit);
+    }
+    builder.addEdge(entry, exit);
+    return builder.finish(QString("switch-%1").arg(cases), entry);
+}
+
+/**
+ * @brief If/else diamonds nested into each other up to the given depth, then chained.
+ */
+TestGraph makeDiamonds(int count)
+{
+    GraphBuilder builder(3);
+    ut64 entry = builder.addBlock();
+    ut64 tail = entry;
+    std::function<ut64(ut64, int)> diamond = [&](ut64 head, int depth) {
+        ut64 merge = builder.addBlock();
+        for (int side = 0; side < 2; side++) {
+            ut64 branch = builder.addBlock();
+            builder.addEdge(head, branch);
+            if (depth > 0 && builder.random.chance(60)) {
+                branch = diamond(branch, depth - 1);
+            }
+            builder.addEdge(branch, merge);
+        }
+        return merge;
+    };
+    for (int i = 0; i < count; i++) {
+        tail = diamond(tail, 4);
+    }
+    return builder.finish(QString("diamonds-%1").arg(count), entry);
+}
+
+/**
+ * @brief Loops nested up to the given depth with early exits and continues.
+ */
+TestGraph makeLoopNest(int count)
+{
+    GraphBuilder builder(4);
+    ut64 entry = builder.addBlock();
+    ut64 tail = entry;
+    std::function<ut64(ut64, ut64, int)> loop = [&](ut64 preheader, ut64 outerExit, int depth) {
+        ut64 header = builder.addBlock();
+        ut64 exit = builder.addBlock();
+        builder.addEdge(preheader, header);
+        ut64 body = builder.addBlock();
+        builder.addEdge(header, body);
+        builder.addEdge(header, exit);
+        if (depth > 0) {
+            body = loop(body, exit, depth - 1);
+        }
+        if (builder.random.chance(30)) {
+            builder.addEdge(body, outerExit);
+        }
+        ut64 latch = builder.addBlock();
+        builder.addEdge(body, latch);
+        builder.addEdge(latch, header);
+        if (builder.random.chance(20)) {
+            builder.addEdge(latch, exit);
+        }
+        return exit;
+    };
+    ut64 functionExit = builder.addBlock();
+    for (int i = 0; i < count; i++) {
+        tail = loop(tail, functionExit, builder.random.range(0, 3));
+    }
+    builder.addEdge(tail, functionExit);
+    return builder.finish(QString("loops-%1").arg(count), entry);
+}
+
+/**
+ * @brief Cycles that can be entered at more than one block, as produced by gotos or optimized
+ * state machines.
+ */
+TestGraph makeIrreducible(int count)
+{
+    GraphBuilder builder(5);
+    ut64 entry = builder.addBlock();
+    ut64 tail = entry;
+    for (int i = 0; i < count; i++) {
+        const int size = builder.random.range(2, 5);
+        std::vector<ut64> cycle;
+        for (int j = 0; j < size; j++) {
+            cycle.push_back(builder.addBlock());
+        }
+        for (int j = 0; j < size; j++) {
+            builder.addEdge(cycle[j], cycle[(j + 1) % size]);
+        }
+        builder.addEdge(tail, cycle[0]);
+        builder.addEdge(tail, cycle[builder.random.range(1, size - 1)]);
+        ut64 exit = builder.addBlock();
+        builder.addEdge(cycle[builder.random.range(0, size - 1)], exit);
+        tail = exit;
+    }
+    return builder.finish(QString("irreducible-%1").arg(count), entry);
+}
+
+/**
+ * @brief Mostly forward branching code with a few back edges, similar to large compiler generated
+ * functions.
+ */
+TestGraph makeRandomCfg(int size)
+{
+    GraphBuilder builder(6);
+    for (int i = 0; i < size; i++) {
+        builder.addBlock();
+    }
+    for (int i = 0; i + 1 < size; i++) {
+        builder.addEdge(i, i + 1);
+        if (builder.random.chance(40)) {
+            builder.addEdge(i, std::min(size - 1, i + builder.random.range(2, 30)));
+        }
+        if (builder.random.chance(5)) {
+            builder.addEdge(i, std::max(0, i - builder.random.range(1, 50)));
+        }
+    }
+    return builder.finish(QString("random-cfg-%1").arg(size));
+}
+
+/**
+ * @brief Call graph where a few functions are called from almost everywhere and there is some
+ * recursion.
+ */
+TestGraph makeCallGraph(int size)
+{
+    GraphBuilder builder(7);
+    for (int i = 0; i < size; i++) {
+        builder.addBlock();
+    }
+    for (int i = 0; i < size; i++) {
+        const int calls = builder.random.range(0, 5);
+        for (int j = 0; j < calls && i + 1 < size; j++) {
+            int callee;
+            if (builder.random.chance(20)) {
+                // Popular helper functions
+                callee = size - 1 - builder.random.range(0, 20);
+            } else {
+                callee = std::min(size - 1, i + builder.random.range(1, 200));
+            }
+            if (callee > i) {
+                builder.addEdge(i, callee);
+            }
+        }
+        if (i > 0 && builder.random.chance(3)) {
+            builder.addEdge(i, builder.random.range(0, i - 1));
+        }
+    }
+    return builder.finish(QString("callgraph-%1").arg(size));
+}
+
+QVector<TestGraph> syntheticGraphs()
+{
+    QVector<TestGraph> graphs;
+    graphs.append(makeChain(2000));
+    graphs.append(makeSwitch(1000));
+    graphs.append(makeDiamonds(300));
+    graphs.append(makeLoopNest(200));
+    graphs.append(makeIrreducible(500));
+    graphs.append(makeRandomCfg(5000));
+    graphs.append(makeCallGraph(50000));
+    return graphs;
+}
+
+ut64 jsonAddress(const QJsonValue &value)
+{
+    return static_cast<ut64>(value.toVariant().toULongLong());
+}
+
+/**
+ * @brief Load the functions of a file written by agfj, block sizes are estimated from the
+ * instructions.
+ */
+QVector<TestGraph> loadGraphs(const QString &path)
+{
+    QVector<TestGraph> graphs;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "Cannot open %s\n", qUtf8Printable(path));
+        return graphs;
+    }
+    QJsonArray functions = QJsonDocument::fromJson(file.readAll()).array();
+    for (const QJsonValue &functionValue : functions) {
+        QJsonObject function = functionValue.toObject();
+        TestGraph test;
+        test.name = function["name"].toString();
+        test.entry = jsonAddress(function["offset"]);
+        for (const QJsonValue &blockValue : function["blocks"].toArray()) {
+            QJsonObject blockJson = blockValue.toObject();
+            GraphLayout::GraphBlock block;
+            block.entry = jsonAddress(blockJson["offset"]);
+            QJsonArray ops = blockJson["ops"].toArray();
+            int longestLine = 0;
+            for (const QJsonValue &op : ops) {
+                longestLine = std::max(longestLine, op.toObject()["disasm"].toString().length());
+            }
+            block.width = 8 * (longestLine + 24);
+            block.height = 15 * (ops.size() + 1);
+            for (const char *key : { "jump", "fail" }) {
+                if (blockJson.contains(key)) {
+                    block.edges.emplace_back(jsonAddress(blockJson[key]));
+                }
+            }
+            QJsonArray cases = blockJson["switchop"].toObject()["cases"].toArray();
+            for (const QJsonValue &caseValue : cases) {
+                block.edges.emplace_back(jsonAddress(caseValue.toObject()["jump"]));
+            }
+            test.graph[block.entry] = block;
+        }
+        // Targets outside of the function
+        for (auto &it : test.graph) {
+            auto &edges = it.second.edges;
+            edges.erase(std::remove_if(edges.begin(), edges.end(),
+                                       [&](const GraphLayout::GraphEdge &edge) {
+                                           return !test.graph.count(edge.target);
+                                       }),
+                        edges.end());
+        }
+        if (!test.graph.empty()) {
+            graphs.append(std::move(test));
+        }
+    }
+    return graphs;
+}
+
+struct LayoutResult
+{
+    GraphGridLayout::PhaseTimings phases;
+    qint64 total = 0;
+    size_t peakHeap = 0;
+    quint64 checksum = 0;
+    QStringList errors;
+};
+
+quint64 layoutChecksum(const Graph &graph, int width, int height)
+{
+    // FNV-1a over the positions in address order
+    quint64 hash = 0xcbf29ce484222325ULL;
+    auto add = [&](qint64 value) {
+        hash ^= static_cast<quint64>(value);
+        hash *= 0x100000001b3ULL;
+    };
+    std::vector<ut64> ids;
+    ids.reserve(graph.size());
+    for (const auto &it : graph) {
+        ids.push_back(it.first);
+    }
+    std::sort(ids.begin(), ids.end());
+    add(width);
+    add(height);
+    for (ut64 id : ids) {
+        const auto &block = graph.at(id);
+        add(block.x);
+        add(block.y);
+        for (const auto &edge : block.edges) {
+            for (const QPointF &point : edge.polyline) {
+                add(qRound64(point.x()));
+                add(qRound64(point.y()));
+            }
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief Check that the blocks don't overlap, everything is within the reported size and the
+ * edges start and end at their blocks.
+ * @param orthogonal whether edges leave at the bottom and enter at the top with horizontal and
+ * vertical segments only, as in the grid layout
+ */
+QStringList checkLayout(const Graph &graph, int width, int height, bool orthogonal)
+{
+    QStringList errors;
+    const int kMaxErrors = 5;
+    auto fail = [&](const QString &error) {
+        if (errors.size() < kMaxErrors) {
+            errors.append(error);
+        }
+    };
+    auto inside = [&](const QPointF &point) {
+        return point.x() >= 0 && point.y() >= 0 && point.x() <= width && point.y() <= height;
+    };
+
+    // Blocks can only overlap with blocks in the same grid cell when cells are at least as large
+    // as the largest block
+    int cellWidth = 1;
+    int cellHeight = 1;
+    for (const auto &it : graph) {
+        cellWidth = std::max(cellWidth, it.second.width);
+        cellHeight = std::max(cellHeight, it.second.height);
+    }
+    std::unordered_map<quint64, std::vector<const GraphLayout::GraphBlock *>> cells;
+    for (const auto &it : graph) {
+        const auto &block = it.second;
+        if (!inside(QPointF(block.x, block.y))
+            || !inside(QPointF(block.x + block.width, block.y + block.height))) {
+            fail(QString("block %1 is outside of the graph").arg(RAddressString(block.entry)));
+        }
+        const int firstColumn = block.x / cellWidth;
+        const int firstRow = block.y / cellHeight;
+        for (int column = firstColumn; column <= (block.x + block.width) / cellWidth; column++) {
+            for (int row = firstRow; row <= (block.y + block.height) / cellHeight; row++) {
+                quint64 key = (static_cast<quint64>(static_cast<quint32>(column)) << 32)
+                        | static_cast<quint32>(row);
+                cells[key].push_back(&block);
+            }
+        }
+    }
+    for (const auto &cell : cells) {
+        const auto &blocks = cell.second;
+        for (size_t i = 0; i < blocks.size(); i++) {
+            for (size_t j = i + 1; j < blocks.size(); j++) {
+                const auto &a = *blocks[i];
+                const auto &b = *blocks[j];
+                if (a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height
+                    && b.y < a.y + a.height) {
+                    fail(QString("blocks %1 and %2 overlap")
+                                 .arg(RAddressString(a.entry))
+                                 .arg(RAddressString(b.entry)));
+                }
+            }
+        }
+    }
+
+    std::unordered_map<ut64, int> incomingEdges;
+    for (const auto &it : graph) {
+        for (const auto &edge : it.second.edges) {
+            incomingEdges[edge.target]++;
+        }
+    }
+    const int edgeSpacing = GraphLayout::LayoutConfig().edgeHorizontalSpacing;
+    for (const auto &it : graph) {
+        const auto &block = it.second;
+        for (const auto &edge : block.edges) {
+            const QString name = QString("edge %1 -> %2")
+                                         .arg(RAddressString(block.entry))
+                                         .arg(RAddressString(edge.target));
+            const auto &polyline = edge.polyline;
+            if (polyline.size() < 2) {
+                fail(name + " has no line");
+                continue;
+            }
+            for (const QPointF &point : polyline) {
+                if (!inside(point)) {
+                    fail(name + " is outside of the graph");
+                    break;
+                }
+            }
+            if (!orthogonal) {
+                continue;
+            }
+            const auto &target = graph.at(edge.target);
+            const QPointF &start = polyline.first();
+            const QPointF &end = polyline.last();
+            if (start.y() != block.y + block.height || start.x() < block.x
+                || start.x() > block.x + block.width) {
+                fail(name + " doesn't start at the bottom of its block");
+            }
+            // Incoming edges that don't fit next to each other above the block spill past its sides
+            const bool crowded = (incomingEdges[edge.target] + 1) * edgeSpacing > target.width;
+            if (end.y() != target.y
+                || (!crowded && (end.x() < target.x || end.x() > target.x + target.width))) {
+                fail(name + " doesn't end at the top of its target");
+            }
+            for (int i = 1; i < polyline.size(); i++) {
+                if (polyline[i].x() != polyline[i - 1].x()
+                    && polyline[i].y() != polyline[i - 1].y()) {
+                    fail(name + " has a diagonal segment");
+                    break;
+                }
+            }
+        }
+    }
+    return errors;
+}
+
+struct LayoutSpec
+{
+    QString name;
+    std::function<std::unique_ptr<GraphLayout>()> create;
+    bool orthogonal;
+};
+
+QVector<LayoutSpec> availableLayouts()
+{
+    QVector<LayoutSpec> layouts;
+    auto grid = [](GraphGridLayout::LayoutType type) {
+        return [type]() { return std::unique_ptr<GraphLayout>(new GraphGridLayout(type)); };
+    };
+    layouts.append({ "grid-medium", grid(GraphGridLayout::LayoutType::Medium), true });
+    layouts.append({ "grid-wide", grid(GraphGridLayout::LayoutType::Wide), true });
+    layouts.append({ "grid-narrow", grid(GraphGridLayout::LayoutType::Narrow), true });
+#ifdef CUTTER_ENABLE_GRAPHVIZ
+    auto graphviz = [](GraphvizLayout::LayoutType type) {
+        return [type]() { return std::unique_ptr<GraphLayout>(new GraphvizLayout(type)); };
+    };
+    layouts.append({ "graphviz-ortho", graphviz(GraphvizLayout::LayoutType::DotOrtho), false });
+    layouts.append(
+            { "graphviz-polyline", graphviz(GraphvizLayout::LayoutType::DotPolyline), false });
+    layouts.append({ "graphviz-sfdp", graphviz(GraphvizLayout::LayoutType::Sfdp), false });
+#endif
+    return layouts;
+}
+
+LayoutResult runLayout(const TestGraph &test, const LayoutSpec &spec)
+{
+    LayoutResult result;
+    Graph graph = test.graph;
+    std::unique_ptr<GraphLayout> layout = spec.create();
+    auto gridLayout = dynamic_cast<GraphGridLayout *>(layout.get());
+    if (gridLayout) {
+        gridLayout->setPhaseTimings(&result.phases);
+    }
+    int width = 0;
+    int height = 0;
+    const size_t heapBefore = heapCurrent;
+    resetHeapPeak();
+    QElapsedTimer timer;
+    timer.start();
+    layout->CalculateLayout(graph, test.entry, width, height);
+    result.total = timer.nsecsElapsed();
+    result.peakHeap = heapPeak - heapBefore;
+    result.checksum = layoutChecksum(graph, width, height);
+    result.errors = checkLayout(graph, width, height, spec.orthogonal);
+    return result;
+}
+
+double ms(qint64 ns)
+{
+    return ns / 1e6;
+}
+
+}
+
+void *operator new(size_t size)
+{
+    void *memory = std::malloc(size + kAllocationHeader);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t *>(memory) = size;
+    size_t current = heapCurrent += size;
+    size_t peak = heapPeak;
+    while (current > peak && !heapPeak.compare_exchange_weak(peak, current)) {
+    }
+    return static_cast<char *>(memory) + kAllocationHeader;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    if (!pointer) {
+        return;
+    }
+    void *memory = static_cast<char *>(pointer) - kAllocationHeader;
+    heapCurrent -= *static_cast<size_t *>(memory);
+    std::free(memory);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measure and check the graph layout algorithms");
+    parser.addHelpOption();
+    QCommandLineOption layoutOption(
+            { "l", "layout" },
+            "Comma separated layouts to run, \"all\" for every one. Default: grid-medium",
+            "layouts", "grid-medium");
+    parser.addOption(layoutOption);
+    QCommandLineOption graphOption({ "g", "graph" },
+                                   "Add the functions of a file written by rizin's agfj command",
+                                   "file");
+    parser.addOption(graphOption);
+    QCommandLineOption filterOption({ "f", "filter" },
+                                    "Only run graphs whose name contains the text", "text");
+    parser.addOption(filterOption);
+    QCommandLineOption repeatOption({ "r", "repeat" },
+                                    "Run each layout n times and report the fastest run", "n", "3");
+    parser.addOption(repeatOption);
+    QCommandLineOption noSyntheticOption("no-synthetic", "Skip the generated graphs");
+    parser.addOption(noSyntheticOption);
+    parser.process(app);
+
+    QVector<LayoutSpec> layouts;
+    const QStringList layoutNames =
+            parser.value(layoutOption).split(',', CUTTER_QT_SKIP_EMPTY_PARTS);
+    for (const LayoutSpec &spec : availableLayouts()) {
+        if (layoutNames.contains("all") || layoutNames.contains(spec.name)) {
+            layouts.append(spec);
+        }
+    }
+    if (layouts.isEmpty()) {
+        std::fprintf(stderr, "No known layout in %s\n", qUtf8Printable(parser.value(layoutOption)));
+        return 2;
+    }
+    const int repeat = std::max(1, parser.value(repeatOption).toInt());
+
+    QVector<TestGraph> graphs;
+    if (!parser.isSet(noSyntheticOption)) {
+        graphs = syntheticGraphs();
+    }
+    for (const QString &path : parser.values(graphOption)) {
+        graphs.append(loadGraphs(path));
+    }
+    const QString filter = parser.value(filterOption);
+
+    std::printf("%-24s %-17s %7s %7s %9s %8s %8s %8s %8s %8s %8s %8s %9s %9s  %-16s %s\n",
+                "graph", "layout", "blocks", "edges", "index", "topo", "place", "column",
+                "rough", "elaborate", "pixels", "optimize", "total ms", "heap MB", "checksum",
+                "status");
+    int failures = 0;
+    for (const TestGraph &test : graphs) {
+        if (!filter.isEmpty() && !test.name.contains(filter)) {
+            continue;
+        }
+        size_t edgeCount = 0;
+        for (const auto &it : test.graph) {
+            edgeCount += it.second.edges.size();
+        }
+        for (const LayoutSpec &spec : layouts) {
+            LayoutResult best;
+            QStringList errors;
+            for (int i = 0; i < repeat; i++) {
+                LayoutResult result = runLayout(test, spec);
+                if (i == 0) {
+                    errors = result.errors;
+                } else if (result.checksum != best.checksum) {
+                    errors.append("layout differs between runs");
+                }
+                if (i == 0 || result.total < best.total) {
+                    best = result;
+                }
+            }
+            best.errors = errors;
+            const auto &phases = best.phases;
+            std::printf("%-24s %-17s %7zu %7zu %9.2f %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f "
+                        "%9.2f %9.2f  %016llx %s\n",
+                        qUtf8Printable(test.name), qUtf8Printable(spec.name), test.graph.size(),
+                        edgeCount, ms(phases.indexGraph), ms(phases.topoSort),
+                        ms(phases.blockPlacement), ms(phases.edgeMainColumn),
+                        ms(phases.roughRouting), ms(phases.elaborateEdgePlacement),
+                        ms(phases.pixelCoordinates), ms(phases.optimizeLayout), ms(best.total),
+                        best.peakHeap / (1024.0 * 1024.0),
+                        static_cast<unsigned long long>(best.checksum),
+                        best.errors.isEmpty() ? "ok" : "FAILED");
+            for (const QString &error : best.errors) {
+                std::printf("    %s\n", qUtf8Printable(error));
+            }
+            if (!best.errors.isEmpty()) {
+                failures++;
+            }
+            std::fflush(stdout);
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file GuiBenchmarkTarget.cpp
+ * @brief Program opened by the GuiBenchmark target, it is also debugged for the debug.step
+ * interaction.
+ *
+ * It only needs to be deterministic and contain functions of different sizes, a small bytecode
+ * interpreter gives the graph a function with many blocks worth panning through.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+enum Opcode { Push, Add, Sub, Mul, Div, Dup, Swap, Jump, JumpIfZero, Print, Halt };
+
+struct Instruction
+{
+    Opcode opcode;
+    long operand;
+};
+
+long interpret(const Instruction *program, size_t length)
+{
+    long stack[64];
+    size_t sp = 0;
+    size_t pc = 0;
+    long printed = 0;
+    while (pc < length) {
+        const Instruction &instruction = program[pc++];
+        switch (instruction.opcode) {
+        case Push:
+            stack[sp++] = instruction.operand;
+            break;
+        case Add:
+            sp--;
+            stack[sp - 1] += stack[sp];
+            break;
+        case Sub:
+            sp--;
+            stack[sp - 1] -= stack[sp];
+            break;
+        case Mul:
+            sp--;
+            stack[sp - 1] *= stack[sp];
+            break;
+        case Div:
+            sp--;
+            stack[sp - 1] = stack[sp] ? stack[sp - 1] / stack[sp] : 0;
+            break;
+        case Dup:
+            stack[sp] = stack[sp - 1];
+            sp++;
+            break;
+        case Swap: {
+            long top = stack[sp - 1];
+            stack[sp - 1] = stack[sp - 2];
+            stack[sp - 2] = top;
+            break;
+        }
+        case Jump:
+            pc = static_cast<size_t>(instruction.operand);
+            break;
+        case JumpIfZero:
+            if (stack[--sp] == 0) {
+                pc = static_cast<size_t>(instruction.operand);
+            }
+            break;
+        case Print:
+            printed += stack[sp - 1];
+            std::printf("%ld\n", stack[sp - 1]);
+            break;
+        case Halt:
+            return printed;
+        }
+    }
+    return printed;
+}
+
+unsigned checksum(const char *text)
+{
+    unsigned hash = 2166136261u;
+    for (size_t i = 0; text[i]; i++) {
+        hash = (hash ^ static_cast<unsigned char>(text[i])) * 16777619u;
+    }
+    return hash;
+}
+
+long fibonacci(int n)
+{
+    return n < 2 ? n : fibonacci(n - 1) + fibonacci(n - 2);
+}
+
+int compareLongs(const void *a, const void *b)
+{
+    long x = *static_cast<const long *>(a);
+    long y = *static_cast<const long *>(b);
+    return (x > y) - (x < y);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // Counts down from 5 and prints every value
+    const Instruction program[] = {
+        { Push, 5 }, { Dup, 0 },        { Print, 0 }, { Push, 1 }, { Sub, 0 },
+        { Dup, 0 },  { JumpIfZero, 8 }, { Jump, 1 },  { Halt, 0 },
+    };
+    long printed = interpret(program, sizeof(program) / sizeof(program[0]));
+
+    long values[16];
+    for (int i = 0; i < 16; i++) {
+        values[i] = fibonacci(i) * ((i % 3) ? 1 : -1);
+    }
+    std::qsort(values, 16, sizeof(values[0]), compareLongs);
+
+    const char *name = argc > 1 ? argv[1] : "cutter";
+    std::printf("%ld %ld %u %zu\n", printed, values[0], checksum(name), std::strlen(name));
+    return 0;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file PatternSearchBenchmark.cpp
+ * @brief Measures the scan throughput of the AhoCorasickMatcher used by the multi-pattern search.
+ *
+ * Pattern sets with one to three distinct start bytes go through the memchr prefilter, larger ones
+ * through the byte table prefilter, so comparing their rows shows what the prefilter gains. The
+ * data is pseudo random and the same on every platform. The hits in the first MiB are checked
+ * against a naive search, the exit code is non-zero if they differ.
+ */
+
+#include "common/AhoCorasickMatcher.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const size_t kVerifiedSize = 1024 * 1024;
+
+/**
+ * @brief splitmix64, so the data and patterns can be compared between machines
+ */
+class Random
+{
+public:
+    explicit Random(quint64 seed) : state(seed) {}
+
+    quint64 next()
+    {
+        quint64 z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+private:
+    quint64 state;
+};
+
+struct PatternSet
+{
+    const char *name;
+    QVector<QByteArray> patterns;
+};
+
+/**
+ * @brief \a count patterns of 4 to 8 bytes, starting with one of \a startBytes different bytes
+ */
+PatternSet makePatternSet(const char *name, int count, int startBytes, quint64 seed)
+{
+    Random random(seed);
+    PatternSet set { name, {} };
+    for (int i = 0; i < count; i++) {
+        QByteArray pattern;
+        pattern.append(static_cast<char>(0x40 + i % startBytes));
+        int length = 4 + static_cast<int>(random.next() % 5);
+        while (pattern.size() < length) {
+            pattern.append(static_cast<char>(random.next()));
+        }
+        set.patterns.append(pattern);
+    }
+    return set;
+}
+
+std::vector<std::pair<int, size_t>> naiveHits(const QVector<QByteArray> &patterns,
+                                              const ut8 *data, size_t size)
+{
+    std::vector<std::pair<int, size_t>> hits;
+    for (size_t offset = 0; offset < size; offset++) {
+        for (int p = 0; p < patterns.size(); p++) {
+            const QByteArray &pattern = patterns[p];
+            size_t length = static_cast<size_t>(pattern.size());
+            if (offset + length <= size
+                && !std::memcmp(data + offset, pattern.constData(), length)) {
+                hits.emplace_back(p, offset);
+            }
+        }
+    }
+    std::sort(hits.begin(), hits.end());
+    return hits;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measure the scan throughput of the multi-pattern search");
+    parser.addHelpOption();
+    QCommandLineOption sizeOption({ "s", "size" }, "Size of the scanned data in MiB. Default: 256",
+                                  "MiB", "256");
+    parser.addOption(sizeOption);
+    QCommandLineOption repeatOption({ "r", "repeat" },
+                                    "Scan each set n times and report the fastest run", "n", "3");
+    parser.addOption(repeatOption);
+    parser.process(app);
+
+    const size_t size = std::max(1, parser.value(sizeOption).toInt()) * size_t(1024 * 1024);
+    const int repeat = std::max(1, parser.value(repeatOption).toInt());
+
+    std::vector<ut8> data(size);
+    Random random(1);
+    for (size_t i = 0; i < size; i += 8) {
+        quint64 value = random.next();
+        std::memcpy(data.data() + i, &value, std::min<size_t>(8, size - i));
+    }
+
+    const PatternSet sets[] = {
+        makePatternSet("single", 1, 1, 2),
+        makePatternSet("start-bytes-3", 16, 3, 3),
+        makePatternSet("start-bytes-16", 16, 16, 4),
+        makePatternSet("many-256", 256, 64, 5),
+    };
+
+    std::printf("%-16s %8s %11s %-9s %10s %9s %8s %s\n", "set", "patterns", "start bytes",
+                "prefilter", "hits", "ms", "GB/s", "status");
+    int failures = 0;
+    for (const PatternSet &set : sets) {
+        AhoCorasickMatcher matcher(set.patterns);
+        int startBytes = 0;
+        bool seen[256] = {};
+        for (const QByteArray &pattern : set.patterns) {
+            ut8 first = static_cast<ut8>(pattern[0]);
+            startBytes += seen[first] ? 0 : 1;
+            seen[first] = true;
+        }
+
+        quint64 hits = 0;
+        qint64 bestNs = 0;
+        for (int i = 0; i < repeat; i++) {
+            quint64 runHits = 0;
+            QElapsedTimer timer;
+            timer.start();
+            matcher.scan(data.data(), size, [&runHits](int, size_t) { runHits++; });
+            qint64 ns = timer.nsecsElapsed();
+            if (i == 0 || ns < bestNs) {
+                bestNs = ns;
+            }
+            hits = runHits;
+        }
+
+        const size_t verified = std::min(size, kVerifiedSize);
+        std::vector<std::pair<int, size_t>> found;
+        matcher.scan(data.data(), verified,
+                     [&found](int pattern, size_t offset) { found.emplace_back(pattern, offset); });
+        std::sort(found.begin(), found.end());
+        bool ok = found == naiveHits(set.patterns, data.data(), verified);
+        if (!ok) {
+            failures++;
+        }
+
+        std::printf("%-16s %8d %11d %-9s %10llu %9.2f %8.3f %s\n", set.name,
+                    static_cast<int>(set.patterns.size()), startBytes,
+                    static_cast<size_t>(startBytes) <= AhoCorasickMatcher::kMaxMemchrBytes
+                            ? "memchr"
+                            : "table",
+                    static_cast<unsigned long long>(hits), bestNs / 1e6,
+                    size / std::max<double>(1, bestNs), ok ? "ok" : "FAILED");
+        std::fflush(stdout);
+    }
+    return failures ? 1 : 0;
+}
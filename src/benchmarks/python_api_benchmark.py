@@ -0,0 +1,89 @@
+"""
+Compares the bulk data functions of the cutter module with the equivalent cmdj() calls.
+
+Copy or symlink this file into the python subdirectory of the plugins directory, open a binary
+and run the benchmark with Plugins -> Python API Benchmark. The results are printed to the console.
+"""
+
+import time
+
+import cutter
+
+from PySide2.QtWidgets import QAction
+
+REPEAT = 3
+READ_SIZE = 0x100000
+READ_CHUNK = 0x1000
+
+
+def best_time(function):
+    best = None
+    for _ in range(REPEAT):
+        start = time.perf_counter()
+        function()
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def read_json(addr):
+    for offset in range(addr, addr + READ_SIZE, READ_CHUNK):
+        bytes(cutter.cmdj("pxj {} @ {}".format(READ_CHUNK, offset)))
+
+
+def read_native(addr):
+    for offset in range(addr, addr + READ_SIZE, READ_CHUNK):
+        bytes(cutter.read(offset, READ_CHUNK))
+
+
+def blocks_json(functions):
+    for function in functions:
+        cutter.cmdj("afbj @ {}".format(function))
+
+
+def blocks_native(functions):
+    for function in functions:
+        cutter.basic_blocks(function)
+
+
+def run():
+    addr = cutter.core().getOffset()
+    functions = [f[0] for f in cutter.functions()]
+    commands = ["pi 1 @ {}".format(f) for f in functions]
+    cases = [
+        ("read 1 MiB", lambda: read_json(addr), lambda: read_native(addr)),
+        ("functions", lambda: cutter.cmdj("aflj"), cutter.functions),
+        ("basic blocks", lambda: blocks_json(functions), lambda: blocks_native(functions)),
+        ("xrefs", lambda: cutter.cmdj("axtj @ {}".format(addr)), lambda: cutter.xrefs(addr)),
+        ("strings", lambda: cutter.cmdj("izzj"), cutter.strings),
+        ("commands", lambda: [cutter.cmd(c) for c in commands],
+         lambda: cutter.cmd_batch(commands)),
+    ]
+    cutter.message("{:<14} {:>10} {:>10} {:>8}".format("case", "json ms", "native ms", "speedup"))
+    for name, json_path, native_path in cases:
+        json_time = best_time(json_path)
+        native_time = best_time(native_path)
+        cutter.message("{:<14} {:>10.2f} {:>10.2f} {:>7.1f}x".format(
+            name, json_time * 1000, native_time * 1000, json_time / max(native_time, 1e-9)))
+
+
+class PythonApiBenchmarkPlugin(cutter.CutterPlugin):
+    name = "Python API Benchmark"
+    description = "Compares the bulk data functions of the cutter module with cmdj()."
+    version = "1.0"
+    author = "Cutter developers"
+
+    def setupPlugin(self):
+        pass
+
+    def setupInterface(self, main):
+        action = QAction(self.name, main)
+        action.triggered.connect(run)
+        main.getMenuByType(cutter.MainWindow.MenuType.Plugins).addAction(action)
+
+    def terminate(self):
+        pass
+
+
+def create_cutter_plugin():
+    return PythonApiBenchmarkPlugin()
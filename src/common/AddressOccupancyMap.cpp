@@ -0,0 +1,219 @@
+#include "AddressOccupancyMap.h"
+#include "core/Cutter.h"
+
+#include <algorithm>
+#include <cstring>
+
+AddressOccupancyMap::AddressOccupancyMap()
+{
+    for (auto &tree : trees) {
+        tree.assign(2 * LeafCount, 0);
+    }
+}
+
+void AddressOccupancyMap::reset(RVA from, RVA to)
+{
+    this->from = from;
+    this->to = std::max(from, to);
+    RVA size = this->to - this->from;
+    leafSize = std::max<RVA>(1, size / LeafCount + (size % LeafCount ? 1 : 0));
+    for (auto &tree : trees) {
+        std::fill(tree.begin(), tree.end(), 0);
+    }
+    regions.clear();
+    if (this->to > this->from) {
+        regions.append({ this->from, size });
+    }
+    functionBlocks.clear();
+}
+
+void AddressOccupancyMap::clear(Category category)
+{
+    std::fill(trees[category].begin(), trees[category].end(), 0);
+    if (category == Functions || category == InFunctions) {
+        functionBlocks.clear();
+    }
+}
+
+int AddressOccupancyMap::leafIndex(RVA addr) const
+{
+    if (addr < from || addr >= to) {
+        return -1;
+    }
+    return static_cast<int>((addr - from) / leafSize);
+}
+
+void AddressOccupancyMap::addLeaf(Category category, int leaf, qint64 delta)
+{
+    std::vector<qint64> &tree = trees[category];
+    for (int i = leaf + LeafCount; i > 0; i >>= 1) {
+        tree[i] += delta;
+    }
+}
+
+void AddressOccupancyMap::add(Category category, RVA addr, int delta)
+{
+    int leaf = leafIndex(addr);
+    if (leaf >= 0) {
+        addLeaf(category, leaf, delta);
+    }
+}
+
+void AddressOccupancyMap::addRange(Category category, RVA addr, RVA size, int delta)
+{
+    if (size == 0 || addr >= to || addr + size <= from) {
+        return;
+    }
+    int first = leafIndex(std::max(addr, from));
+    int last = leafIndex(std::min(addr + size, to) - 1);
+    for (int leaf = first; leaf <= last; leaf++) {
+        addLeaf(category, leaf, delta);
+    }
+}
+
+void AddressOccupancyMap::addFlag(const FlagDescription &flag, int delta)
+{
+    add(Flags, flag.offset, delta);
+    if (flag.flagspace == QLatin1String(RZ_FLAGS_FS_STRINGS)) {
+        add(Strings, flag.offset, delta);
+    } else if (flag.flagspace == QLatin1String(RZ_FLAGS_FS_SYMBOLS)) {
+        add(Symbols, flag.offset, delta);
+    }
+}
+
+qint64 AddressOccupancyMap::count(Category category, RVA rangeFrom, RVA rangeTo) const
+{
+    rangeFrom = std::max(rangeFrom, from);
+    rangeTo = std::min(rangeTo, to);
+    if (rangeFrom >= rangeTo) {
+        return 0;
+    }
+
+    const std::vector<qint64> &tree = trees[category];
+    qint64 sum = 0;
+    // Half-open leaf range [l, r) summed bottom-up
+    int l = leafIndex(rangeFrom) + LeafCount;
+    int r = leafIndex(rangeTo - 1) + 1 + LeafCount;
+    while (l < r) {
+        if (l & 1) {
+            sum += tree[l++];
+        }
+        if (r & 1) {
+            sum += tree[--r];
+        }
+        l >>= 1;
+        r >>= 1;
+    }
+    return sum;
+}
+
+void AddressOccupancyMap::load()
+{
+    QList<QPair<RVA, RVA>> ranges;
+    for (const auto &range : Core()->getSearchBoundaries("bin.sections")) {
+        if (range.second) {
+            ranges.append({ range.first, range.second });
+        }
+    }
+    if (ranges.isEmpty()) {
+        reset(0, 0);
+        return;
+    }
+    std::sort(ranges.begin(), ranges.end());
+    QList<QPair<RVA, RVA>> merged;
+    for (const auto &range : ranges) {
+        if (!merged.isEmpty() && range.first <= merged.last().first + merged.last().second) {
+            RVA end = std::max(merged.last().first + merged.last().second,
+                               range.first + range.second);
+            merged.last().second = end - merged.last().first;
+        } else {
+            merged.append(range);
+        }
+    }
+    reset(merged.first().first, merged.last().first + merged.last().second);
+    regions = merged;
+    loadFunctions();
+    loadFlags();
+}
+
+void AddressOccupancyMap::loadFunctions()
+{
+    clear(Functions);
+    clear(InFunctions);
+    if (isEmpty()) {
+        return;
+    }
+
+    RzCoreLocked core = Core()->core();
+    RzListIter *fcnIter;
+    RzAnalysisFunction *fcn;
+    CutterRListForeach(core->analysis->fcns, fcnIter, RzAnalysisFunction, fcn)
+    {
+        addFunction(fcn);
+    }
+}
+
+void AddressOccupancyMap::addFunction(RzAnalysisFunction *fcn)
+{
+    add(Functions, fcn->addr);
+    QVector<QPair<RVA, RVA>> &blocks = functionBlocks[fcn->addr];
+    RzListIter *bbIter;
+    RzAnalysisBlock *bb;
+    CutterRListForeach(fcn->bbs, bbIter, RzAnalysisBlock, bb)
+    {
+        addRange(InFunctions, bb->addr, bb->size);
+        blocks.append({ bb->addr, bb->size });
+    }
+}
+
+void AddressOccupancyMap::updateFunction(RVA offset)
+{
+    removeFunction(offset);
+    if (isEmpty()) {
+        return;
+    }
+    RzCoreLocked core = Core()->core();
+    RzAnalysisFunction *fcn = rz_analysis_get_function_at(core->analysis, offset);
+    if (fcn) {
+        addFunction(fcn);
+    }
+}
+
+void AddressOccupancyMap::removeFunction(RVA offset)
+{
+    auto it = functionBlocks.find(offset);
+    if (it == functionBlocks.end()) {
+        return;
+    }
+    add(Functions, offset, -1);
+    for (const auto &block : *it) {
+        addRange(InFunctions, block.first, block.second, -1);
+    }
+    functionBlocks.erase(it);
+}
+
+void AddressOccupancyMap::loadFlags()
+{
+    clear(Flags);
+    clear(Strings);
+    clear(Symbols);
+    if (isEmpty()) {
+        return;
+    }
+
+    RzCoreLocked core = Core()->core();
+    rz_flag_foreach(
+            core->flags,
+            [](RzFlagItem *flag, void *user) {
+                auto map = static_cast<AddressOccupancyMap *>(user);
+                map->add(Flags, flag->offset);
+                const char *space = flag->space ? flag->space->name : nullptr;
+                if (space && !strcmp(space, RZ_FLAGS_FS_STRINGS)) {
+                    map->add(Strings, flag->offset);
+                } else if (space && !strcmp(space, RZ_FLAGS_FS_SYMBOLS)) {
+                    map->add(Symbols, flag->offset);
+                }
+                return true;
+            },
+            this);
+}
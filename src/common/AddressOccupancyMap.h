@@ -0,0 +1,109 @@
+#ifndef ADDRESSOCCUPANCYMAP_H
+#define ADDRESSOCCUPANCYMAP_H
+
+#include "core/CutterCommon.h"
+#include "core/CutterDescriptions.h"
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QVector>
+
+#include <array>
+#include <vector>
+
+/**
+ * @brief Per-category item counts over an address range, queryable at any resolution.
+ *
+ * The range is split into a fixed number of leaf buckets. For each category the buckets are
+ * stored in an implicit binary tree of partial sums, so counting the items inside an arbitrary
+ * address range and updating a single item both take O(log n). Views like VisualNavbar can
+ * paint at any width from it without querying the core again, and single categories can be
+ * refreshed on their own when only functions or flags changed.
+ */
+class CUTTER_EXPORT AddressOccupancyMap
+{
+public:
+    enum Category {
+        /** function entrypoints */
+        Functions,
+        /** basic blocks belonging to a function, counted per leaf bucket they overlap */
+        InFunctions,
+        Strings,
+        Symbols,
+        /** all flags, including strings and symbols */
+        Flags,
+        CategoryCount
+    };
+
+    static const int LeafCount = 1 << 14;
+
+    AddressOccupancyMap();
+
+    /**
+     * @brief Clear all categories and cover the address range [from, to)
+     */
+    void reset(RVA from, RVA to);
+    void clear(Category category);
+
+    RVA getFrom() const { return from; }
+    RVA getTo() const { return to; }
+    bool isEmpty() const { return to <= from; }
+    /**
+     * @brief The mapped regions as sorted, non-overlapping (address, size) pairs, the range
+     * between getFrom() and getTo() may have gaps
+     */
+    const QList<QPair<RVA, RVA>> &getRegions() const { return regions; }
+
+    void add(Category category, RVA addr, int delta = 1);
+    /**
+     * @brief Add \a delta to every leaf bucket overlapping [addr, addr + size)
+     */
+    void addRange(Category category, RVA addr, RVA size, int delta = 1);
+    /**
+     * @brief Add \a delta to the Flags category and to Strings or Symbols depending on the
+     * flagspace of \a flag
+     */
+    void addFlag(const FlagDescription &flag, int delta = 1);
+
+    /**
+     * @brief Number of items of \a category in [rangeFrom, rangeTo), at leaf bucket granularity
+     */
+    qint64 count(Category category, RVA rangeFrom, RVA rangeTo) const;
+
+    /**
+     * @brief Rebuild the whole map from the current sections, functions and flags
+     */
+    void load();
+    /**
+     * @brief Recount the Functions and InFunctions categories
+     */
+    void loadFunctions();
+    /**
+     * @brief Replace the counts of the function at \a offset with its current basic blocks, or
+     * only remove them if it doesn't exist anymore
+     */
+    void updateFunction(RVA offset);
+    void removeFunction(RVA offset);
+    /**
+     * @brief Recount the Flags, Strings and Symbols categories
+     */
+    void loadFlags();
+
+private:
+    RVA from = 0;
+    RVA to = 0;
+    RVA leafSize = 1;
+    std::array<std::vector<qint64>, CategoryCount> trees;
+    QList<QPair<RVA, RVA>> regions;
+    /**
+     * Basic blocks counted for every function, so they can be removed again when it changes
+     */
+    QHash<RVA, QVector<QPair<RVA, RVA>>> functionBlocks;
+
+    int leafIndex(RVA addr) const;
+    void addLeaf(Category category, int leaf, qint64 delta);
+    void addFunction(RzAnalysisFunction *fcn);
+};
+
+#endif // ADDRESSOCCUPANCYMAP_H
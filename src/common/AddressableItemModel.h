@@ -5,6 +5,7 @@
 #include <QAbstractItemModel>
 #include <QSortFilterProxyModel>
 #include <QAbstractItemModel>
+#include <QList>
 
 #include "core/CutterCommon.h"
 
@@ -35,6 +36,75 @@ public:
     explicit AddressableItemModel(QObject *parent = nullptr) : ParentModel(parent) {}
     virtual ~AddressableItemModel() {}
     QAbstractItemModel *asItemModel() { return this; }
+
+    /**
+     * @brief Insert \a item into the top level \a list backing this model at \a row and notify
+     * views about the single new row.
+     */
+    template<class T>
+    void insertListRow(QList<T> &list, int row, const T &item)
+    {
+        this->beginInsertRows(QModelIndex(), row, row);
+        list.insert(row, item);
+        this->endInsertRows();
+    }
+
+    /**
+     * @brief Remove \a row from the top level \a list backing this model
+     */
+    template<class T>
+    void removeListRow(QList<T> &list, int row)
+    {
+        this->beginRemoveRows(QModelIndex(), row, row);
+        list.removeAt(row);
+        this->endRemoveRows();
+    }
+
+    /**
+     * @brief Remove \a row from the top level \a list by moving the last row into its place.
+     *
+     * For models that are only shown sorted. Only the last row changes its index, so an index of
+     * rows kept next to \a list stays valid without renumbering.
+     * @return the previous index of the row now at \a row, or -1 if no row was moved
+     */
+    template<class T>
+    int removeListRowUnordered(QList<T> &list, int row)
+    {
+        int last = list.size() - 1;
+        if (row == last) {
+            removeListRow(list, row);
+            return -1;
+        }
+        list[row] = list[last];
+        emitRowChanged(row);
+        removeListRow(list, last);
+        return last;
+    }
+
+    /**
+     * @brief Replace \a row of the top level \a list backing this model with \a item and emit
+     * dataChanged for that row and its children.
+     */
+    template<class T>
+    void updateListRow(QList<T> &list, int row, const T &item)
+    {
+        list[row] = item;
+        emitRowChanged(row);
+    }
+
+    /**
+     * @brief Emit dataChanged for all columns of the top level \a row and its direct children
+     */
+    void emitRowChanged(int row)
+    {
+        QModelIndex first = this->index(row, 0);
+        emit this->dataChanged(first, this->index(row, this->columnCount() - 1));
+        if (this->hasChildren(first)) {
+            int children = this->rowCount(first);
+            emit this->dataChanged(this->index(0, 0, first),
+                                   this->index(children - 1, this->columnCount(first) - 1, first));
+        }
+    }
 };
 
 class CUTTER_EXPORT AddressableFilterProxyModel : public AddressableItemModel<QSortFilterProxyModel>
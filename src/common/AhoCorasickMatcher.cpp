@@ -0,0 +1,63 @@
+#include "AhoCorasickMatcher.h"
+
+#include <queue>
+
+AhoCorasickMatcher::AhoCorasickMatcher(const QVector<QByteArray> &patterns)
+{
+    std::fill(std::begin(firstByte), std::end(firstByte), false);
+
+    // Build the trie, -1 marks missing edges
+    transitions.assign(256, -1);
+    outputs.emplace_back();
+    for (int p = 0; p < patterns.size(); p++) {
+        const QByteArray &pattern = patterns[p];
+        patternLengths.push_back(pattern.size());
+        if (pattern.isEmpty()) {
+            continue;
+        }
+        maxPatternLength = std::max(maxPatternLength, static_cast<int>(pattern.size()));
+        if (!firstByte[static_cast<ut8>(pattern[0])]) {
+            firstByte[static_cast<ut8>(pattern[0])] = true;
+            startBytes.push_back(static_cast<ut8>(pattern[0]));
+        }
+        int state = 0;
+        for (char c : pattern) {
+            size_t edge = static_cast<size_t>(state) * 256 + static_cast<ut8>(c);
+            if (transitions[edge] < 0) {
+                transitions[edge] = static_cast<int>(outputs.size());
+                transitions.resize(transitions.size() + 256, -1);
+                outputs.emplace_back();
+            }
+            state = transitions[edge];
+        }
+        outputs[state].push_back(p);
+    }
+
+    // Compute failure links breadth first and turn the trie into a dense DFA
+    std::vector<int> fail(outputs.size(), 0);
+    std::queue<int> queue;
+    for (int c = 0; c < 256; c++) {
+        int &next = transitions[c];
+        if (next < 0) {
+            next = 0;
+        } else {
+            queue.push(next);
+        }
+    }
+    while (!queue.empty()) {
+        int state = queue.front();
+        queue.pop();
+        const std::vector<int> &inherited = outputs[fail[state]];
+        outputs[state].insert(outputs[state].end(), inherited.begin(), inherited.end());
+        for (int c = 0; c < 256; c++) {
+            size_t edge = static_cast<size_t>(state) * 256 + c;
+            int fallback = transitions[static_cast<size_t>(fail[state]) * 256 + c];
+            if (transitions[edge] < 0) {
+                transitions[edge] = fallback;
+            } else {
+                fail[transitions[edge]] = fallback;
+                queue.push(transitions[edge]);
+            }
+        }
+    }
+}
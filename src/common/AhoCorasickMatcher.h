@@ -0,0 +1,89 @@
+#ifndef AHOCORASICKMATCHER_H
+#define AHOCORASICKMATCHER_H
+
+#include "core/CutterCommon.h"
+
+#include <QByteArray>
+#include <QVector>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+/**
+ * @brief Aho-Corasick automaton matching many byte patterns in a single pass.
+ *
+ * The automaton is stored as a dense transition table with 256 entries per state, so scanning
+ * costs one table lookup per byte regardless of the number of patterns. While the automaton
+ * is in its root state, bytes which can't start any pattern are skipped by a prefilter. If the
+ * patterns start with at most kMaxMemchrBytes distinct bytes it searches for them with memchr,
+ * which the C library vectorizes, otherwise it is a tight loop over a byte table.
+ */
+class CUTTER_EXPORT AhoCorasickMatcher
+{
+public:
+    static const size_t kMaxMemchrBytes = 3;
+
+    explicit AhoCorasickMatcher(const QVector<QByteArray> &patterns);
+
+    int getMaxPatternLength() const { return maxPatternLength; }
+
+    /**
+     * @brief Scan \a size bytes of \a data and call \a onMatch(patternIndex, matchOffset) for
+     * every occurrence of every pattern. Offsets are relative to \a data.
+     */
+    template<typename F>
+    void scan(const ut8 *data, size_t size, F onMatch) const
+    {
+        // Next occurrence of each start byte, nullptr once there is none left
+        const ut8 *next[kMaxMemchrBytes];
+        const bool useMemchr = startBytes.size() <= kMaxMemchrBytes;
+        const size_t memchrBytes = useMemchr ? startBytes.size() : 0;
+        for (size_t b = 0; b < memchrBytes; b++) {
+            next[b] = static_cast<const ut8 *>(std::memchr(data, startBytes[b], size));
+        }
+
+        int state = 0;
+        size_t i = 0;
+        while (i < size) {
+            if (state == 0) {
+                if (useMemchr) {
+                    size_t candidate = size;
+                    for (size_t b = 0; b < memchrBytes; b++) {
+                        if (next[b] && next[b] < data + i) {
+                            next[b] = static_cast<const ut8 *>(
+                                    std::memchr(data + i, startBytes[b], size - i));
+                        }
+                        if (next[b]) {
+                            candidate = std::min(candidate, static_cast<size_t>(next[b] - data));
+                        }
+                    }
+                    i = candidate;
+                } else {
+                    while (i < size && !firstByte[data[i]]) {
+                        i++;
+                    }
+                }
+                if (i == size) {
+                    break;
+                }
+            }
+            state = transitions[static_cast<size_t>(state) * 256 + data[i]];
+            for (int p : outputs[state]) {
+                onMatch(p, i + 1 - static_cast<size_t>(patternLengths[p]));
+            }
+            i++;
+        }
+    }
+
+private:
+    std::vector<int> transitions;
+    std::vector<std::vector<int>> outputs;
+    std::vector<int> patternLengths;
+    bool firstByte[256];
+    std::vector<ut8> startBytes;
+    int maxPatternLength = 0;
+};
+
+#endif // AHOCORASICKMATCHER_H
@@ -1,12 +1,17 @@
 #include "core/Cutter.h"
 #include "common/AnalTask.h"
+#include "common/AnalysisCache.h"
+#include "common/Configuration.h"
 #include "core/MainWindow.h"
 #include "dialogs/InitialOptionsDialog.h"
 #include <QJsonArray>
 #include <QDebug>
 #include <QCheckBox>
 
-AnalTask::AnalTask() : AsyncTask() {}
+AnalTask::AnalTask()
+    : AsyncTask(), analysisCacheLimit(qint64(Config()->getAnalysisCacheSizeLimit()) * 1024 * 1024)
+{
+}
 
 AnalTask::~AnalTask() {}
 
@@ -14,6 +19,34 @@ void AnalTask::interrupt()
 {
     AsyncTask::interrupt();
     rz_cons_singleton()->context->breaked = true;
+    resume();
+}
+
+void AnalTask::resume()
+{
+    QMutexLocker locker(&pauseMutex);
+    paused = false;
+    pauseCondition.wakeAll();
+}
+
+void AnalTask::publishIntermediateResults(int step, int stepCount)
+{
+    if (publishInterval <= 0
+        || (publishTimer.isValid() && publishTimer.elapsed() < publishInterval)) {
+        return;
+    }
+
+    log(tr("Publishing intermediate results..."));
+    QMutexLocker locker(&pauseMutex);
+    paused = true;
+    resultsPublished = true;
+    emit intermediateResultsAvailable(step, stepCount);
+    // interrupt() resumes as well
+    while (paused && !isInterrupted()) {
+        pauseCondition.wait(&pauseMutex);
+    }
+    paused = false;
+    publishTimer.start();
 }
 
 QString AnalTask::getTitle()
@@ -26,6 +59,14 @@ QString AnalTask::getTitle()
     return tr("Analyzing Program");
 }
 
+void AnalTask::endPhase(StartupProfiler::Phase &phase)
+{
+    double ms = phase.end();
+    if (StartupProfiler::instance()->isEnabled()) {
+        log(tr("Done in %1 ms").arg(ms, 0, 'f', 1));
+    }
+}
+
 void AnalTask::runTask()
 {
     int perms = RZ_PERM_RX;
@@ -38,13 +79,21 @@ void AnalTask::runTask()
     Core()->setConfig("bin.demangle", options.demangle);
 
     // Do not reload the file if already loaded
+    QString cacheKey;
     QJsonArray openedFiles = Core()->getOpenedFiles();
     if (!openedFiles.size() && options.filename.length()) {
+        if (options.useAnalysisCache) {
+            log(tr("Hashing the file..."));
+            cacheKey = AnalysisCache::key(options);
+        }
+
         log(tr("Loading the file..."));
         openFailed = false;
+        StartupProfiler::Phase phase("fileOpen", "loadFile");
         bool fileLoaded =
                 Core()->loadFile(options.filename, options.binLoadAddr, options.mapAddr, perms,
                                  options.useVA, options.loadBinInfo, options.forceBinPlugin);
+        endPhase(phase);
         if (!fileLoaded) {
             // Something wrong happened, fallback to open dialog
             openFailed = true;
@@ -55,7 +104,10 @@ void AnalTask::runTask()
     }
 
     // rz_core_bin_load might change asm.bits, so let's set that after the bin is loaded
-    Core()->setCPU(options.arch, options.cpu, options.bits);
+    {
+        StartupProfiler::Phase phase("fileOpen", "setCPU");
+        Core()->setCPU(options.arch, options.cpu, options.bits);
+    }
 
     if (isInterrupted()) {
         return;
@@ -67,7 +119,9 @@ void AnalTask::runTask()
 
     if (!options.pdbFile.isNull()) {
         log(tr("Loading PDB file..."));
+        StartupProfiler::Phase phase("fileOpen", "loadPDB");
         Core()->loadPDB(options.pdbFile);
+        endPhase(phase);
     }
 
     if (isInterrupted()) {
@@ -87,24 +141,49 @@ void AnalTask::runTask()
 
     if (!options.script.isNull()) {
         log(tr("Executing script..."));
+        StartupProfiler::Phase phase("fileOpen", "loadScript");
         Core()->loadScript(options.script);
+        endPhase(phase);
     }
 
     if (isInterrupted()) {
         return;
     }
 
+    if (!cacheKey.isEmpty()) {
+        StartupProfiler::Phase phase("analysis", "AnalysisCache::restore");
+        if (AnalysisCache::restore(cacheKey)) {
+            log(tr("Restored analysis from cache."));
+            endPhase(phase);
+            return;
+        }
+    }
+
     if (!options.analCmd.empty()) {
         log(tr("Executing analysis..."));
-        for (const CommandDescription &cmd : options.analCmd) {
+        const int stepCount = options.analCmd.size();
+        for (int step = 0; step < stepCount; step++) {
+            if (step > 0) {
+                publishIntermediateResults(step, stepCount);
+            }
             if (isInterrupted()) {
                 return;
             }
+            const CommandDescription &cmd = options.analCmd[step];
             log(cmd.description);
+            StartupProfiler::Phase phase("analysis", cmd.command);
             // use cmd instead of cmdRaw because commands can be unexpected
             Core()->cmd(cmd.command);
+            endPhase(phase);
         }
         log(tr("Analysis complete!"));
+
+        if (!cacheKey.isEmpty() && !isInterrupted()) {
+            log(tr("Storing analysis in cache..."));
+            if (!AnalysisCache::store(cacheKey, analysisCacheLimit)) {
+                log(tr("Failed to store analysis in cache."));
+            }
+        }
     } else {
         log(tr("Skipping Analysis."));
     }
@@ -4,6 +4,9 @@
 #include "common/AsyncTask.h"
 #include "core/Cutter.h"
 #include "common/InitialOptions.h"
+#include "common/StartupProfiler.h"
+
+#include <QWaitCondition>
 
 class CutterCore;
 class MainWindow;
@@ -25,16 +28,50 @@ public:
 
     bool getOpenFileFailed() { return openFailed; }
 
+    /**
+     * @brief Pause at safe points between analysis steps so the UI can show the results so far
+     * @param msec minimum time between two publications, 0 disables them
+     */
+    void setPublishInterval(int msec) { publishInterval = msec; }
+    bool getResultsPublished() { return resultsPublished; }
+
+    /**
+     * @brief Continue the analysis after intermediateResultsAvailable
+     */
+    void resume();
+
 protected:
     void runTask() override;
 
 signals:
     void openFileFailed();
+    /**
+     * @brief Emitted from the task thread after \a step of \a stepCount analysis steps
+     *
+     * The analysis is paused until resume() is called, so receivers can read the core without
+     * waiting for the next step to finish.
+     */
+    void intermediateResultsAvailable(int step, int stepCount);
 
 private:
     InitialOptions options;
 
+    /**
+     * @brief End \a phase and log its duration when startup profiling is enabled
+     */
+    void endPhase(StartupProfiler::Phase &phase);
+
     bool openFailed = false;
+    qint64 analysisCacheLimit;
+
+    int publishInterval = 0;
+    bool resultsPublished = false;
+    QElapsedTimer publishTimer;
+    QMutex pauseMutex;
+    QWaitCondition pauseCondition;
+    bool paused = false;
+
+    void publishIntermediateResults(int step, int stepCount);
 };
 
 #endif // ANALTHREAD_H
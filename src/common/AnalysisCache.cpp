@@ -0,0 +1,193 @@
+#include "AnalysisCache.h"
+#include "core/Cutter.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+/**
+ * @brief The analysis.* eval options as sorted "name=value" pairs, they change what the analysis
+ * finds just as much as the analysis commands do
+ */
+static QStringList analysisConfig()
+{
+    QStringList result;
+    RzCoreLocked core(Core());
+    RzListIter *it;
+    RzConfigNode *node;
+    CutterRListForeach(core->config->nodes, it, RzConfigNode, node)
+    {
+        if (rz_str_startswith(node->name, "analysis.")) {
+            result << QString::fromUtf8(node->name) + "=" + QString::fromUtf8(node->value);
+        }
+    }
+    result.sort();
+    return result;
+}
+
+QString AnalysisCache::key(const InitialOptions &options)
+{
+    // Scripts and shellcode may change anything before the analysis runs
+    if (options.analCmd.isEmpty() || !options.script.isEmpty() || !options.shellcode.isEmpty()) {
+        return QString();
+    }
+
+    QFile file(options.filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    QCryptographicHash fileHash(QCryptographicHash::Sha256);
+    if (!fileHash.addData(&file)) {
+        return QString();
+    }
+
+    QStringList fingerprint = { QString::fromLatin1(fileHash.result().toHex()),
+                                QString::fromUtf8(rz_core_version()),
+                                options.arch,
+                                options.cpu,
+                                QString::number(options.bits),
+                                options.os,
+                                QString::number(static_cast<int>(options.endian)),
+                                QString::number(options.useVA),
+                                QString::number(options.binLoadAddr),
+                                QString::number(options.mapAddr),
+                                QString::number(options.writeEnabled),
+                                QString::number(options.loadBinInfo),
+                                options.forceBinPlugin,
+                                QString::number(options.demangle),
+                                options.pdbFile };
+    for (const CommandDescription &cmd : options.analCmd) {
+        fingerprint << cmd.command;
+    }
+    fingerprint << analysisConfig();
+    return QString::fromLatin1(
+            QCryptographicHash::hash(fingerprint.join('\n').toUtf8(), QCryptographicHash::Sha256)
+                    .toHex());
+}
+
+QString AnalysisCache::getCacheDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/analysis";
+}
+
+QString AnalysisCache::entryPath(const QString &key)
+{
+    return getCacheDir() + "/" + key + ".rzdb";
+}
+
+bool AnalysisCache::restore(const QString &key)
+{
+    QString path = entryPath(key);
+    if (!QFileInfo::exists(path)) {
+        return false;
+    }
+
+    QByteArray pathUtf8 = path.toUtf8();
+    // Parsing alone doesn't touch the core yet
+    RzProject *prj = rz_project_load_file_raw(pathUtf8.constData());
+    RzProjectErr err = prj ? RZ_PROJECT_ERR_SUCCESS : RZ_PROJECT_ERR_FILE;
+    if (prj) {
+        RzCoreLocked core(Core());
+        // A load that fails halfway leaves the core partially restored, so keep the state of the
+        // freshly opened file to go back to before the analysis runs on it
+        RzProject *clean = sdb_new0();
+        if (!clean
+            || rz_project_save(core, clean, pathUtf8.constData()) != RZ_PROJECT_ERR_SUCCESS) {
+            rz_project_free(clean);
+            rz_project_free(prj);
+            return false;
+        }
+        RzList *res = rz_list_new();
+        // The file is already opened with the same options, only load the analysis
+        err = rz_project_load(core, prj, false, pathUtf8.constData(), res);
+        rz_list_free(res);
+        if (err != RZ_PROJECT_ERR_SUCCESS) {
+            res = rz_list_new();
+            RzProjectErr cleanErr = rz_project_load(core, clean, false, pathUtf8.constData(), res);
+            rz_list_free(res);
+            if (cleanErr != RZ_PROJECT_ERR_SUCCESS) {
+                qWarning() << "Failed to undo partially restored analysis"
+                           << rz_project_err_message(cleanErr);
+            }
+        }
+        rz_project_free(clean);
+        rz_project_free(prj);
+        // Saving the project must not write into the cache
+        rz_config_set(core->config, "prj.file", "");
+    }
+    if (err != RZ_PROJECT_ERR_SUCCESS) {
+        qWarning() << "Discarding analysis cache entry" << path << rz_project_err_message(err);
+        QFile::remove(path);
+        return false;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    // Mark the entry as recently used for eviction
+    QFile entry(path);
+    if (entry.open(QIODevice::ReadWrite)) {
+        entry.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+#endif
+    return true;
+}
+
+bool AnalysisCache::store(const QString &key, qint64 maxBytes)
+{
+    if (!QDir().mkpath(getCacheDir())) {
+        return false;
+    }
+
+    QString path = entryPath(key);
+    QString tempPath = path + ".tmp";
+    RzProjectErr err;
+    {
+        RzCoreLocked core(Core());
+        QByteArray projectFile = rz_config_get(core->config, "prj.file");
+        err = rz_project_save_file(core, tempPath.toUtf8().constData());
+        rz_config_set(core->config, "prj.file", projectFile.constData());
+    }
+    if (err != RZ_PROJECT_ERR_SUCCESS) {
+        qWarning() << "Failed to store analysis cache entry" << rz_project_err_message(err);
+        QFile::remove(tempPath);
+        return false;
+    }
+
+    QFile::remove(path);
+    if (!QFile::rename(tempPath, path)) {
+        QFile::remove(tempPath);
+        return false;
+    }
+    evict(maxBytes);
+    return true;
+}
+
+void AnalysisCache::evict(qint64 maxBytes)
+{
+    QDir dir(getCacheDir());
+    // Left behind by interrupted stores. Recent ones may still be written by another instance.
+    const QDateTime staleBefore = QDateTime::currentDateTime().addSecs(-60 * 60);
+    for (const QFileInfo &temp : dir.entryInfoList({ "*.rzdb.tmp" }, QDir::Files)) {
+        if (temp.lastModified() < staleBefore) {
+            QFile::remove(temp.absoluteFilePath());
+        }
+    }
+    // Least recently used first
+    QFileInfoList entries =
+            dir.entryInfoList({ "*.rzdb" }, QDir::Files, QDir::Time | QDir::Reversed);
+    qint64 total = 0;
+    for (const QFileInfo &entry : entries) {
+        total += entry.size();
+    }
+    for (const QFileInfo &entry : entries) {
+        if (total <= maxBytes) {
+            break;
+        }
+        if (QFile::remove(entry.absoluteFilePath())) {
+            total -= entry.size();
+        }
+    }
+}
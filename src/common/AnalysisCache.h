@@ -0,0 +1,48 @@
+#ifndef ANALYSISCACHE_H
+#define ANALYSISCACHE_H
+
+#include "core/CutterCommon.h"
+#include "common/InitialOptions.h"
+
+#include <QString>
+
+/**
+ * @brief On-disk cache of analysis results, stored as rizin projects.
+ *
+ * An entry is keyed by the content hash of the binary, the options it was opened and analyzed
+ * with, the analysis.* eval options and the rizin version, so reopening an identical file with
+ * identical options can load the previous analysis instead of running it again. The cache is
+ * bounded in size, the least recently used entries are evicted first.
+ */
+class CUTTER_EXPORT AnalysisCache
+{
+public:
+    /**
+     * @brief Compute the key for analyzing \a options.filename with \a options
+     * @return empty string if the file can't be read or the options can't be cached
+     */
+    static QString key(const InitialOptions &options);
+
+    /**
+     * @brief Load the cached analysis for \a key into the already opened file
+     *
+     * If loading the entry fails, the state the file had before is restored so it can be analyzed
+     * from scratch.
+     * @return false if there is no usable entry
+     */
+    static bool restore(const QString &key);
+
+    /**
+     * @brief Save the analysis of the opened file under \a key and evict old entries until the
+     * cache is at most \a maxBytes large
+     */
+    static bool store(const QString &key, qint64 maxBytes);
+
+    static QString getCacheDir();
+
+private:
+    static QString entryPath(const QString &key);
+    static void evict(qint64 maxBytes);
+};
+
+#endif // ANALYSISCACHE_H
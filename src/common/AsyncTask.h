@@ -73,6 +73,7 @@ public:
 
     void start(AsyncTask::Ptr task);
     bool getTasksRunning();
+    const QList<AsyncTask::Ptr> &getTasks() { return tasks; }
 
 signals:
     void tasksChanged();
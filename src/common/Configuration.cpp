@@ -142,6 +142,7 @@ Configuration::Configuration() : QObject(), nativePalette(qApp->palette())
 #ifdef CUTTER_ENABLE_KSYNTAXHIGHLIGHTING
     kSyntaxHighlightingRepository = nullptr;
 #endif
+    loadCachedSettings();
 }
 
 Configuration *Configuration::instance()
@@ -151,6 +152,17 @@ Configuration *Configuration::instance()
     return mPtr;
 }
 
+void Configuration::loadCachedSettings()
+{
+    baseFont = s.value("font", QFont("Inconsolata", 11)).value<QFont>();
+    zoomFactor = qMax(s.value("zoomFactor", 1.0).value<qreal>(), 0.1);
+    graphBlockMaxChars = s.value("graph.maxcols", 100).toInt();
+    graphMinFontSize = s.value("graph.minfontsize", 4).toInt();
+    graphBlockEntryOffset = s.value("graphBlockEntryOffset", true).value<bool>();
+    QMutexLocker locker(&colorMutex);
+    colorValuesDirty = true;
+}
+
 void Configuration::loadInitial()
 {
     setInterfaceTheme(getInterfaceTheme());
@@ -200,6 +212,7 @@ void Configuration::resetAll()
     QFile settingsFile(s.fileName());
     settingsFile.remove();
     s.clear();
+    loadCachedSettings();
 
     loadInitial();
     emit fontsUpdated();
@@ -363,8 +376,7 @@ void Configuration::loadMidnightStylesheet()
 
 const QFont Configuration::getBaseFont() const
 {
-    QFont font = s.value("font", QFont("Inconsolata", 11)).value<QFont>();
-    return font;
+    return baseFont;
 }
 
 const QFont Configuration::getFont() const
@@ -377,6 +389,7 @@ const QFont Configuration::getFont() const
 void Configuration::setFont(const QFont &font)
 {
     s.setValue("font", font);
+    baseFont = font;
     emit fontsUpdated();
 }
 
@@ -387,13 +400,13 @@ void Configuration::refreshFont()
 
 qreal Configuration::getZoomFactor() const
 {
-    qreal fontZoom = s.value("zoomFactor", 1.0).value<qreal>();
-    return qMax(fontZoom, 0.1);
+    return zoomFactor;
 }
 
 void Configuration::setZoomFactor(qreal zoom)
 {
-    s.setValue("zoomFactor", qMax(zoom, 0.1));
+    zoomFactor = qMax(zoom, 0.1);
+    s.setValue("zoomFactor", zoomFactor);
     emit fontsUpdated();
 }
 
@@ -492,6 +505,8 @@ QString Configuration::getLogoFile()
 void Configuration::setColor(const QString &name, const QColor &color)
 {
     s.setValue("colors." + name, color);
+    QMutexLocker locker(&colorMutex);
+    colorValuesDirty = true;
 }
 
 void Configuration::setLastThemeOf(const CutterInterfaceTheme &currInterfaceTheme,
@@ -500,7 +515,7 @@ void Configuration::setLastThemeOf(const CutterInterfaceTheme &currInterfaceThem
     s.setValue("lastThemeOf." + currInterfaceTheme.name, theme);
 }
 
-const QColor Configuration::getColor(const QString &name) const
+QColor Configuration::readColor(const QString &name) const
 {
     if (s.contains("colors." + name)) {
         return s.value("colors." + name).value<QColor>();
@@ -509,6 +524,38 @@ const QColor Configuration::getColor(const QString &name) const
     }
 }
 
+const QColor Configuration::getColor(const QString &name) const
+{
+    return getColor(colorId(name));
+}
+
+int Configuration::colorId(const QString &name) const
+{
+    QMutexLocker locker(&colorMutex);
+    auto it = colorIds.constFind(name);
+    if (it != colorIds.constEnd()) {
+        return it.value();
+    }
+    int id = colorValues.size();
+    colorIds.insert(name, id);
+    colorValues.append(readColor(name));
+    return id;
+}
+
+QColor Configuration::getColor(int id) const
+{
+    // Returned by value, colorId() may reallocate colorValues
+    QMutexLocker locker(&colorMutex);
+    if (colorValuesDirty) {
+        // Changing the theme sets all colors one by one, read them once it is done
+        for (auto it = colorIds.constBegin(); it != colorIds.constEnd(); ++it) {
+            colorValues[it.value()] = readColor(it.key());
+        }
+        colorValuesDirty = false;
+    }
+    return colorValues[id];
+}
+
 void Configuration::setColorTheme(const QString &theme)
 {
     if (theme == "default") {
@@ -761,12 +808,13 @@ bool Configuration::getOutputRedirectionEnabled() const
 
 bool Configuration::getGraphBlockEntryOffset()
 {
-    return s.value("graphBlockEntryOffset", true).value<bool>();
+    return graphBlockEntryOffset;
 }
 
 void Configuration::setGraphBlockEntryOffset(bool enabled)
 {
     s.setValue("graphBlockEntryOffset", enabled);
+    graphBlockEntryOffset = enabled;
 }
 
 QStringList Configuration::getRecentFiles() const
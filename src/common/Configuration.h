@@ -3,6 +3,9 @@
 
 #include <QSettings>
 #include <QFont>
+#include <QHash>
+#include <QMutex>
+#include <QVector>
 #include <core/Cutter.h>
 
 #define Config() (Configuration::instance())
@@ -42,6 +45,25 @@ private:
 #endif
     bool outputRedirectEnabled = true;
 
+    /**
+     * @brief Colors resolved from the settings, indexed by the ids returned by colorId(). They are
+     * read again from the settings only after a color was changed. Guarded by colorMutex because
+     * ConfigColor is also used off the GUI thread.
+     */
+    mutable QMutex colorMutex;
+    mutable QHash<QString, int> colorIds;
+    mutable QVector<QColor> colorValues;
+    mutable bool colorValuesDirty = false;
+    QColor readColor(const QString &name) const;
+
+    // Settings read while drawing, kept in sync by their setters
+    QFont baseFont;
+    qreal zoomFactor = 1.0;
+    int graphBlockMaxChars = 100;
+    int graphMinFontSize = 4;
+    bool graphBlockEntryOffset = true;
+    void loadCachedSettings();
+
     Configuration();
     // Colors
     void loadBaseThemeNative();
@@ -132,6 +154,12 @@ public:
 
     void setColor(const QString &name, const QColor &color);
     const QColor getColor(const QString &name) const;
+    /**
+     * @brief Get an id for the color \a name which stays valid for the whole session. Reading a
+     * color by id is an array access, use it for colors read for every line or block.
+     */
+    int colorId(const QString &name) const;
+    QColor getColor(int id) const;
 
     /**
      * @brief Get the value of a config var either from Rizin or settings, depending on the key.
@@ -160,12 +188,20 @@ public:
     bool isDecompilerAnnotationHighlighterEnabled();
 
     // Graph
-    int getGraphBlockMaxChars() const { return s.value("graph.maxcols", 100).toInt(); }
-    void setGraphBlockMaxChars(int ch) { s.setValue("graph.maxcols", ch); }
+    int getGraphBlockMaxChars() const { return graphBlockMaxChars; }
+    void setGraphBlockMaxChars(int ch)
+    {
+        s.setValue("graph.maxcols", ch);
+        graphBlockMaxChars = ch;
+    }
 
-    int getGraphMinFontSize() const { return s.value("graph.minfontsize", 4).toInt(); }
+    int getGraphMinFontSize() const { return graphMinFontSize; }
 
-    void setGraphMinFontSize(int sz) { s.setValue("graph.minfontsize", sz); }
+    void setGraphMinFontSize(int sz)
+    {
+        s.setValue("graph.minfontsize", sz);
+        graphMinFontSize = sz;
+    }
 
     /**
      * @brief Getters and setters for the transaparent option state and scale factor for bitmap
@@ -201,6 +237,55 @@ public:
     void setOutputRedirectionEnabled(bool enabled);
     bool getOutputRedirectionEnabled() const;
 
+    /**
+     * @brief Maximum number of lines kept in the console output, older lines are discarded.
+     */
+    int getConsoleScrollback() const { return s.value("console.scrollback", 10000).toInt(); }
+    void setConsoleScrollback(int lines) { s.setValue("console.scrollback", lines); }
+
+    /**
+     * @brief Minimum time in milliseconds between two refreshes of the UI with intermediate
+     * results while analysis steps run, 0 to only refresh once analysis is done.
+     */
+    int getAnalysisPublishInterval() const
+    {
+        return s.value("analysis.publishInterval", 5000).toInt();
+    }
+    void setAnalysisPublishInterval(int msec) { s.setValue("analysis.publishInterval", msec); }
+
+    /**
+     * @brief Whether InitialOptionsDialog offers to reuse cached analysis results by default
+     */
+    bool getAnalysisCacheEnabled() const { return s.value("analysis.cache", false).toBool(); }
+    void setAnalysisCacheEnabled(bool enabled) { s.setValue("analysis.cache", enabled); }
+    /**
+     * @brief Maximum size of the analysis cache in MiB
+     */
+    int getAnalysisCacheSizeLimit() const { return s.value("analysis.cacheSize", 2048).toInt(); }
+    void setAnalysisCacheSizeLimit(int mib) { s.setValue("analysis.cacheSize", mib); }
+
+    /**
+     * @brief Interval in minutes for saving the opened project in the background, 0 to disable.
+     * Only takes effect once the project was saved to a file.
+     */
+    int getProjectAutosaveInterval() const { return s.value("project.autosave", 0).toInt(); }
+    void setProjectAutosaveInterval(int minutes)
+    {
+        s.setValue("project.autosave", minutes);
+        emit projectAutosaveIntervalChanged();
+    }
+
+    /**
+     * @brief Whether VisualNavbar and the address maps of SectionsWidget color the file by
+     * entropy and byte classes instead of by contents
+     */
+    bool getEntropyHeatMapEnabled() const { return s.value("gui.entropyHeatMap", false).toBool(); }
+    void setEntropyHeatMapEnabled(bool enabled)
+    {
+        s.setValue("gui.entropyHeatMap", enabled);
+        emit entropyHeatMapChanged();
+    }
+
     /**
      * @brief Recently opened binaries, as shown in NewFileDialog.
      */
@@ -220,6 +305,8 @@ signals:
     void fontsUpdated();
     void colorsUpdated();
     void interfaceThemeChanged();
+    void entropyHeatMapChanged();
+    void projectAutosaveIntervalChanged();
 #ifdef CUTTER_ENABLE_KSYNTAXHIGHLIGHTING
     void kSyntaxHighlightingThemeChanged();
 #endif
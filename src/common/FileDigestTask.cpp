@@ -0,0 +1,442 @@
+#include "FileDigestTask.h"
+#include "core/Cutter.h"
+
+#include <QCache>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace {
+
+static const qint64 kChunkSize = 64 * 1024 * 1024;
+static const ut64 kMinBlockSize = 4096;
+static const ut64 kMaxBlocks = 4096;
+// Number of digests kept in the cache
+static const int kCachedDigests = 8;
+
+using Histogram = std::array<quint64, 256>;
+
+class DigestLane : public QRunnable
+{
+public:
+    explicit DigestLane(std::function<void()> work) : work(std::move(work)) {}
+    void run() override { work(); }
+
+private:
+    std::function<void()> work;
+};
+
+struct Crc32Table
+{
+    quint32 entries[256];
+
+    Crc32Table()
+    {
+        for (quint32 i = 0; i < 256; i++) {
+            quint32 c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xedb88320 ^ (c >> 1) : c >> 1;
+            }
+            entries[i] = c;
+        }
+    }
+};
+
+/**
+ * Count the bytes into four interleaved tables, so consecutive equal bytes don't wait for each
+ * other's increment, and read eight bytes per load.
+ */
+void countBytes(const uchar *data, qint64 length, quint64 *histogram)
+{
+    quint32 counts[4][256] = {};
+    qint64 i = 0;
+    for (; i + 8 <= length; i += 8) {
+        quint64 word;
+        memcpy(&word, data + i, sizeof(word));
+        counts[0][word & 0xff]++;
+        counts[1][(word >> 8) & 0xff]++;
+        counts[2][(word >> 16) & 0xff]++;
+        counts[3][(word >> 24) & 0xff]++;
+        counts[0][(word >> 32) & 0xff]++;
+        counts[1][(word >> 40) & 0xff]++;
+        counts[2][(word >> 48) & 0xff]++;
+        counts[3][word >> 56]++;
+    }
+    for (; i < length; i++) {
+        counts[0][data[i]]++;
+    }
+    for (int b = 0; b < 256; b++) {
+        histogram[b] += static_cast<quint64>(counts[0][b]) + counts[1][b] + counts[2][b]
+                + counts[3][b];
+    }
+}
+
+ByteBlockStats statsFromHistogram(const Histogram &histogram)
+{
+    quint64 total = 0;
+    quint64 printable = histogram['\t'] + histogram['\n'] + histogram['\r'];
+    quint64 high = 0;
+    for (int b = 0; b < 256; b++) {
+        total += histogram[b];
+        if (b >= 0x20 && b < 0x7f) {
+            printable += histogram[b];
+        } else if (b >= 0x80) {
+            high += histogram[b];
+        }
+    }
+    ByteBlockStats stats;
+    if (!total) {
+        return stats;
+    }
+    stats.entropy = static_cast<float>(FileDigestTask::entropy(histogram.data()) / 8);
+    stats.printable = static_cast<float>(printable) / total;
+    stats.zero = static_cast<float>(histogram[0]) / total;
+    stats.high = static_cast<float>(high) / total;
+    return stats;
+}
+
+QMutex cacheMutex;
+/**
+ * Most recently computed digests by cacheKey(), a changed file gets a new key and its old digest
+ * is evicted eventually
+ */
+QCache<QString, FileDigest> cache(kCachedDigests);
+
+QString cacheKey(const QString &path, qint64 size, const QDateTime &modified)
+{
+    return QStringLiteral("%1\n%2\n%3").arg(path).arg(size).arg(modified.toMSecsSinceEpoch());
+}
+
+/**
+ * Get the digest of \a path if it was computed with the same \a ranges before and the file did
+ * not change since, cacheMutex must be locked.
+ */
+bool lookupCache(const QString &path, const QVector<FileDigestTask::Range> &ranges,
+                 FileDigest *digest)
+{
+    QFileInfo info(path);
+    const FileDigest *cached = cache.object(cacheKey(path, info.size(), info.lastModified()));
+    if (!cached || cached->ranges != ranges) {
+        return false;
+    }
+    *digest = *cached;
+    return true;
+}
+
+struct DigestRequest
+{
+    QWeakPointer<FileDigestTask> task;
+    QMetaObject::Connection ready;
+    QMetaObject::Connection destroyed;
+};
+
+// Only used in the GUI thread
+QHash<QString, QWeakPointer<FileDigestTask>> runningTasks;
+QHash<QObject *, DigestRequest> requests;
+
+}
+
+FileDigestTask::FileDigestTask(const QString &path, const QVector<Range> &ranges)
+    : path(path), ranges(ranges)
+{
+}
+
+ByteBlockStats FileDigest::blockStats(ut64 offset, ut64 size) const
+{
+    ByteBlockStats result;
+    if (blockLevels.isEmpty() || !blockSize) {
+        return result;
+    }
+    int level = 0;
+    ut64 levelBlockSize = blockSize;
+    while (level + 1 < blockLevels.size() && levelBlockSize * 2 <= size) {
+        level++;
+        levelBlockSize *= 2;
+    }
+    const QVector<ByteBlockStats> &blocks = blockLevels[level];
+    const ut64 first = offset / levelBlockSize;
+    if (first >= static_cast<ut64>(blocks.size())) {
+        return result;
+    }
+    const ut64 last = std::min((offset + std::max<ut64>(size, 1) - 1) / levelBlockSize,
+                               static_cast<ut64>(blocks.size() - 1));
+    for (ut64 i = first; i <= last; i++) {
+        result.entropy += blocks[i].entropy;
+        result.printable += blocks[i].printable;
+        result.zero += blocks[i].zero;
+        result.high += blocks[i].high;
+    }
+    const float count = static_cast<float>(last - first + 1);
+    result.entropy /= count;
+    result.printable /= count;
+    result.zero /= count;
+    result.high /= count;
+    return result;
+}
+
+bool FileDigestTask::request(const QString &path, QObject *context, const Callback &callback,
+                             FileDigest *cached)
+{
+    cancelRequest(context);
+
+    QVector<Range> ranges;
+    for (const SectionDescription &section : Core()->getAllSections(false)) {
+        ranges.append({ section.paddr, section.size });
+    }
+
+    QSharedPointer<FileDigestTask> task;
+    bool start = false;
+    {
+        // Tasks insert their result before emitting digestReady, so the result is either cached
+        // or the connection below is made before it is emitted
+        QMutexLocker locker(&cacheMutex);
+        if (lookupCache(path, ranges, cached)) {
+            return true;
+        }
+        task = runningTasks.value(path).toStrongRef();
+        if (!task || task->isInterrupted() || task->ranges != ranges) {
+            task = QSharedPointer<FileDigestTask>(new FileDigestTask(path, ranges));
+            runningTasks.insert(path, task);
+            start = true;
+        }
+        DigestRequest &request = requests[context];
+        request.task = task;
+        request.ready = connect(task.data(), &FileDigestTask::digestReady, context, callback);
+    }
+    requests[context].destroyed =
+            connect(context, &QObject::destroyed, [context]() { cancelRequest(context); });
+
+    if (start) {
+        QWeakPointer<FileDigestTask> weakTask = task;
+        connect(task.data(), &AsyncTask::finished, Core()->getAsyncTaskManager(),
+                [path, weakTask]() {
+                    if (runningTasks.value(path) == weakTask) {
+                        runningTasks.remove(path);
+                    }
+                    for (auto it = requests.begin(); it != requests.end();) {
+                        if (it->task == weakTask) {
+                            QObject::disconnect(it->destroyed);
+                            it = requests.erase(it);
+                        } else {
+                            ++it;
+                        }
+                    }
+                });
+        Core()->getAsyncTaskManager()->start(task);
+    }
+    return false;
+}
+
+void FileDigestTask::cancelRequest(QObject *context)
+{
+    auto it = requests.find(context);
+    if (it == requests.end()) {
+        return;
+    }
+    QSharedPointer<FileDigestTask> task = it->task.toStrongRef();
+    QObject::disconnect(it->ready);
+    QObject::disconnect(it->destroyed);
+    requests.erase(it);
+    if (!task) {
+        return;
+    }
+    for (const DigestRequest &request : requests) {
+        if (request.task == task) {
+            return;
+        }
+    }
+    // Nobody is waiting for the result anymore
+    task->interrupt();
+    if (runningTasks.value(task->path) == task) {
+        runningTasks.remove(task->path);
+    }
+}
+
+double FileDigestTask::entropy(const quint64 *histogram)
+{
+    quint64 total = 0;
+    for (int i = 0; i < 256; i++) {
+        total += histogram[i];
+    }
+    if (!total) {
+        return 0;
+    }
+    double result = 0;
+    for (int i = 0; i < 256; i++) {
+        if (histogram[i]) {
+            double p = static_cast<double>(histogram[i]) / total;
+            result -= p * std::log2(p);
+        }
+    }
+    return result;
+}
+
+QRgb FileDigestTask::heatColor(const ByteBlockStats &stats)
+{
+    int hue = stats.printable > 0.9f ? 120 : static_cast<int>(240 * (1 - stats.entropy));
+    int value = static_cast<int>(255 * (1 - 0.75f * stats.zero));
+    return QColor::fromHsv(qBound(0, hue, 240), 255, qBound(0, value, 255)).rgba();
+}
+
+void FileDigestTask::runTask()
+{
+    FileDigest digest;
+    QFileInfo info(path);
+    QFile file(path);
+    if (!info.isFile() || !file.open(QIODevice::ReadOnly)) {
+        log(tr("Cannot open %1").arg(path));
+        return;
+    }
+    digest.path = path;
+    digest.size = info.size();
+    digest.modified = info.lastModified();
+    digest.ranges = ranges;
+
+    const ut64 size = static_cast<ut64>(digest.size);
+    digest.blockSize = std::max(kMinBlockSize, (size + kMaxBlocks - 1) / kMaxBlocks);
+    int levelCount = 0;
+    for (ut64 blocks = (size + digest.blockSize - 1) / digest.blockSize; blocks;
+         blocks = blocks > 1 ? (blocks + 1) / 2 : 0) {
+        levelCount++;
+    }
+    digest.blockLevels.resize(levelCount);
+
+    static const Crc32Table crcTable;
+    QCryptographicHash md5(QCryptographicHash::Md5);
+    QCryptographicHash sha1(QCryptographicHash::Sha1);
+    QCryptographicHash sha256(QCryptographicHash::Sha256);
+    quint32 crc = 0xffffffff;
+    Histogram histogram = {};
+    Histogram blockHistogram = {};
+    ut64 blockFill = 0;
+    std::vector<Histogram> rangeHistograms(ranges.size(), Histogram {});
+
+    // Blocks of the next level that wait for their second half
+    std::vector<Histogram> pendingHistograms(levelCount, Histogram {});
+    std::vector<bool> pending(levelCount, false);
+    std::function<void(int, const Histogram &)> addBlock = [&](int level, const Histogram &block) {
+        digest.blockLevels[level].append(statsFromHistogram(block));
+        if (level + 1 >= levelCount) {
+            return;
+        }
+        Histogram &merged = pendingHistograms[level];
+        for (int i = 0; i < 256; i++) {
+            merged[i] += block[i];
+        }
+        if (pending[level]) {
+            Histogram complete = merged;
+            merged.fill(0);
+            pending[level] = false;
+            addBlock(level + 1, complete);
+        } else {
+            pending[level] = true;
+        }
+    };
+    auto finishBlock = [&]() {
+        addBlock(0, blockHistogram);
+        for (int i = 0; i < 256; i++) {
+            histogram[i] += blockHistogram[i];
+        }
+        blockHistogram.fill(0);
+        blockFill = 0;
+    };
+
+    QThreadPool pool;
+    for (qint64 offset = 0; offset < digest.size; offset += kChunkSize) {
+        if (isInterrupted()) {
+            return;
+        }
+        const qint64 length = std::min(kChunkSize, digest.size - offset);
+        QByteArray buffer;
+        uchar *mapped = file.map(offset, length);
+        const uchar *data = mapped;
+        if (!data) {
+            // Not mappable, e.g. on some network file systems
+            file.seek(offset);
+            buffer = file.read(length);
+            if (buffer.size() != length) {
+                log(tr("Cannot read %1").arg(path));
+                return;
+            }
+            data = reinterpret_cast<const uchar *>(buffer.constData());
+        }
+        const char *chars = reinterpret_cast<const char *>(data);
+        const int intLength = static_cast<int>(length);
+
+        pool.start(new DigestLane([&]() { md5.addData(chars, intLength); }));
+        pool.start(new DigestLane([&]() { sha1.addData(chars, intLength); }));
+        pool.start(new DigestLane([&]() { sha256.addData(chars, intLength); }));
+        pool.start(new DigestLane([&]() {
+            for (qint64 i = 0; i < length; i++) {
+                crc = crcTable.entries[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+            }
+        }));
+        pool.start(new DigestLane([&]() {
+            qint64 i = 0;
+            while (i < length) {
+                qint64 n = static_cast<qint64>(
+                        std::min<ut64>(length - i, digest.blockSize - blockFill));
+                countBytes(data + i, n, blockHistogram.data());
+                blockFill += n;
+                i += n;
+                if (blockFill == digest.blockSize) {
+                    finishBlock();
+                }
+            }
+        }));
+        if (!ranges.isEmpty()) {
+            pool.start(new DigestLane([&]() {
+                const ut64 chunkBegin = static_cast<ut64>(offset);
+                const ut64 chunkEnd = chunkBegin + static_cast<ut64>(length);
+                for (int r = 0; r < ranges.size(); r++) {
+                    ut64 begin = std::max(ranges[r].first, chunkBegin);
+                    ut64 end = std::min(ranges[r].first + ranges[r].second, chunkEnd);
+                    if (begin < end) {
+                        countBytes(data + (begin - chunkBegin), end - begin,
+                                   rangeHistograms[r].data());
+                    }
+                }
+            }));
+        }
+        pool.waitForDone();
+
+        if (mapped) {
+            file.unmap(mapped);
+        }
+    }
+    if (blockFill) {
+        finishBlock();
+    }
+    for (int level = 0; level + 1 < levelCount; level++) {
+        if (pending[level]) {
+            pending[level] = false;
+            addBlock(level + 1, pendingHistograms[level]);
+        }
+    }
+
+    digest.md5 = md5.result().toHex();
+    digest.sha1 = sha1.result().toHex();
+    digest.sha256 = sha256.result().toHex();
+    digest.crc32 = crc ^ 0xffffffff;
+    digest.entropy = entropy(histogram.data());
+    for (const Histogram &rangeHistogram : rangeHistograms) {
+        digest.rangeEntropy.append(entropy(rangeHistogram.data()));
+    }
+
+    {
+        QMutexLocker locker(&cacheMutex);
+        cache.insert(cacheKey(path, digest.size, digest.modified), new FileDigest(digest));
+    }
+    emit digestReady(digest);
+}
@@ -0,0 +1,140 @@
+#ifndef FILEDIGESTTASK_H
+#define FILEDIGESTTASK_H
+
+#include "common/AsyncTask.h"
+#include "core/CutterCommon.h"
+
+#include <QByteArray>
+#include <QColor>
+#include <QDateTime>
+#include <QMetaType>
+#include <QPair>
+#include <QVector>
+
+#include <functional>
+
+/**
+ * @brief Byte statistics of a block of a file, all values are between 0 and 1
+ */
+struct ByteBlockStats
+{
+    /**
+     * @brief Shannon entropy divided by 8 bits
+     */
+    float entropy = 0;
+    /**
+     * @brief Ratio of printable ASCII characters, including whitespace
+     */
+    float printable = 0;
+    float zero = 0;
+    /**
+     * @brief Ratio of bytes with the highest bit set
+     */
+    float high = 0;
+};
+
+struct FileDigest
+{
+    QString path;
+    qint64 size = 0;
+    QDateTime modified;
+
+    QByteArray md5;
+    QByteArray sha1;
+    QByteArray sha256;
+    quint32 crc32 = 0;
+
+    /**
+     * @brief Shannon entropy of the whole file in bits per byte, between 0 and 8
+     */
+    double entropy = 0;
+
+    /**
+     * @brief File ranges as (offset, size) that rangeEntropy was computed for
+     */
+    QVector<QPair<ut64, ut64>> ranges;
+    QVector<double> rangeEntropy;
+
+    /**
+     * @brief Size of the blocks of the finest level in blockLevels
+     */
+    ut64 blockSize = 0;
+
+    /**
+     * @brief Statistics of consecutive blocks covering the whole file at multiple resolutions.
+     * Level 0 has blocks of blockSize bytes, every following level merges pairs of blocks of
+     * the previous one, the last level consists of a single block.
+     */
+    QVector<QVector<ByteBlockStats>> blockLevels;
+
+    /**
+     * @brief Statistics of the file range from \a offset to \a offset + \a size, interpolated
+     * from the coarsest level whose blocks are not larger than \a size
+     */
+    ByteBlockStats blockStats(ut64 offset, ut64 size) const;
+};
+
+Q_DECLARE_METATYPE(FileDigest)
+
+/**
+ * @brief Computes hashes and entropy of a file on disk in a single pass.
+ *
+ * The file is mapped in large chunks and every chunk is fed to the hashes and the byte
+ * histograms in parallel. Tasks are only created through request(), which shares one task per
+ * file between all widgets and always computes the entropy of all sections, so every widget can
+ * use the same result. The most recent results are cached for the same path, size, modification
+ * time and sections, so repeated requests for an unchanged file return immediately.
+ */
+class CUTTER_EXPORT FileDigestTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    using Range = QPair<ut64, ut64>;
+
+    using Callback = std::function<void(const FileDigest &)>;
+
+    QString getTitle() override { return tr("Hashing File"); }
+
+    /**
+     * @brief Get the digest of \a path with the entropy of the sections of the opened file.
+     *
+     * If it isn't cached, \a callback is called in the thread of \a context once the task that
+     * is already computing it, or a new one, is done. An earlier request of \a context is
+     * replaced. The task is interrupted when all contexts waiting for it are destroyed or cancel
+     * their request. Must be called from the GUI thread.
+     *
+     * @return true if \a cached was filled from the cache, \a callback is not called then
+     */
+    static bool request(const QString &path, QObject *context, const Callback &callback,
+                        FileDigest *cached);
+    static void cancelRequest(QObject *context);
+
+    /**
+     * @brief Shannon entropy in bits per byte of the bytes counted in \a histogram
+     */
+    static double entropy(const quint64 *histogram);
+
+    /**
+     * @brief Heat map color for \a stats, from blue for low to red for high entropy.
+     * Blocks that are mostly text are green, mostly zero blocks are darkened.
+     */
+    static QRgb heatColor(const ByteBlockStats &stats);
+
+signals:
+    void digestReady(const FileDigest &digest);
+
+protected:
+    void runTask() override;
+
+private:
+    /**
+     * @param ranges file ranges to compute separate entropy values for, e.g. sections
+     */
+    FileDigestTask(const QString &path, const QVector<Range> &ranges);
+
+    QString path;
+    QVector<Range> ranges;
+};
+
+#endif // FILEDIGESTTASK_H
@@ -0,0 +1,327 @@
+#include "GlibcHeapWalker.h"
+#include "core/Cutter.h"
+
+#include <QHash>
+
+#include <algorithm>
+
+namespace {
+
+// Must match the status strings of rz_heap_chunks_list
+const QString &freeStatus()
+{
+    static const QString status = QStringLiteral("free");
+    return status;
+}
+
+const QString &allocatedStatus()
+{
+    static const QString status = QStringLiteral("allocated");
+    return status;
+}
+
+const QString &corruptedStatus()
+{
+    static const QString status = QStringLiteral("corrupted");
+    return status;
+}
+
+const ut64 kPrevInuse = 1;
+const ut64 kSizeBits = 7;
+
+// Upper bound for the heap memory read at once, larger heaps are walked by rizin every time
+const ut64 kMaxSnapshotSize = 1024ULL * 1024 * 1024;
+
+}
+
+void GlibcHeapWalker::setArena(RVA arena)
+{
+    this->arena = arena;
+    invalidate();
+}
+
+void GlibcHeapWalker::invalidate()
+{
+    heapBase = RVA_INVALID;
+    pageHashes.clear();
+    binChunks.clear();
+}
+
+ut64 GlibcHeapWalker::readPointer(const QByteArray &memory, ut64 offset) const
+{
+    if (offset + ptrSize > static_cast<ut64>(memory.size())) {
+        return 0;
+    }
+    return rz_read_ble(memory.constData() + offset, bigEndian, ptrSize * 8);
+}
+
+QSet<RVA> GlibcHeapWalker::readBinChunks() const
+{
+    QSet<RVA> result;
+    for (RzHeapBin *bin : Core()->getHeapBins(arenaAddr)) {
+        RzListIter *iter;
+        RzHeapChunkListItem *item;
+        CutterRListForeach(bin->chunks, iter, RzHeapChunkListItem, item)
+        {
+            result.insert(item->addr);
+        }
+        rz_heap_bin_free_64(bin);
+    }
+    return result;
+}
+
+bool GlibcHeapWalker::takeSnapshot(RzCore *core, Snapshot *snapshot) const
+{
+    MallocState *state = rz_heap_get_arena(core, arenaAddr);
+    if (!state) {
+        return false;
+    }
+    snapshot->arenaHash = qHashBits(state, sizeof(MallocState));
+    snapshot->top = state->top;
+    free(state);
+
+    ut8 topHeader[8] = {};
+    rz_io_read_at(core->io, snapshot->top + ptrSize, topHeader, ptrSize);
+    ut64 topSize = rz_read_ble(topHeader, bigEndian, ptrSize * 8) & ~kSizeBits;
+    snapshot->end = snapshot->top + topSize;
+    if (snapshot->top < heapBase || snapshot->end <= heapBase
+        || snapshot->end - heapBase > kMaxSnapshotSize) {
+        return false;
+    }
+
+    snapshot->memory.resize(static_cast<int>(snapshot->end - heapBase));
+    ut8 *data = reinterpret_cast<ut8 *>(snapshot->memory.data());
+    if (!rz_io_read_at(core->io, heapBase, data, snapshot->memory.size())) {
+        return false;
+    }
+    const int pageCount = static_cast<int>((snapshot->memory.size() + kPageSize - 1) / kPageSize);
+    snapshot->pageHashes.resize(pageCount);
+    for (int i = 0; i < pageCount; i++) {
+        ut64 pageSize = std::min<ut64>(kPageSize, snapshot->memory.size() - i * kPageSize);
+        snapshot->pageHashes[i] = qHashBits(data + i * kPageSize, pageSize);
+    }
+    return true;
+}
+
+GlibcHeapWalker::Delta GlibcHeapWalker::walkAll(RzCore *core)
+{
+    Delta delta;
+    delta.reset = true;
+    delta.changed = true;
+
+    arenaAddr = arena;
+    if (!arenaAddr) {
+        QVector<Arena> arenas = Core()->getArenas();
+        arenaAddr = arenas.isEmpty() ? 0 : arenas.first().offset;
+    }
+    ptrSize = Core()->getArchBits();
+    bigEndian = rz_config_get_b(core->config, "cfg.bigendian");
+
+    chunks = Core()->getHeapChunks(arenaAddr);
+    changes = QVector<Change>(chunks.size(), Change::Unchanged);
+    markedRows.clear();
+    heapBase = chunks.isEmpty() ? RVA_INVALID : chunks.first().offset;
+    binChunks = readBinChunks();
+
+    Snapshot snapshot;
+    if (heapBase == RVA_INVALID || !takeSnapshot(core, &snapshot)) {
+        // Without a snapshot every update walks the whole arena again
+        heapBase = RVA_INVALID;
+        return delta;
+    }
+    arenaHash = snapshot.arenaHash;
+    pageHashes = snapshot.pageHashes;
+    top = snapshot.top;
+    return delta;
+}
+
+int GlibcHeapWalker::findChunk(RVA offset) const
+{
+    auto it = std::lower_bound(chunks.constBegin(), chunks.constEnd(), offset,
+                               [](const Chunk &chunk, RVA addr) { return chunk.offset < addr; });
+    if (it == chunks.constEnd() || it->offset != offset) {
+        return -1;
+    }
+    return static_cast<int>(it - chunks.constBegin());
+}
+
+GlibcHeapWalker::Delta GlibcHeapWalker::update()
+{
+    RzCoreLocked core(Core());
+    if (heapBase == RVA_INVALID) {
+        return walkAll(core);
+    }
+
+    Snapshot snapshot;
+    if (!takeSnapshot(core, &snapshot)) {
+        invalidate();
+        return walkAll(core);
+    }
+
+    // The highlights of the previous step are dropped in any case
+    QVector<int> touched = markedRows;
+    for (int row : markedRows) {
+        changes[row] = Change::Unchanged;
+    }
+    markedRows.clear();
+
+    const int pageCount = snapshot.pageHashes.size();
+    int firstDirty = -1;
+    int lastDirty = -1;
+    for (int i = 0; i < pageCount; i++) {
+        if (i >= pageHashes.size() || pageHashes[i] != snapshot.pageHashes[i]) {
+            firstDirty = firstDirty < 0 ? i : firstDirty;
+            lastDirty = i;
+        }
+    }
+
+    Delta delta;
+    if (firstDirty < 0 && snapshot.arenaHash == arenaHash) {
+        // Nothing happened on the heap since the last step
+        delta.changed = !touched.isEmpty();
+        delta.commonPrefix = chunks.size();
+        delta.changedRows = touched;
+        return delta;
+    }
+    QSet<RVA> newBinChunks = readBinChunks();
+
+    auto statusOf = [&](const Chunk &chunk) {
+        const RVA next = chunk.offset + chunk.size;
+        if (chunk.offset == snapshot.top || newBinChunks.contains(chunk.offset)
+            || !(readPointer(snapshot.memory, next - heapBase + ptrSize) & kPrevInuse)) {
+            return freeStatus();
+        }
+        return allocatedStatus();
+    };
+
+    // A chunk has to be walked again if its own or the following header lies on a modified page,
+    // the following header decides whether the chunk is in use
+    int first = chunks.size();
+    int resume = chunks.size();
+    if (firstDirty >= 0) {
+        const RVA firstDirtyAddr = heapBase + firstDirty * kPageSize;
+        auto it = std::lower_bound(chunks.constBegin(), chunks.constEnd(), firstDirtyAddr,
+                                   [this](const Chunk &chunk, RVA addr) {
+                                       return chunk.offset + chunk.size + ptrSize <= addr;
+                                   });
+        first = static_cast<int>(it - chunks.constBegin());
+    }
+
+    QVector<Chunk> walked;
+    QVector<Change> walkedChanges;
+    if (first < chunks.size()) {
+        // Chunks whose header lies behind the last modified page are known to be unchanged
+        const RVA cleanAddr = heapBase + (lastDirty + 1) * kPageSize;
+        int oldIndex = first;
+        RVA addr = chunks[first].offset;
+        while (addr < snapshot.end) {
+            while (oldIndex < chunks.size() && chunks[oldIndex].offset < addr) {
+                oldIndex++;
+            }
+            const bool known = oldIndex < chunks.size() && chunks[oldIndex].offset == addr;
+            if (known && addr + ptrSize >= cleanAddr && snapshot.top == top) {
+                resume = oldIndex;
+                break;
+            }
+            Chunk chunk;
+            chunk.offset = addr;
+            chunk.size = readPointer(snapshot.memory, addr - heapBase + ptrSize) & ~kSizeBits;
+            Change change = known ? Change::Unchanged : Change::Added;
+            if (chunk.size < 2 * static_cast<ut64>(ptrSize) || addr + chunk.size > snapshot.end) {
+                chunk.status = corruptedStatus();
+            } else {
+                chunk.status = statusOf(chunk);
+            }
+            if (known && chunks[oldIndex].size != chunk.size) {
+                change = Change::Resized;
+            } else if (known && chunks[oldIndex].status != chunk.status) {
+                change = chunk.status == freeStatus() ? Change::Freed : Change::Allocated;
+            }
+            walked.append(chunk);
+            walkedChanges.append(change);
+            if (chunk.status == corruptedStatus()) {
+                break;
+            }
+            addr += chunk.size;
+        }
+    }
+
+    // Free or reuse from the bins doesn't necessarily modify the heap pages around the chunk
+    for (RVA offset : (binChunks - newBinChunks) + (newBinChunks - binChunks)) {
+        int row = findChunk(offset);
+        if (row < 0 || (row >= first && row < resume)
+            || chunks[row].status == corruptedStatus()) {
+            continue;
+        }
+        const QString &status = statusOf(chunks[row]);
+        if (status != chunks[row].status) {
+            chunks[row].status = status;
+            changes[row] = status == freeStatus() ? Change::Freed : Change::Allocated;
+            touched.append(row);
+        }
+    }
+
+    // Walked chunks at the borders which kept their offset are updated in place
+    const int removed = resume - first;
+    int lead = 0;
+    while (lead < walked.size() && lead < removed
+           && walked[lead].offset == chunks[first + lead].offset) {
+        lead++;
+    }
+    int trail = 0;
+    while (trail < walked.size() - lead && trail < removed - lead
+           && walked[walked.size() - 1 - trail].offset == chunks[resume - 1 - trail].offset) {
+        trail++;
+    }
+    delta.commonPrefix = first + lead;
+    delta.commonSuffix = chunks.size() - resume + trail;
+
+    const int shift = walked.size() - removed;
+    for (int row : touched) {
+        if (row < delta.commonPrefix) {
+            delta.changedRows.append(row);
+        } else if (row >= resume - trail) {
+            delta.changedRows.append(row + shift);
+        }
+    }
+
+    // Splice the walked chunks into the list, Qt has no insert of a range
+    if (shift > 0) {
+        chunks.insert(resume, shift, Chunk());
+        changes.insert(resume, shift, Change::Unchanged);
+    } else if (shift < 0) {
+        chunks.remove(first + walked.size(), -shift);
+        changes.remove(first + walked.size(), -shift);
+    }
+    std::copy(walked.constBegin(), walked.constEnd(), chunks.begin() + first);
+    std::copy(walkedChanges.constBegin(), walkedChanges.constEnd(), changes.begin() + first);
+
+    for (int i = 0; i < walked.size(); i++) {
+        if (walkedChanges[i] != Change::Unchanged
+            && (i < lead || i >= walked.size() - trail)) {
+            delta.changedRows.append(first + i);
+        }
+    }
+    std::sort(delta.changedRows.begin(), delta.changedRows.end());
+    delta.changedRows.erase(std::unique(delta.changedRows.begin(), delta.changedRows.end()),
+                            delta.changedRows.end());
+    for (int row : delta.changedRows) {
+        if (changes[row] != Change::Unchanged) {
+            markedRows.append(row);
+        }
+    }
+    for (int i = lead; i < walked.size() - trail; i++) {
+        if (walkedChanges[i] != Change::Unchanged) {
+            markedRows.append(first + i);
+        }
+    }
+    std::sort(markedRows.begin(), markedRows.end());
+    delta.changed = !delta.changedRows.isEmpty() || lead + trail < removed
+            || lead + trail < walked.size();
+
+    arenaHash = snapshot.arenaHash;
+    pageHashes = snapshot.pageHashes;
+    binChunks = newBinChunks;
+    top = snapshot.top;
+    return delta;
+}
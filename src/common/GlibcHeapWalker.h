@@ -0,0 +1,103 @@
+#ifndef GLIBCHEAPWALKER_H
+#define GLIBCHEAPWALKER_H
+
+#include "core/CutterCommon.h"
+#include "core/CutterDescriptions.h"
+
+#include <QByteArray>
+#include <QSet>
+#include <QVector>
+
+/**
+ * @brief Walks the chunks of a glibc heap arena incrementally across debug steps.
+ *
+ * The first walk uses rizin. Afterwards the heap memory is read in bulk and hashed page by
+ * page, which is how modified memory is found since the debugger doesn't track it. The walk then
+ * starts again at the first chunk touching a modified page and ends as soon as it reaches a known
+ * chunk behind the last modified page, the chunks before and after are taken over from the
+ * previous walk. Every update also records how each chunk changed since the previous one, so
+ * views can update rows in place and highlight the last step's changes.
+ */
+class CUTTER_EXPORT GlibcHeapWalker
+{
+public:
+    enum class Change : quint8 { Unchanged, Added, Allocated, Freed, Resized };
+
+    struct Delta
+    {
+        /**
+         * @brief The chunk list was replaced entirely, e.g. for a new process or arena
+         */
+        bool reset = false;
+        /**
+         * @brief Whether any chunk or any change marker differs from the previous update
+         */
+        bool changed = false;
+        /**
+         * @brief Number of leading and trailing chunks that kept their offset, the rows between
+         * them were replaced
+         */
+        int commonPrefix = 0;
+        int commonSuffix = 0;
+        /**
+         * @brief Sorted rows of the common prefix and suffix whose status or change marker
+         * differs, as indices into the new chunk list
+         */
+        QVector<int> changedRows;
+    };
+
+    /**
+     * @param arena base address of the arena, zero for the main arena
+     */
+    void setArena(RVA arena);
+    RVA getArena() const { return arena; }
+
+    /**
+     * @brief Forget the previous walk, the next update() walks the whole arena again
+     */
+    void invalidate();
+
+    Delta update();
+
+    const QVector<Chunk> &getChunks() const { return chunks; }
+    const QVector<Change> &getChanges() const { return changes; }
+
+private:
+    static const ut64 kPageSize = 4096;
+
+    RVA arena = 0;
+    RVA arenaAddr = 0;
+    int ptrSize = 8;
+    bool bigEndian = false;
+    RVA heapBase = RVA_INVALID;
+    RVA top = RVA_INVALID;
+    uint arenaHash = 0;
+    QVector<uint> pageHashes;
+    QSet<RVA> binChunks;
+    QVector<Chunk> chunks;
+    QVector<Change> changes;
+    /**
+     * @brief Sorted indices of the chunks whose change isn't Unchanged
+     */
+    QVector<int> markedRows;
+
+    struct Snapshot
+    {
+        uint arenaHash = 0;
+        RVA top = RVA_INVALID;
+        RVA end = RVA_INVALID;
+        QByteArray memory;
+        QVector<uint> pageHashes;
+    };
+
+    Delta walkAll(RzCore *core);
+    /**
+     * @brief Read the memory from heapBase to the end of the top chunk and hash its pages
+     */
+    bool takeSnapshot(RzCore *core, Snapshot *snapshot) const;
+    QSet<RVA> readBinChunks() const;
+    int findChunk(RVA offset) const;
+    ut64 readPointer(const QByteArray &memory, ut64 offset) const;
+};
+
+#endif // GLIBCHEAPWALKER_H
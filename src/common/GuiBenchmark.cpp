@@ -0,0 +1,372 @@
+#include "GuiBenchmark.h"
+#include "CutterConfig.h"
+
+#include "common/Decompiler.h"
+#include "core/MainWindow.h"
+#include "widgets/DecompilerWidget.h"
+#include "widgets/DisassemblerGraphView.h"
+#include "widgets/DisassemblyWidget.h"
+#include "widgets/GraphWidget.h"
+#include "widgets/HexWidget.h"
+#include "widgets/HexdumpWidget.h"
+#include "widgets/VisualNavbar.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QPlainTextEdit>
+#include <QScrollBar>
+#include <QTimer>
+#include <QWheelEvent>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#ifdef CUTTER_ENABLE_BENCHMARKS
+#    include <cstdlib>
+#    include <new>
+
+// Counts the allocations of the whole process that go through operator new, that includes the
+// private objects of Qt classes. Qt containers such as QString allocate with malloc and aren't
+// counted.
+static std::atomic<quint64> allocationCount(0);
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+// How long to wait for the analysis or a single step
+static const qint64 kTimeoutMs = 5 * 60 * 1000;
+
+static double nsToMs(qint64 ns)
+{
+    return ns / 1e6;
+}
+
+static QJsonObject summarize(QVector<double> values)
+{
+    QJsonObject result;
+    if (values.isEmpty()) {
+        return result;
+    }
+    std::sort(values.begin(), values.end());
+    double sum = 0;
+    for (double value : values) {
+        sum += value;
+    }
+    int p95 = std::max(0, static_cast<int>(std::ceil(values.size() * 0.95)) - 1);
+    result["min"] = values.first();
+    result["median"] = values[values.size() / 2];
+    result["p95"] = values[p95];
+    result["max"] = values.last();
+    result["mean"] = sum / values.size();
+    return result;
+}
+
+static bool isIdle()
+{
+    if (Core()->getAsyncTaskManager()->getTasksRunning() || Core()->isDebugTaskInProgress()) {
+        return false;
+    }
+    for (Decompiler *decompiler : Core()->getDecompilers()) {
+        if (decompiler->isRunning()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Scroll \a widget like the mouse wheel does, 120 units of \a angleDelta are one notch
+ */
+static void sendWheel(QWidget *widget, QPoint angleDelta)
+{
+    QPoint pos = widget->rect().center();
+    QWheelEvent event(QPointF(pos), QPointF(widget->mapToGlobal(pos)), QPoint(), angleDelta,
+                      Qt::NoButton, Qt::NoModifier, Qt::NoScrollPhase, false);
+    QCoreApplication::sendEvent(widget, &event);
+}
+
+GuiBenchmark::Counters GuiBenchmark::Counters::current()
+{
+    Counters counters;
+    counters.commands = Core()->getCommandCount();
+    counters.coreLocks = Core()->getCoreLockCount();
+#ifdef CUTTER_ENABLE_BENCHMARKS
+    counters.allocations = allocationCount.load(std::memory_order_relaxed);
+#else
+    counters.allocations = 0;
+#endif
+    return counters;
+}
+
+GuiBenchmark *GuiBenchmark::instance()
+{
+    static GuiBenchmark benchmark;
+    return &benchmark;
+}
+
+void GuiBenchmark::enable(const QString &reportPath, int steps)
+{
+    this->reportPath = reportPath;
+    this->steps = steps;
+    enabled = true;
+}
+
+void GuiBenchmark::run(MainWindow *main)
+{
+    if (!enabled) {
+        return;
+    }
+    enabled = false;
+    navbar = main->findChild<VisualNavbar *>();
+
+    // The window may be shown with the first results while the analysis continues
+    waitUntilIdle();
+
+    QList<FunctionDescription> functions = Core()->getAllFunctions();
+    std::sort(functions.begin(), functions.end(),
+              [](const FunctionDescription &a, const FunctionDescription &b) {
+                  return a.offset < b.offset;
+              });
+    RVA largestFunction = Core()->getOffset();
+    RVA largestBlockCount = 0;
+    for (const FunctionDescription &function : functions) {
+        if (function.nbbs > largestBlockCount) {
+            largestBlockCount = function.nbbs;
+            largestFunction = function.offset;
+        }
+    }
+    auto seekFunction = [&functions](int i) {
+        if (!functions.isEmpty()) {
+            Core()->seek(functions[i % functions.size()].offset);
+        }
+    };
+
+    auto disassembly = main->findChild<DisassemblyWidget *>();
+    auto graph = main->findChild<GraphWidget *>();
+    auto hexdump = main->findChild<HexdumpWidget *>();
+    auto decompiler = main->findChild<DecompilerWidget *>();
+    bool decompilerAvailable = !Core()->getDecompilers().isEmpty();
+
+    QJsonArray interactions;
+
+    if (disassembly) {
+        Core()->seek(functions.isEmpty() ? Core()->getOffset() : functions.first().offset);
+        interactions.append(measure("disassembly.scroll", disassembly, [disassembly](int) {
+            int lines = static_cast<int>(disassembly->getLines().size());
+            disassembly->scrollInstructions(std::max(1, lines));
+        }));
+        interactions.append(measure("disassembly.seek", disassembly, seekFunction));
+    } else {
+        interactions.append(skipped("disassembly.scroll", "no disassembly widget open"));
+        interactions.append(skipped("disassembly.seek", "no disassembly widget open"));
+    }
+
+    if (hexdump) {
+        auto hex = hexdump->findChild<HexWidget *>();
+        interactions.append(measure("hexdump.scroll", hexdump, [hex](int) {
+            // HexWidget scrolls one row per 5 degrees
+            int rows = std::max(1, hex->viewport()->height() / hex->fontMetrics().height());
+            sendWheel(hex->viewport(), QPoint(0, -rows * 8 * 5));
+        }));
+        interactions.append(measure("hexdump.seek", hexdump, seekFunction));
+    } else {
+        interactions.append(skipped("hexdump.scroll", "no hexdump widget open"));
+        interactions.append(skipped("hexdump.seek", "no hexdump widget open"));
+    }
+
+    if (graph) {
+        DisassemblerGraphView *view = graph->getGraphView();
+        Core()->seek(largestFunction);
+        int direction = -1;
+        interactions.append(measure("graph.pan", graph, [view, &direction](int) {
+            // Pan by half a screen, turn around at the end of the graph
+            QPoint before = view->getViewOffset();
+            QPoint delta(0, direction * view->viewport()->height() / 2);
+            sendWheel(view->viewport(), delta);
+            if (view->getViewOffset() == before) {
+                direction = -direction;
+                sendWheel(view->viewport(), -delta);
+            }
+        }));
+        interactions.append(measure("graph.seek", graph, seekFunction));
+    } else {
+        interactions.append(skipped("graph.pan", "no graph widget open"));
+        interactions.append(skipped("graph.seek", "no graph widget open"));
+    }
+
+    if (decompiler && decompilerAvailable) {
+        auto textEdit = decompiler->findChild<QPlainTextEdit *>();
+        Core()->seek(largestFunction);
+        interactions.append(measure("decompiler.scroll", decompiler, [textEdit](int) {
+            QScrollBar *scrollBar = textEdit->verticalScrollBar();
+            if (scrollBar->value() == scrollBar->maximum()) {
+                scrollBar->setValue(scrollBar->minimum());
+            } else {
+                scrollBar->triggerAction(QAbstractSlider::SliderPageStepAdd);
+            }
+        }));
+        interactions.append(measure("decompiler.seek", decompiler, seekFunction));
+    } else {
+        QString reason = decompiler ? "no decompiler available" : "no decompiler widget open";
+        interactions.append(skipped("decompiler.scroll", reason));
+        interactions.append(skipped("decompiler.seek", reason));
+    }
+
+    if (disassembly) {
+        Core()->startDebug();
+        waitUntilIdle();
+        if (Core()->currentlyDebugging) {
+            interactions.append(
+                    measure("debug.step", disassembly, [](int) { Core()->stepDebug(); }));
+            Core()->stopDebug();
+            waitUntilIdle();
+        } else {
+            interactions.append(skipped("debug.step", "the file can't be debugged"));
+        }
+    } else {
+        interactions.append(skipped("debug.step", "no disassembly widget open"));
+    }
+
+    QJsonObject report;
+    report["cutterVersion"] = QStringLiteral(CUTTER_VERSION_FULL);
+    report["file"] = main->getFilename();
+    report["platform"] = QGuiApplication::platformName();
+    report["steps"] = steps;
+#ifdef CUTTER_ENABLE_BENCHMARKS
+    report["allocationsCounted"] = true;
+#else
+    report["allocationsCounted"] = false;
+#endif
+    report["functions"] = functions.size();
+    report["timedOut"] = timedOut;
+    report["interactions"] = interactions;
+
+    bool written = writeReport(report);
+    QCoreApplication::exit(written && !timedOut ? 0 : 1);
+}
+
+QJsonObject GuiBenchmark::measure(const QString &name, CutterDockWidget *dock,
+                                  const std::function<void(int)> &step)
+{
+    QVector<QWidget *> targets;
+    targets.append(dock);
+    if (navbar) {
+        targets.append(navbar);
+    }
+
+    dock->raiseMemoryWidget();
+    waitUntilIdle();
+    for (QWidget *target : targets) {
+        target->repaint();
+    }
+
+    QVector<double> frameMs;
+    QVector<double> handleMs;
+    QVector<QVector<double>> paintMs(targets.size());
+    Counters before = Counters::current();
+    QElapsedTimer timer;
+    for (int i = 0; i < steps && !timedOut; i++) {
+        timer.start();
+        step(i);
+        if (!waitUntilIdle()) {
+            break;
+        }
+        qint64 handled = timer.nsecsElapsed();
+        qint64 last = handled;
+        for (int t = 0; t < targets.size(); t++) {
+            targets[t]->repaint();
+            qint64 now = timer.nsecsElapsed();
+            paintMs[t].append(nsToMs(now - last));
+            last = now;
+        }
+        handleMs.append(nsToMs(handled));
+        frameMs.append(nsToMs(last));
+    }
+    Counters after = Counters::current();
+
+    QJsonObject paintObject;
+    for (int t = 0; t < targets.size(); t++) {
+        paintObject[targets[t]->metaObject()->className()] = summarize(paintMs[t]);
+    }
+    QJsonArray frameArray;
+    for (double ms : frameMs) {
+        frameArray.append(ms);
+    }
+
+    QJsonObject result;
+    result["name"] = name;
+    result["frames"] = frameMs.size();
+    result["frameMs"] = summarize(frameMs);
+    result["handleMs"] = summarize(handleMs);
+    result["paintMs"] = paintObject;
+    result["frameTimesMs"] = frameArray;
+    result["rizinCommands"] = static_cast<double>(after.commands - before.commands);
+    result["coreLocks"] = static_cast<double>(after.coreLocks - before.coreLocks);
+#ifdef CUTTER_ENABLE_BENCHMARKS
+    result["allocations"] = static_cast<double>(after.allocations - before.allocations);
+#else
+    result["allocations"] = QJsonValue();
+#endif
+    return result;
+}
+
+QJsonObject GuiBenchmark::skipped(const QString &name, const QString &reason)
+{
+    QJsonObject result;
+    result["name"] = name;
+    result["skipped"] = reason;
+    return result;
+}
+
+bool GuiBenchmark::waitUntilIdle()
+{
+    return waitUntil(isIdle);
+}
+
+bool GuiBenchmark::waitUntil(const std::function<bool()> &condition)
+{
+    // Makes sure that waiting for more events returns even if nothing is posted
+    QTimer wakeUp;
+    wakeUp.start(50);
+    QElapsedTimer timer;
+    timer.start();
+    QCoreApplication::processEvents();
+    while (!condition()) {
+        if (timer.elapsed() > kTimeoutMs) {
+            qWarning() << "GUI benchmark timed out waiting for background work";
+            timedOut = true;
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents | QEventLoop::WaitForMoreEvents);
+    }
+    return true;
+}
+
+bool GuiBenchmark::writeReport(const QJsonObject &report)
+{
+    QFile file(reportPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Cannot write GUI benchmark report to" << reportPath << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(report).toJson());
+    return true;
+}
@@ -0,0 +1,84 @@
+#ifndef GUIBENCHMARK_H
+#define GUIBENCHMARK_H
+
+#include "core/CutterCommon.h"
+
+#include <QJsonObject>
+#include <QString>
+
+#include <functional>
+
+class CutterDockWidget;
+class MainWindow;
+class QWidget;
+
+/**
+ * @brief Drives scripted interactions with the memory widgets and measures every frame.
+ *
+ * Only active when Cutter was started with --benchmark-gui, in that case run() is called once the
+ * file is opened. Every interaction (scrolling pages, panning the graph, seeking through functions,
+ * stepping the debugger) is split into frames. A frame is the handling of one step including the
+ * refreshes it triggers and the background work it waits for, followed by a synchronous repaint of
+ * the dock under test and the VisualNavbar. For each interaction the frame times, the number of
+ * rizin commands and core locks and the number of allocations are written as JSON, then Cutter
+ * quits. Allocations are only counted in builds with CUTTER_ENABLE_BENCHMARKS.
+ *
+ * Meant to be run with QT_QPA_PLATFORM=offscreen, see the GuiBenchmark target in src/benchmarks.
+ */
+class CUTTER_EXPORT GuiBenchmark
+{
+public:
+    static GuiBenchmark *instance();
+
+    /**
+     * @param reportPath file the JSON report is written to
+     * @param steps number of frames of each interaction, e.g. the pages to scroll or the functions
+     * to seek through
+     */
+    void enable(const QString &reportPath, int steps);
+    bool isEnabled() const { return enabled; }
+
+    /**
+     * @brief Wait for the analysis, run all interactions, write the report and quit the
+     * application. The exit code is non-zero if an interaction didn't finish in time.
+     */
+    void run(MainWindow *main);
+
+private:
+    GuiBenchmark() = default;
+
+    struct Counters
+    {
+        quint64 commands;
+        quint64 coreLocks;
+        quint64 allocations;
+
+        static Counters current();
+    };
+
+    bool enabled = false;
+    QString reportPath;
+    int steps = 20;
+    bool timedOut = false;
+
+    QWidget *navbar = nullptr;
+
+    /**
+     * @brief Raise \a dock, let it settle and measure \a step called with 0 to steps - 1
+     * @param step performs one step, the background work it starts is waited for by measure()
+     */
+    QJsonObject measure(const QString &name, CutterDockWidget *dock,
+                        const std::function<void(int)> &step);
+    QJsonObject skipped(const QString &name, const QString &reason);
+
+    /**
+     * @brief Process events until nothing runs in the background anymore
+     * @return false if that didn't happen within the timeout
+     */
+    bool waitUntilIdle();
+    bool waitUntil(const std::function<bool()> &condition);
+
+    bool writeReport(const QJsonObject &report);
+};
+
+#endif // GUIBENCHMARK_H
@@ -42,6 +42,12 @@ struct InitialOptions
 
     QList<CommandDescription> analCmd = { { "aaa", "Auto analysis" } };
 
+    /**
+     * @brief Load the results of analCmd from AnalysisCache if this file was analyzed with the
+     * same options before, and store them there otherwise
+     */
+    bool useAnalysisCache = false;
+
     QString shellcode;
 };
 
@@ -0,0 +1,178 @@
+#include "MultiPatternSearch.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+static const RVA kChunkSize = 16 * 1024 * 1024;
+
+struct PatternHit
+{
+    int pattern;
+    RVA offset;
+};
+
+/**
+ * @brief Scans one chunk of memory. Hits starting in the overlap with the next chunk are
+ * dropped, the next chunk reports them.
+ */
+class ChunkScanJob : public QRunnable
+{
+public:
+    ChunkScanJob(const AhoCorasickMatcher &matcher, RVA base, RVA ownSize, QByteArray data)
+        : matcher(matcher), base(base), ownSize(ownSize), data(data)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() override
+    {
+        matcher.scan(reinterpret_cast<const ut8 *>(data.constData()),
+                     static_cast<size_t>(data.size()), [this](int pattern, size_t offset) {
+                         if (offset < ownSize) {
+                             hits.push_back({ pattern, base + offset });
+                         }
+                     });
+    }
+
+    const AhoCorasickMatcher &matcher;
+    RVA base;
+    RVA ownSize;
+    QByteArray data;
+    std::vector<PatternHit> hits;
+};
+
+}
+
+MultiPatternSearchTask::MultiPatternSearchTask(const QVector<BytePattern> &patterns,
+                                               const QString &searchIn)
+    : patterns(patterns), searchIn(searchIn)
+{
+}
+
+QVector<BytePattern> MultiPatternSearchTask::loadPatternFile(const QString &path,
+                                                             QString *errorMessage)
+{
+    QVector<BytePattern> result;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        *errorMessage = file.errorString();
+        return result;
+    }
+
+    QTextStream stream(&file);
+    int lineNumber = 0;
+    while (!stream.atEnd()) {
+        QString line = stream.readLine().trimmed();
+        lineNumber++;
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        BytePattern pattern;
+        QString hex = line;
+        int separator = line.lastIndexOf(':');
+        if (separator >= 0) {
+            pattern.name = line.left(separator).trimmed();
+            hex = line.mid(separator + 1);
+        }
+        hex.remove(' ');
+        pattern.bytes = CutterCore::hexStringToBytes(hex);
+        if (pattern.bytes.isEmpty() || pattern.bytes.size() * 2 != hex.size()) {
+            *errorMessage = tr("Invalid hex pattern on line %1: %2").arg(lineNumber).arg(line);
+            return QVector<BytePattern>();
+        }
+        if (pattern.name.isEmpty()) {
+            pattern.name = hex;
+        }
+        result.append(pattern);
+    }
+    return result;
+}
+
+void MultiPatternSearchTask::runTask()
+{
+    QVector<QByteArray> patternBytes;
+    patternBytes.reserve(patterns.size());
+    for (const BytePattern &pattern : patterns) {
+        patternBytes.append(pattern.bytes);
+    }
+    AhoCorasickMatcher matcher(patternBytes);
+    const RVA overlap = static_cast<RVA>(std::max(0, matcher.getMaxPatternLength() - 1));
+    const int maxHits = Core()->getConfigi("search.maxhits");
+
+    QList<SearchDescription> results;
+    QVector<quint64> hitCounts(patterns.size(), 0);
+    quint64 scannedBytes = 0;
+
+    QThreadPool pool;
+    const int lanes = std::max(1, QThread::idealThreadCount());
+    pool.setMaxThreadCount(lanes);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<std::unique_ptr<ChunkScanJob>> jobs;
+    auto flushJobs = [&]() {
+        for (auto &job : jobs) {
+            pool.start(job.get());
+        }
+        pool.waitForDone();
+        for (auto &job : jobs) {
+            scannedBytes += job->ownSize;
+            for (const PatternHit &hit : job->hits) {
+                hitCounts[hit.pattern]++;
+                if (maxHits > 0 && results.size() >= maxHits) {
+                    continue;
+                }
+                const BytePattern &pattern = patterns[hit.pattern];
+                SearchDescription desc;
+                desc.offset = hit.offset;
+                desc.size = pattern.bytes.size();
+                desc.code = pattern.name;
+                desc.data = CutterCore::bytesToHexString(pattern.bytes);
+                results.append(desc);
+            }
+        }
+        jobs.clear();
+    };
+
+    for (const auto &range : Core()->getSearchBoundaries(searchIn)) {
+        const RVA begin = range.first;
+        const RVA size = range.second;
+        for (RVA pos = 0; pos < size && !isInterrupted(); pos += kChunkSize) {
+            RVA ownSize = std::min(kChunkSize, size - pos);
+            RVA readSize = std::min(ownSize + overlap, size - pos);
+            QByteArray data = Core()->ioRead(begin + pos, static_cast<int>(readSize));
+            jobs.emplace_back(new ChunkScanJob(matcher, begin + pos, ownSize, data));
+            if (static_cast<int>(jobs.size()) >= lanes) {
+                flushJobs();
+            }
+        }
+    }
+    flushJobs();
+
+    std::sort(results.begin(), results.end(),
+              [](const SearchDescription &a, const SearchDescription &b) {
+                  return a.offset < b.offset;
+              });
+
+    const qint64 elapsed = std::max<qint64>(1, timer.elapsed());
+    for (int i = 0; i < patterns.size(); i++) {
+        log(tr("%1: %2 hits").arg(patterns[i].name).arg(hitCounts[i]));
+    }
+    log(tr("Scanned %1 bytes for %2 patterns in %3 ms (%4 GB/s)")
+                .arg(scannedBytes)
+                .arg(patterns.size())
+                .arg(elapsed)
+                .arg(scannedBytes / (elapsed / 1000.0) / 1e9, 0, 'f', 3));
+
+    emit searchFinished(results, hitCounts);
+}
@@ -0,0 +1,55 @@
+#ifndef MULTIPATTERNSEARCH_H
+#define MULTIPATTERNSEARCH_H
+
+#include "common/AhoCorasickMatcher.h"
+#include "common/AsyncTask.h"
+#include "core/Cutter.h"
+
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * @brief Named byte pattern used by the multi-pattern search
+ */
+struct BytePattern
+{
+    QString name;
+    QByteArray bytes;
+};
+
+/**
+ * @brief Search all ranges of a search.in boundary for a list of byte patterns at once.
+ *
+ * Memory is read in large chunks which are scanned in parallel. The task reports per-pattern
+ * hit counts and the achieved scan throughput in its log.
+ */
+class CUTTER_EXPORT MultiPatternSearchTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    MultiPatternSearchTask(const QVector<BytePattern> &patterns, const QString &searchIn);
+
+    QString getTitle() override { return tr("Searching for Byte Patterns"); }
+
+    /**
+     * @brief Parse a pattern list file.
+     *
+     * Each non-empty line which doesn't start with '#' contains a hex string, optionally
+     * prefixed by a name and a colon, e.g. "mz_header: 4d5a9000".
+     * @param errorMessage set to a description of the first error, if any
+     */
+    static QVector<BytePattern> loadPatternFile(const QString &path, QString *errorMessage);
+
+signals:
+    void searchFinished(const QList<SearchDescription> &results, const QVector<quint64> &hitCounts);
+
+protected:
+    void runTask() override;
+
+private:
+    QVector<BytePattern> patterns;
+    QString searchIn;
+};
+
+#endif // MULTIPATTERNSEARCH_H
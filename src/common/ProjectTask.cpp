@@ -0,0 +1,74 @@
+#include "ProjectTask.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+
+ProjectSaveTask::ProjectSaveTask(const QString &file) : file(file) {}
+
+void ProjectSaveTask::runTask()
+{
+    // Saves must not write the same file at once. Whichever save runs last also collected the
+    // most recent state, so the order they are started in doesn't matter.
+    static QMutex saveMutex;
+    QMutexLocker locker(&saveMutex);
+
+    QByteArray path = file.toUtf8();
+    RzProject *prj = sdb_new0();
+    if (!prj) {
+        err = RZ_PROJECT_ERR_UNKNOWN;
+        return;
+    }
+
+    log(tr("Collecting project data..."));
+    {
+        RzCoreLocked core(Core());
+        err = rz_project_save(core, prj, path.constData());
+    }
+
+    if (err == RZ_PROJECT_ERR_SUCCESS) {
+        log(tr("Writing %1...").arg(file));
+        if (!sdb_text_save(prj, path.constData(), true)) {
+            err = RZ_PROJECT_ERR_FILE;
+        }
+    }
+    rz_project_free(prj);
+
+    if (err == RZ_PROJECT_ERR_SUCCESS) {
+        // Later saves go to the same file
+        Core()->setConfig("prj.file", file);
+        log(tr("Project saved."));
+    } else {
+        log(tr("Failed to save project: %1").arg(QString::fromUtf8(rz_project_err_message(err))));
+    }
+}
+
+ProjectLoadTask::ProjectLoadTask(const QString &file) : file(file) {}
+
+void ProjectLoadTask::runTask()
+{
+    QByteArray path = file.toUtf8();
+
+    log(tr("Reading %1...").arg(file));
+    RzProject *prj = rz_project_load_file_raw(path.constData());
+    if (!prj) {
+        err = RZ_PROJECT_ERR_FILE;
+        return;
+    }
+
+    log(tr("Loading project..."));
+    RzList *res = rz_list_new();
+    {
+        RzCoreLocked core(Core());
+        err = rz_project_load(core, prj, true, path.constData(), res);
+    }
+    rz_project_free(prj);
+
+    RzListIter *it;
+    const char *s;
+    CutterRListForeach(res, it, const char, s) { messages << QString::fromUtf8(s); }
+    rz_list_free(res);
+
+    if (err == RZ_PROJECT_ERR_SUCCESS) {
+        log(tr("Project loaded."));
+    }
+}
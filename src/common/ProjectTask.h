@@ -0,0 +1,66 @@
+#ifndef PROJECTTASK_H
+#define PROJECTTASK_H
+
+#include "common/AsyncTask.h"
+#include "core/Cutter.h"
+
+#include <QStringList>
+
+/**
+ * @brief Saves the current state as a rizin project.
+ *
+ * The state is serialized while holding the core, the much slower formatting and writing of the
+ * file happens afterwards without it, so the UI can keep using the core meanwhile. Several save
+ * tasks run one after another.
+ */
+class CUTTER_EXPORT ProjectSaveTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    explicit ProjectSaveTask(const QString &file);
+
+    QString getTitle() override { return tr("Saving Project"); }
+
+    const QString &getFile() const { return file; }
+    RzProjectErr getError() const { return err; }
+
+protected:
+    void runTask() override;
+
+private:
+    QString file;
+    RzProjectErr err = RZ_PROJECT_ERR_SUCCESS;
+};
+
+/**
+ * @brief Loads a rizin project, including the binary it references.
+ *
+ * The file is read and parsed before the core is locked.
+ */
+class CUTTER_EXPORT ProjectLoadTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    explicit ProjectLoadTask(const QString &file);
+
+    QString getTitle() override { return tr("Loading Project"); }
+
+    const QString &getFile() const { return file; }
+    RzProjectErr getError() const { return err; }
+    /**
+     * @brief Additional details reported by rizin while loading, e.g. why loading failed
+     */
+    const QStringList &getMessages() const { return messages; }
+
+protected:
+    void runTask() override;
+
+private:
+    QString file;
+    RzProjectErr err = RZ_PROJECT_ERR_SUCCESS;
+    QStringList messages;
+};
+
+#endif // PROJECTTASK_H
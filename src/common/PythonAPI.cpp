@@ -1,9 +1,16 @@
 #include "PythonAPI.h"
+#include "PythonManager.h"
+#include "PythonTask.h"
 #include "core/Cutter.h"
 
 #include "CutterConfig.h"
 
 #include <QFile>
+#include <QRegularExpression>
+#include <QThread>
+#include <climits>
+#include <cstring>
+#include <vector>
 
 PyObject *api_version(PyObject *self, PyObject *null)
 {
@@ -12,19 +19,277 @@ PyObject *api_version(PyObject *self, PyObject *null)
     return PyUnicode_FromString(CUTTER_VERSION_FULL);
 }
 
+static PyObject *unicodeFromUtf8(const QByteArray &bytes)
+{
+    return PyUnicode_FromStringAndSize(bytes.constData(), bytes.size());
+}
+
+/**
+ * @brief Tasks share the core with the GUI thread, so they may only run commands of the print and
+ * info families, without chaining, pipes or redirection, which don't change its state.
+ * @return false with a Python exception set if \a command isn't allowed on the calling thread
+ */
+static bool checkTaskCommand(const char *command)
+{
+    static const QRegularExpression readOnly(QStringLiteral("^\\s*(i|p(?!f\\.))[^;|>`\\n]*$"));
+    if (PythonTask::current() && !readOnly.match(QString::fromUtf8(command)).hasMatch()) {
+        PyErr_Format(PyExc_PermissionError,
+                     "\"%s\" may change the core, tasks can only run print and info commands",
+                     command);
+        return false;
+    }
+    return true;
+}
+
 PyObject *api_cmd(PyObject *self, PyObject *args)
 {
     Q_UNUSED(self);
     char *command;
-    char *result = (char *)"";
-    QString cmdRes;
-    QByteArray cmdBytes;
+    QByteArray result;
     if (PyArg_ParseTuple(args, "s:command", &command)) {
-        cmdRes = Core()->cmd(command);
-        cmdBytes = cmdRes.toLocal8Bit();
-        result = cmdBytes.data();
+        if (!checkTaskCommand(command)) {
+            return NULL;
+        }
+        PythonManager::ThreadReleaser releaser;
+        result = Core()->cmd(command).toUtf8();
+    }
+    return unicodeFromUtf8(result);
+}
+
+PyObject *api_cmd_batch(PyObject *self, PyObject *args)
+{
+    Q_UNUSED(self);
+    PyObject *commandList;
+    if (!PyArg_ParseTuple(args, "O:commands", &commandList)) {
+        return NULL;
+    }
+    Py_ssize_t count = PySequence_Size(commandList);
+    if (count < 0) {
+        return NULL;
+    }
+    std::vector<QByteArray> commands;
+    commands.reserve(count);
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject *item = PySequence_GetItem(commandList, i);
+        if (!item) {
+            return NULL;
+        }
+        PyObject *utf8 = PyUnicode_AsUTF8String(item);
+        Py_DECREF(item);
+        if (!utf8) {
+            return NULL;
+        }
+        commands.emplace_back(PyBytes_AsString(utf8));
+        Py_DECREF(utf8);
+        if (!checkTaskCommand(commands.back().constData())) {
+            return NULL;
+        }
+    }
+
+    std::vector<QByteArray> results(commands.size());
+    {
+        PythonManager::ThreadReleaser releaser;
+        for (size_t i = 0; i < commands.size(); i++) {
+            results[i] = Core()->cmd(commands[i].constData()).toUtf8();
+        }
+    }
+
+    PyObject *list = PyList_New(count);
+    if (!list) {
+        return NULL;
+    }
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject *result = unicodeFromUtf8(results[i]);
+        if (!result) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SetItem(list, i, result);
+    }
+    return list;
+}
+
+PyObject *api_read(PyObject *self, PyObject *args)
+{
+    Q_UNUSED(self);
+    unsigned long long addr;
+    Py_ssize_t size;
+    if (!PyArg_ParseTuple(args, "Kn:read", &addr, &size)) {
+        return NULL;
+    }
+    if (size < 0) {
+        PyErr_SetString(PyExc_ValueError, "size must not be negative");
+        return NULL;
+    }
+    // rz_io_read_at takes an int length
+    if (size > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "size must not be larger than INT_MAX");
+        return NULL;
+    }
+    // Rizin reads right into the buffer of the new bytes object, which is shared by the view
+    PyObject *bytes = PyBytes_FromStringAndSize(NULL, size);
+    if (!bytes) {
+        return NULL;
+    }
+    auto buffer = reinterpret_cast<ut8 *>(PyBytes_AsString(bytes));
+    {
+        PythonManager::ThreadReleaser releaser;
+        RzCoreLocked core(Core());
+        if (size && !rz_io_read_at(core->io, addr, buffer, static_cast<int>(size))) {
+            memset(buffer, 0xff, size);
+        }
+    }
+    PyObject *view = PyMemoryView_FromObject(bytes);
+    Py_DECREF(bytes);
+    return view;
+}
+
+// Py_BuildValue expects unsigned long long for "K"
+static unsigned long long ull(RVA value)
+{
+    return value;
+}
+
+/**
+ * @brief Build a list of tuples from \a items, \a format is the Py_BuildValue format of a tuple
+ * and \a build calls Py_BuildValue with it for a single item.
+ */
+template<class T, class F>
+static PyObject *buildTupleList(const std::vector<T> &items, const char *format, F build)
+{
+    PyObject *list = PyList_New(static_cast<Py_ssize_t>(items.size()));
+    if (!list) {
+        return NULL;
+    }
+    for (size_t i = 0; i < items.size(); i++) {
+        PyObject *tuple = build(format, items[i]);
+        if (!tuple) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SetItem(list, static_cast<Py_ssize_t>(i), tuple);
+    }
+    return list;
+}
+
+PyObject *api_functions(PyObject *self, PyObject *args)
+{
+    Q_UNUSED(self);
+    Q_UNUSED(args);
+    struct Function
+    {
+        RVA offset;
+        RVA size;
+        RVA nbbs;
+        QByteArray name;
+    };
+    std::vector<Function> functions;
+    {
+        PythonManager::ThreadReleaser releaser;
+        RzCoreLocked core(Core());
+        functions.reserve(rz_list_length(core->analysis->fcns));
+        RzListIter *iter;
+        RzAnalysisFunction *fcn;
+        CutterRListForeach(core->analysis->fcns, iter, RzAnalysisFunction, fcn)
+        {
+            functions.push_back({ fcn->addr, rz_analysis_function_linear_size(fcn),
+                                  static_cast<RVA>(rz_list_length(fcn->bbs)),
+                                  QByteArray(fcn->name) });
+        }
     }
-    return PyUnicode_FromString(result);
+    return buildTupleList(functions, "(KKKs#)", [](const char *format, const Function &f) {
+        return Py_BuildValue(format, ull(f.offset), ull(f.size), ull(f.nbbs), f.name.constData(),
+                             static_cast<Py_ssize_t>(f.name.size()));
+    });
+}
+
+PyObject *api_basic_blocks(PyObject *self, PyObject *args)
+{
+    Q_UNUSED(self);
+    unsigned long long addr;
+    if (!PyArg_ParseTuple(args, "K:basic_blocks", &addr)) {
+        return NULL;
+    }
+    struct Block
+    {
+        RVA addr;
+        RVA size;
+        RVA jump;
+        RVA fail;
+    };
+    std::vector<Block> blocks;
+    {
+        PythonManager::ThreadReleaser releaser;
+        RzCoreLocked core(Core());
+        RzAnalysisFunction *fcn = rz_analysis_get_function_at(core->analysis, addr);
+        if (fcn) {
+            blocks.reserve(rz_list_length(fcn->bbs));
+            RzListIter *iter;
+            RzAnalysisBlock *bb;
+            CutterRListForeach(fcn->bbs, iter, RzAnalysisBlock, bb)
+            {
+                blocks.push_back({ bb->addr, bb->size, bb->jump, bb->fail });
+            }
+        }
+    }
+    return buildTupleList(blocks, "(KKKK)", [](const char *format, const Block &b) {
+        return Py_BuildValue(format, ull(b.addr), ull(b.size), ull(b.jump), ull(b.fail));
+    });
+}
+
+PyObject *api_xrefs(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    Q_UNUSED(self);
+    unsigned long long addr;
+    int to = 1;
+    static const char *kwlist[] = { "", "to", NULL };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "K|p", const_cast<char **>(kwlist), &addr,
+                                     &to)) {
+        return NULL;
+    }
+    struct Xref
+    {
+        RVA from;
+        RVA to;
+        QByteArray type;
+    };
+    std::vector<Xref> xrefs;
+    {
+        PythonManager::ThreadReleaser releaser;
+        for (const auto &xref : Core()->getXRefs(addr, to, false)) {
+            xrefs.push_back({ xref.from, xref.to, xref.type.toUtf8() });
+        }
+    }
+    return buildTupleList(xrefs, "(KKs)", [](const char *format, const Xref &x) {
+        return Py_BuildValue(format, ull(x.from), ull(x.to), x.type.constData());
+    });
+}
+
+PyObject *api_strings(PyObject *self, PyObject *args)
+{
+    Q_UNUSED(self);
+    Q_UNUSED(args);
+    struct String
+    {
+        RVA vaddr;
+        ut32 size;
+        QByteArray string;
+        QByteArray type;
+    };
+    std::vector<String> strings;
+    {
+        PythonManager::ThreadReleaser releaser;
+        const auto descriptions = Core()->getAllStrings();
+        strings.reserve(descriptions.size());
+        for (const auto &description : descriptions) {
+            strings.push_back({ description.vaddr, description.size,
+                                description.string.toUtf8(), description.type.toUtf8() });
+        }
+    }
+    return buildTupleList(strings, "(KIs#s)", [](const char *format, const String &s) {
+        return Py_BuildValue(format, ull(s.vaddr), s.size, s.string.constData(),
+                             static_cast<Py_ssize_t>(s.string.size()), s.type.constData());
+    });
 }
 
 PyObject *api_refresh(PyObject *self, PyObject *args)
@@ -50,9 +315,81 @@ PyObject *api_message(PyObject *self, PyObject *args, PyObject *kwargs)
     return Py_None;
 }
 
+PyObject *api_submit_task(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    Q_UNUSED(self);
+    PyObject *callable;
+    PyObject *callback = Py_None;
+    const char *title = "Python Task";
+    static const char *kwlist[] = { "", "callback", "title", NULL };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|Os", const_cast<char **>(kwlist), &callable,
+                                     &callback, &title)) {
+        return NULL;
+    }
+    if (!PyCallable_Check(callable) || (callback != Py_None && !PyCallable_Check(callback))) {
+        PyErr_SetString(PyExc_TypeError, "function and callback must be callable");
+        return NULL;
+    }
+    // The AsyncTaskManager and the result delivery belong to the GUI thread
+    if (QThread::currentThread() != Python()->thread()) {
+        PyErr_SetString(PyExc_RuntimeError, "submit_task must be called from the GUI thread");
+        return NULL;
+    }
+    AsyncTask::Ptr task(new PythonTask(callable, callback == Py_None ? nullptr : callback,
+                                       QString::fromUtf8(title)));
+    Core()->getAsyncTaskManager()->start(task);
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+PyObject *api_task_log(PyObject *self, PyObject *args)
+{
+    Q_UNUSED(self);
+    char *message;
+    if (!PyArg_ParseTuple(args, "s:message", &message)) {
+        return NULL;
+    }
+    PythonTask *task = PythonTask::current();
+    if (!task) {
+        PyErr_SetString(PyExc_RuntimeError, "not called from a task");
+        return NULL;
+    }
+    task->log(QString::fromUtf8(message));
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+PyObject *api_task_interrupted(PyObject *self, PyObject *args)
+{
+    Q_UNUSED(self);
+    Q_UNUSED(args);
+    PythonTask *task = PythonTask::current();
+    return PyBool_FromLong(task && task->isInterrupted());
+}
+
 PyMethodDef CutterMethods[] = {
     { "version", api_version, METH_NOARGS, "Returns Cutter current version" },
     { "cmd", api_cmd, METH_VARARGS, "Execute a command inside Cutter" },
+    { "cmd_batch", api_cmd_batch, METH_VARARGS,
+      "Execute a list of commands and return the list of their outputs" },
+    { "read", api_read, METH_VARARGS,
+      "read(addr, size) -> memoryview of size bytes read at addr, unmapped memory reads as 0xff" },
+    { "functions", api_functions, METH_NOARGS,
+      "Returns a list of (offset, size, nbbs, name) tuples of all functions" },
+    { "basic_blocks", api_basic_blocks, METH_VARARGS,
+      "basic_blocks(addr) -> list of (addr, size, jump, fail) tuples of the function at addr" },
+    { "xrefs", (PyCFunction)(void *)/* don't remove this double cast! */ api_xrefs,
+      METH_VARARGS | METH_KEYWORDS,
+      "xrefs(addr, to=True) -> list of (from, to, type) tuples of the references to or from addr" },
+    { "strings", api_strings, METH_NOARGS,
+      "Returns a list of (vaddr, size, string, type) tuples of all strings in the binary" },
+    { "submit_task", (PyCFunction)(void *)/* don't remove this double cast! */ api_submit_task,
+      METH_VARARGS | METH_KEYWORDS,
+      "submit_task(function, callback=None, title='Python Task') runs function() on a worker "
+      "thread, callback is called with its result in the GUI thread" },
+    { "task_log", api_task_log, METH_VARARGS, "Append a message to the log of the current task" },
+    { "task_interrupted", api_task_interrupted, METH_NOARGS,
+      "Returns True if the current task should stop" },
     { "refresh", api_refresh, METH_NOARGS, "Refresh Cutter widgets" },
     { "message", (PyCFunction)(void *)/* don't remove this double cast! */ api_message,
       METH_VARARGS | METH_KEYWORDS, "Print message" },
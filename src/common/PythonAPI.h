@@ -2,6 +2,7 @@
 #define PYTHONAPI_H
 
 #define Py_LIMITED_API 0x03050000
+#define PY_SSIZE_T_CLEAN
 #include <Python.h>
 
 PyObject *PyInit_api();
@@ -9,6 +9,7 @@
 #include <QDebug>
 #include <QCoreApplication>
 #include <QDir>
+#include <QThread>
 
 #ifdef CUTTER_ENABLE_PYTHON_BINDINGS
 #    include <shiboken.h>
@@ -180,3 +181,31 @@ void PythonManager::saveThread()
         pyThreadState = PyEval_SaveThread();
     }
 }
+
+PythonManager::ThreadReleaser::ThreadReleaser()
+{
+    auto manager = getInstance();
+    if (manager->thread() != QThread::currentThread()) {
+        // Only the GUI thread is tracked by the manager, e.g. PythonTask threads are not
+        savedCounter = -1;
+        savedThreadState = PyEval_SaveThread();
+        return;
+    }
+    savedCounter = manager->pyThreadStateCounter;
+    savedThreadState = manager->pyThreadState;
+    manager->pyThreadStateCounter = 0;
+    manager->pyThreadState = PyEval_SaveThread();
+}
+
+PythonManager::ThreadReleaser::~ThreadReleaser()
+{
+    if (savedCounter < 0) {
+        PyEval_RestoreThread(savedThreadState);
+        return;
+    }
+    auto manager = getInstance();
+    assert(manager->pyThreadStateCounter == 0);
+    PyEval_RestoreThread(manager->pyThreadState);
+    manager->pyThreadStateCounter = savedCounter;
+    manager->pyThreadState = savedThreadState;
+}
@@ -41,6 +41,24 @@ public:
         ~ThreadHolder() { getInstance()->saveThread(); }
     };
 
+    /**
+     * @brief RAII Helper class to release the Python thread while Cutter works on behalf of a
+     * Python call, so that other Python threads can run in the meantime.
+     *
+     * Must only be used while the calling thread holds the GIL. Code calling back into Python
+     * during that time uses ThreadHolder as usual.
+     */
+    class ThreadReleaser
+    {
+    public:
+        ThreadReleaser();
+        ~ThreadReleaser();
+
+    private:
+        int savedCounter;
+        PyThreadState *savedThreadState;
+    };
+
 signals:
     void willShutDown();
 
@@ -0,0 +1,87 @@
+#include "PythonAPI.h"
+#include "PythonManager.h"
+#include "PythonTask.h"
+
+#include <QDebug>
+
+static thread_local PythonTask *currentTask = nullptr;
+
+// How long quitting waits for a task that was interrupted
+static const int kShutdownTimeoutMs = 3000;
+
+PythonTask::PythonTask(PyObject *callable, PyObject *callback, const QString &title)
+    : callable(callable), callback(callback), title(title)
+{
+    Py_INCREF(callable);
+    Py_XINCREF(callback);
+    // The result is delivered in the thread the task object lives in
+    moveToThread(Python()->thread());
+    connect(this, &AsyncTask::finished, this, &PythonTask::deliverResult, Qt::QueuedConnection);
+    connect(Python(), &PythonManager::willShutDown, this, [this]() {
+        interrupt();
+        // A callable that never checks task_interrupted() must not keep Cutter from quitting
+        if (!wait(kShutdownTimeoutMs)) {
+            qWarning() << "Python task" << title << "is still running at shutdown, leaking it";
+            abandoned = true;
+            return;
+        }
+        // The event loop has ended, deliverResult() won't run and the task may outlive the
+        // interpreter in the AsyncTaskManager
+        PythonManager::ThreadHolder threadHolder;
+        releaseObjects();
+    });
+}
+
+PythonTask::~PythonTask()
+{
+    if (!abandoned && (callable || callback || result)) {
+        PythonManager::ThreadHolder threadHolder;
+        releaseObjects();
+    }
+}
+
+PythonTask *PythonTask::current()
+{
+    return currentTask;
+}
+
+void PythonTask::runTask()
+{
+    // Not started before shutdown, the interpreter may be gone already
+    if (isInterrupted()) {
+        return;
+    }
+    currentTask = this;
+    PyGILState_STATE gil = PyGILState_Ensure();
+    result = PyObject_CallObject(callable, nullptr);
+    if (!result) {
+        PyErr_Print();
+        log(tr("The task failed with an exception."));
+    }
+    PyGILState_Release(gil);
+    currentTask = nullptr;
+}
+
+void PythonTask::deliverResult()
+{
+    if (!callable) {
+        return;
+    }
+    PythonManager::ThreadHolder threadHolder;
+    if (callback && result && !isInterrupted()) {
+        PyObject *ret = PyObject_CallFunctionObjArgs(callback, result, nullptr);
+        if (ret) {
+            Py_DECREF(ret);
+        } else {
+            PyErr_Print();
+        }
+    }
+    releaseObjects();
+}
+
+void PythonTask::releaseObjects()
+{
+    Py_CLEAR(callable);
+    Py_CLEAR(callback);
+    Py_CLEAR(result);
+}
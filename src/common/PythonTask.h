@@ -0,0 +1,60 @@
+#ifndef PYTHONTASK_H
+#define PYTHONTASK_H
+
+#ifdef CUTTER_ENABLE_PYTHON
+
+#    include "common/AsyncTask.h"
+
+#    include <atomic>
+
+typedef struct _object PyObject;
+
+/**
+ * @brief Runs a Python callable submitted with cutter.submit_task() on a thread of the
+ * AsyncTaskManager.
+ *
+ * The callable gets the GIL only while it runs Python code, the functions of the cutter module
+ * release it while Cutter works. The return value is passed to the optional callback in the GUI
+ * thread.
+ */
+class PythonTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Takes new references to \a callable and \a callback, must be called with the GIL held.
+     * @param callback called with the result of \a callable in the GUI thread, may be nullptr
+     */
+    PythonTask(PyObject *callable, PyObject *callback, const QString &title);
+    ~PythonTask() override;
+
+    QString getTitle() override { return title; }
+
+    /**
+     * @brief The task which runs on the calling thread, nullptr outside of a PythonTask
+     */
+    static PythonTask *current();
+
+    using AsyncTask::log;
+
+protected:
+    void runTask() override;
+
+private:
+    PyObject *callable;
+    PyObject *callback;
+    PyObject *result = nullptr;
+    QString title;
+    /**
+     * @brief Still running when the interpreter shut down, its objects must not be released
+     */
+    std::atomic<bool> abandoned { false };
+
+    void deliverResult();
+    void releaseObjects();
+};
+
+#endif // CUTTER_ENABLE_PYTHON
+
+#endif // PYTHONTASK_H
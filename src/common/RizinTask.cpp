@@ -33,6 +33,7 @@ void RizinTask::taskFinished()
 
 RizinCmdTask::RizinCmdTask(const QString &cmd, bool transient)
 {
+    Core()->commandCount++;
     task = rz_core_cmd_task_new(
             Core()->core(), cmd.toLocal8Bit().constData(),
             static_cast<RzCoreCmdTaskFinished>(&RizinCmdTask::taskFinishedCallback), this);
@@ -0,0 +1,176 @@
+#include "StartupProfiler.h"
+#include "CutterConfig.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutexLocker>
+#include <QThread>
+
+#ifdef Q_OS_UNIX
+#    include <sys/resource.h>
+#endif
+
+static bool isMainThread()
+{
+    QCoreApplication *app = QCoreApplication::instance();
+    return !app || QThread::currentThread() == app->thread();
+}
+
+static double nsToMs(qint64 ns)
+{
+    return ns / 1e6;
+}
+
+qint64 StartupProfiler::peakRssKb()
+{
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#    ifdef Q_OS_MACOS
+        // Reported in bytes instead of kilobytes
+        return usage.ru_maxrss / 1024;
+#    else
+        return usage.ru_maxrss;
+#    endif
+    }
+#endif
+    return -1;
+}
+
+StartupProfiler::Phase::Phase(const QString &category, const QString &name)
+    : category(category), name(name), startNs(StartupProfiler::instance()->elapsedNs())
+{
+}
+
+StartupProfiler::Phase::~Phase()
+{
+    end();
+}
+
+double StartupProfiler::Phase::end()
+{
+    StartupProfiler *profiler = StartupProfiler::instance();
+    qint64 endNs = profiler->elapsedNs();
+    if (!ended) {
+        ended = true;
+        profiler->addPhase(category, name, startNs, endNs);
+    }
+    return nsToMs(endNs - startNs);
+}
+
+StartupProfiler::StartupProfiler()
+{
+    clock.start();
+}
+
+StartupProfiler *StartupProfiler::instance()
+{
+    static StartupProfiler profiler;
+    return &profiler;
+}
+
+void StartupProfiler::enable(const QString &reportPath)
+{
+    this->reportPath = reportPath;
+    enabled = true;
+    // Everything up to here ran before the command line was parsed
+    addPhase(QStringLiteral("startup"), QStringLiteral("preinit"), 0, elapsedNs());
+}
+
+void StartupProfiler::addPhase(const QString &category, const QString &name, qint64 startNs,
+                               qint64 endNs)
+{
+    if (!enabled) {
+        return;
+    }
+    QMutexLocker locker(&mutex);
+    phases.append({ category, name, startNs, endNs, isMainThread() });
+}
+
+void StartupProfiler::beginRefreshFanOut()
+{
+    if (!enabled) {
+        return;
+    }
+    refreshFanOuts++;
+    currentReceiver = QStringLiteral("(before docks)");
+    currentReceiverStartNs = elapsedNs();
+}
+
+void StartupProfiler::markRefreshReceiver(const QString &name)
+{
+    if (!enabled || currentReceiver.isNull()) {
+        return;
+    }
+    qint64 now = elapsedNs();
+    closeRefreshReceiver(now);
+    currentReceiver = name;
+    currentReceiverStartNs = now;
+}
+
+void StartupProfiler::endRefreshFanOut()
+{
+    if (!enabled || currentReceiver.isNull()) {
+        return;
+    }
+    closeRefreshReceiver(elapsedNs());
+    currentReceiver = QString();
+}
+
+void StartupProfiler::closeRefreshReceiver(qint64 now)
+{
+    addPhase(QStringLiteral("refreshAll#%1").arg(refreshFanOuts), currentReceiver,
+             currentReceiverStartNs, now);
+}
+
+QString StartupProfiler::finish()
+{
+    if (!enabled) {
+        return QString();
+    }
+    qint64 totalNs = elapsedNs();
+    enabled = false;
+
+    QMutexLocker locker(&mutex);
+    QJsonArray phaseArray;
+    QMap<QString, double> categoryTotals;
+    for (const PhaseRecord &phase : phases) {
+        double duration = nsToMs(phase.endNs - phase.startNs);
+        QJsonObject phaseObject;
+        phaseObject["category"] = phase.category;
+        phaseObject["name"] = phase.name;
+        phaseObject["startMs"] = nsToMs(phase.startNs);
+        phaseObject["durationMs"] = duration;
+        phaseObject["thread"] =
+                phase.mainThread ? QStringLiteral("main") : QStringLiteral("worker");
+        phaseArray.append(phaseObject);
+        categoryTotals[phase.category] += duration;
+    }
+
+    QJsonObject categoryObject;
+    for (auto it = categoryTotals.constBegin(); it != categoryTotals.constEnd(); ++it) {
+        categoryObject[it.key()] = it.value();
+    }
+
+    QJsonObject report;
+    report["cutterVersion"] = QStringLiteral(CUTTER_VERSION_FULL);
+    report["totalMs"] = nsToMs(totalNs);
+    qint64 rss = peakRssKb();
+    report["peakRssKb"] = rss >= 0 ? QJsonValue(static_cast<double>(rss)) : QJsonValue();
+    report["categories"] = categoryObject;
+    report["phases"] = phaseArray;
+    phases.clear();
+
+    QFile file(reportPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Cannot write startup profile to" << reportPath << file.errorString();
+        return QString();
+    }
+    file.write(QJsonDocument(report).toJson());
+    return reportPath;
+}
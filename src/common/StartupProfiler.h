@@ -0,0 +1,111 @@
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include "core/CutterCommon.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Collects wall clock timings of the phases between launch and a usable window.
+ *
+ * Covers application startup, loading the file, every analysis command and the refreshAll
+ * fan-out to the docks. Collection is only active when Cutter was started with
+ * --profile-startup, in that case finish() writes a JSON report once the file is opened. The
+ * report also contains the peak resident set size at that point.
+ * Phases may be recorded from any thread.
+ */
+class CUTTER_EXPORT StartupProfiler
+{
+public:
+    struct PhaseRecord
+    {
+        QString category;
+        QString name;
+        qint64 startNs;
+        qint64 endNs;
+        bool mainThread;
+    };
+
+    /**
+     * @brief Times a phase from construction until end() or destruction
+     */
+    class CUTTER_EXPORT Phase
+    {
+    public:
+        Phase(const QString &category, const QString &name);
+        ~Phase();
+
+        /**
+         * @brief Record the phase now instead of on destruction
+         * @return duration in milliseconds
+         */
+        double end();
+
+    private:
+        QString category;
+        QString name;
+        qint64 startNs;
+        bool ended = false;
+    };
+
+    /**
+     * @brief The first call starts the clock all phases are relative to
+     */
+    static StartupProfiler *instance();
+
+    /**
+     * @brief Start collecting phases, must be called before any other thread records one
+     * @param reportPath file the JSON report is written to by finish()
+     */
+    void enable(const QString &reportPath);
+    bool isEnabled() const { return enabled; }
+
+    qint64 elapsedNs() const { return clock.nsecsElapsed(); }
+
+    /**
+     * @brief Peak resident set size of the process so far
+     * @return size in KiB or -1 if it can't be determined on this platform
+     */
+    static qint64 peakRssKb();
+
+    void addPhase(const QString &category, const QString &name, qint64 startNs, qint64 endNs);
+
+    /**
+     * @brief Called around emitting CutterCore::refreshAll
+     *
+     * Every dock marks the moment the signal reaches it. The receivers run in connection order
+     * and a dock connects its marker before its own slots, so the time until the next marker is
+     * attributed to that dock. Slots of other objects connected in between are counted towards
+     * the preceding dock.
+     */
+    void beginRefreshFanOut();
+    void markRefreshReceiver(const QString &name);
+    void endRefreshFanOut();
+
+    /**
+     * @brief Stop collecting and write the report
+     * @return the report path or an empty string if profiling is disabled or writing failed
+     */
+    QString finish();
+
+private:
+    StartupProfiler();
+
+    QElapsedTimer clock;
+    bool enabled = false;
+    QString reportPath;
+
+    QMutex mutex;
+    QVector<PhaseRecord> phases;
+
+    int refreshFanOuts = 0;
+    QString currentReceiver;
+    qint64 currentReceiverStartNs = 0;
+
+    void closeRefreshReceiver(qint64 now);
+};
+
+#endif // STARTUPPROFILER_H
@@ -15,6 +15,7 @@
 #include "common/Configuration.h"
 #include "common/AsyncTask.h"
 #include "common/RizinTask.h"
+#include "common/StartupProfiler.h"
 #include "dialogs/RizinTaskDialog.h"
 #include "common/Json.h"
 #include "core/Cutter.h"
@@ -127,12 +128,43 @@ static QString fromOwnedCharPtr(char *str)
     return result;
 }
 
+static FlagDescription flagDescriptionFromItem(const RzFlagItem *item)
+{
+    FlagDescription flag;
+    flag.offset = item->offset;
+    flag.size = item->size;
+    flag.name = QString::fromUtf8(item->name);
+    flag.realname = item->realname ? QString::fromUtf8(item->realname) : QString();
+    flag.flagspace = item->space ? QString::fromUtf8(item->space->name) : QString();
+    return flag;
+}
+
+static FunctionDescription functionDescriptionFromFcn(RzCore *core, RzAnalysisFunction *fcn)
+{
+    FunctionDescription function;
+    function.offset = fcn->addr;
+    function.linearSize = rz_analysis_function_linear_size(fcn);
+    function.nargs = rz_analysis_var_count(core->analysis, fcn, 'b', 1)
+            + rz_analysis_var_count(core->analysis, fcn, 'r', 1)
+            + rz_analysis_var_count(core->analysis, fcn, 's', 1);
+    function.nlocals = rz_analysis_var_count(core->analysis, fcn, 'b', 0)
+            + rz_analysis_var_count(core->analysis, fcn, 'r', 0)
+            + rz_analysis_var_count(core->analysis, fcn, 's', 0);
+    function.nbbs = rz_list_length(fcn->bbs);
+    function.calltype = fcn->cc ? QString::fromUtf8(fcn->cc) : QString();
+    function.name = fcn->name ? QString::fromUtf8(fcn->name) : QString();
+    function.edges = rz_analysis_function_count_edges(fcn, nullptr);
+    function.stackframe = fcn->maxstack;
+    return function;
+}
+
 RzCoreLocked::RzCoreLocked(CutterCore *core) : core(core)
 {
     core->coreMutex.lock();
     assert(core->coreLockDepth >= 0);
     core->coreLockDepth++;
     if (core->coreLockDepth == 1) {
+        core->coreLockCount++;
         assert(core->coreBed);
         rz_cons_sleep_end(core->coreBed);
         core->coreBed = nullptr;
@@ -368,6 +400,7 @@ QString CutterCore::sanitizeStringForCommand(QString s)
 QString CutterCore::cmd(const char *str)
 {
     CORE_LOCK();
+    commandCount++;
 
     RVA offset = core->offset;
     char *res = rz_core_cmd_str(core, str);
@@ -465,6 +498,7 @@ QString CutterCore::cmdRaw(const char *cmd)
 {
     QString res;
     CORE_LOCK();
+    commandCount++;
     rz_cons_push();
 
     // rz_cmd_call does not return the output of the command
@@ -485,6 +519,7 @@ QJsonDocument CutterCore::cmdj(const char *str)
     char *res;
     {
         CORE_LOCK();
+        commandCount++;
         res = rz_core_cmd_str(core, str);
     }
 
@@ -687,19 +722,38 @@ bool CutterCore::mapFile(QString path, RVA mapaddr)
 void CutterCore::renameFunction(const RVA offset, const QString &newName)
 {
     cmdRaw("afn " + newName + " " + RAddressString(offset));
-    emit functionRenamed(offset, newName);
+    // Queued behind the signals of earlier changes, e.g. the function being added
+    queueFunctionSignal([this, offset, newName]() { emit functionRenamed(offset, newName); });
 }
 
 void CutterCore::delFunction(RVA addr)
 {
+    CORE_LOCK();
+    RzAnalysisFunction *fcn = rz_analysis_get_function_at(core->analysis, addr);
+    FunctionDescription function;
+    if (fcn) {
+        function = functionDescriptionFromFcn(core, fcn);
+    }
+    int countBefore = static_cast<int>(rz_list_length(core->analysis->fcns));
+
     cmdRaw("af- " + RAddressString(addr));
-    emit functionsChanged();
+
+    if (fcn && static_cast<int>(rz_list_length(core->analysis->fcns)) == countBefore - 1) {
+        queueFunctionSignal([this, function]() { emit functionRemoved(function); });
+    } else {
+        queueFunctionSignal([this]() { emit functionsChanged(); });
+    }
 }
 
 void CutterCore::renameFlag(QString old_name, QString new_name)
 {
+    CORE_LOCK();
     cmdRaw("fr " + old_name + " " + new_name);
-    emit flagsChanged();
+    if (rz_flag_get(core->flags, new_name.toUtf8().constData())) {
+        queueFlagSignal([this, old_name, new_name]() { emit flagRenamed(old_name, new_name); });
+    } else {
+        queueFlagSignal();
+    }
 }
 
 void CutterCore::renameFunctionVariable(QString newName, QString oldName, RVA functionAddress)
@@ -716,14 +770,35 @@ void CutterCore::renameFunctionVariable(QString newName, QString oldName, RVA fu
 
 void CutterCore::delFlag(RVA addr)
 {
+    CORE_LOCK();
+    QList<FlagDescription> flagsAt;
+    const RzList *items = rz_flag_get_list(core->flags, addr);
+    RzListIter *it;
+    RzFlagItem *item;
+    CutterRListForeach(items, it, RzFlagItem, item)
+    {
+        flagsAt.append(flagDescriptionFromItem(item));
+    }
+
     cmdRawAt("f-", addr);
-    emit flagsChanged();
+
+    for (const FlagDescription &flag : flagsAt) {
+        if (!rz_flag_get(core->flags, flag.name.toUtf8().constData())) {
+            queueFlagSignal([this, flag]() { emit flagRemoved(flag); });
+        }
+    }
 }
 
 void CutterCore::delFlag(const QString &name)
 {
+    CORE_LOCK();
+    RzFlagItem *item = rz_flag_get(core->flags, name.toUtf8().constData());
+    if (!item) {
+        return;
+    }
+    FlagDescription flag = flagDescriptionFromItem(item);
     cmdRaw("f-" + name);
-    emit flagsChanged();
+    queueFlagSignal([this, flag]() { emit flagRemoved(flag); });
 }
 
 QString CutterCore::getInstructionBytes(RVA addr)
@@ -1072,7 +1147,10 @@ QString CutterCore::getConfigDescription(const char *k)
 
 void CutterCore::triggerRefreshAll()
 {
+    StartupProfiler *profiler = StartupProfiler::instance();
+    profiler->beginRefreshFanOut();
     emit refreshAll();
+    profiler->endRefreshFanOut();
 }
 
 void CutterCore::triggerAsmOptionsChanged()
@@ -1247,20 +1325,41 @@ void CutterCore::cmdEsil(const char *command)
 
 QString CutterCore::createFunctionAt(RVA addr)
 {
+    CORE_LOCK();
+    int countBefore = static_cast<int>(rz_list_length(core->analysis->fcns));
     QString ret = cmdRaw(QString("af %1").arg(addr));
-    emit functionsChanged();
+    emitFunctionCreated(addr, countBefore);
     return ret;
 }
 
 QString CutterCore::createFunctionAt(RVA addr, QString name)
 {
+    CORE_LOCK();
     static const QRegularExpression regExp("[^a-zA-Z0-9_.]");
     name.remove(regExp);
+    int countBefore = static_cast<int>(rz_list_length(core->analysis->fcns));
     QString ret = cmdRawAt(QString("af %1").arg(name), addr);
-    emit functionsChanged();
+    emitFunctionCreated(addr, countBefore);
     return ret;
 }
 
+void CutterCore::emitFunctionCreated(RVA addr, int countBefore)
+{
+    CORE_LOCK();
+    int created = static_cast<int>(rz_list_length(core->analysis->fcns)) - countBefore;
+    if (created == 0) {
+        return;
+    }
+    RzAnalysisFunction *fcn = rz_analysis_get_function_at(core->analysis, addr);
+    if (created == 1 && fcn) {
+        FunctionDescription function = functionDescriptionFromFcn(core, fcn);
+        queueFunctionSignal([this, function]() { emit functionAdded(function); });
+    } else {
+        // The analysis also created callees or replaced existing functions
+        queueFunctionSignal([this]() { emit functionsChanged(); });
+    }
+}
+
 QJsonDocument CutterCore::getRegistersInfo()
 {
     return cmdj("aeafj");
@@ -1583,7 +1682,7 @@ QVector<Chunk> CutterCore::getHeapChunks(RVA arena_addr)
     {
         Chunk chunk;
         chunk.offset = data->addr;
-        chunk.size = (int)data->size;
+        chunk.size = data->size;
         chunk.status = QString(data->status);
         chunks_vector.append(chunk);
     }
@@ -1803,7 +1902,7 @@ void CutterCore::setCurrentDebugProcess(int pid)
         emit registersChanged();
         emit refreshCodeViews();
         emit stackChanged();
-        emit flagsChanged();
+        queueFlagSignal();
         syncAndSeekProgramCounter();
         emit switchedProcess();
         emit debugTaskStateChanged();
@@ -2819,21 +2918,7 @@ QList<FunctionDescription> CutterCore::getAllFunctions()
     RzAnalysisFunction *fcn;
     CutterRListForeach(core->analysis->fcns, iter, RzAnalysisFunction, fcn)
     {
-        FunctionDescription function;
-        function.offset = fcn->addr;
-        function.linearSize = rz_analysis_function_linear_size(fcn);
-        function.nargs = rz_analysis_var_count(core->analysis, fcn, 'b', 1)
-                + rz_analysis_var_count(core->analysis, fcn, 'r', 1)
-                + rz_analysis_var_count(core->analysis, fcn, 's', 1);
-        function.nlocals = rz_analysis_var_count(core->analysis, fcn, 'b', 0)
-                + rz_analysis_var_count(core->analysis, fcn, 'r', 0)
-                + rz_analysis_var_count(core->analysis, fcn, 's', 0);
-        function.nbbs = rz_list_length(fcn->bbs);
-        function.calltype = fcn->cc ? QString::fromUtf8(fcn->cc) : QString();
-        function.name = fcn->name ? QString::fromUtf8(fcn->name) : QString();
-        function.edges = rz_analysis_function_count_edges(fcn, nullptr);
-        function.stackframe = fcn->maxstack;
-        funcList.append(function);
+        funcList.append(functionDescriptionFromFcn(core, fcn));
     }
 
     return funcList;
@@ -3079,36 +3164,58 @@ QList<FlagspaceDescription> CutterCore::getAllFlagspaces()
 
 QList<FlagDescription> CutterCore::getAllFlags(QString flagspace)
 {
-    CORE_LOCK();
-    QList<FlagDescription> ret;
-
-    if (!flagspace.isEmpty())
-        cmdRaw("fs " + flagspace);
-    else
-        cmdRaw("fs *");
-
-    QJsonArray flagsArray = cmdj("fj").array();
-    for (const QJsonValue &value : flagsArray) {
-        QJsonObject flagObject = value.toObject();
-
-        FlagDescription flag;
+    return getFlags(flagspace);
+}
 
-        flag.offset = flagObject[RJsonKey::offset].toVariant().toULongLong();
-        flag.size = flagObject[RJsonKey::size].toVariant().toULongLong();
-        flag.name = flagObject[RJsonKey::name].toString();
-        flag.realname = flagObject[RJsonKey::realname].toString();
+QList<FlagDescription> CutterCore::getFlags(const QString &flagspace, RVA from, RVA to,
+                                            const QString &namePrefix)
+{
+    CORE_LOCK();
 
-        ret << flag;
+    struct FlagQuery
+    {
+        const RzSpace *space;
+        RVA from;
+        RVA to;
+        QByteArray prefix;
+        QList<FlagDescription> flags;
+    } query;
+
+    query.space = nullptr;
+    if (!flagspace.isEmpty()) {
+        query.space = rz_flag_space_get(core->flags, flagspace.toUtf8().constData());
+        if (!query.space) {
+            return {};
+        }
     }
-    return ret;
+    query.from = from;
+    query.to = to;
+    query.prefix = namePrefix.toUtf8();
+
+    rz_flag_foreach(
+            core->flags,
+            [](RzFlagItem *item, void *user) {
+                auto query = static_cast<FlagQuery *>(user);
+                if ((query->space && item->space != query->space) || item->offset < query->from
+                    || item->offset >= query->to
+                    || (!query->prefix.isEmpty()
+                        && !rz_str_startswith(item->name, query->prefix.constData()))) {
+                    return true;
+                }
+                query->flags.append(flagDescriptionFromItem(item));
+                return true;
+            },
+            &query);
+
+    return query.flags;
 }
 
-QList<SectionDescription> CutterCore::getAllSections()
+QList<SectionDescription> CutterCore::getAllSections(bool entropy)
 {
     CORE_LOCK();
     QList<SectionDescription> sections;
 
-    QJsonDocument sectionsDoc = cmdj("iSj entropy");
+    QJsonDocument sectionsDoc = cmdj(entropy ? "iSj entropy" : "iSj");
     QJsonObject sectionsObj = sectionsDoc.object();
     QJsonArray sectionsArray = sectionsObj[RJsonKey::sections].toArray();
 
@@ -3715,6 +3822,22 @@ QList<SearchDescription> CutterCore::getAllSearch(QString searchFor, QString spa
     return searchRef;
 }
 
+QList<QPair<RVA, RVA>> CutterCore::getSearchBoundaries(const QString &in)
+{
+    CORE_LOCK();
+    QList<QPair<RVA, RVA>> ranges;
+    RzList *boundaries =
+            rz_core_get_boundaries_prot(core, -1, in.toUtf8().constData(), "search");
+    RzListIter *it;
+    RzIOMap *map;
+    CutterRListForeach(boundaries, it, RzIOMap, map)
+    {
+        ranges.append({ map->itv.addr, map->itv.size });
+    }
+    rz_list_free(boundaries);
+    return ranges;
+}
+
 BlockStatistics CutterCore::getBlockStatistics(unsigned int blocksCount)
 {
     BlockStatistics blockStats;
@@ -3860,9 +3983,27 @@ QList<XrefDescription> CutterCore::getXRefs(RVA addr, bool to, bool whole_functi
 
 void CutterCore::addFlag(RVA offset, QString name, RVA size)
 {
+    CORE_LOCK();
     name = sanitizeStringForCommand(name);
+    QByteArray nameBytes = name.toUtf8();
+    RzFlagItem *item = rz_flag_get(core->flags, nameBytes.constData());
+    bool existed = item != nullptr;
+    FlagDescription oldFlag = existed ? flagDescriptionFromItem(item) : FlagDescription();
+
     cmdRawAt(QString("f %1 %2").arg(name).arg(size), offset);
-    emit flagsChanged();
+
+    item = rz_flag_get(core->flags, nameBytes.constData());
+    if (!item) {
+        // Rizin may have adjusted the name
+        queueFlagSignal();
+        return;
+    }
+    FlagDescription flag = flagDescriptionFromItem(item);
+    if (existed) {
+        queueFlagSignal([this, oldFlag, flag]() { emit flagChanged(oldFlag, flag); });
+    } else {
+        queueFlagSignal([this, flag]() { emit flagAdded(flag); });
+    }
 }
 
 /**
@@ -3934,6 +4075,44 @@ void CutterCore::handleREvent(int type, void *data)
 
 void CutterCore::triggerFlagsChanged()
 {
+    queueFlagSignal();
+}
+
+void CutterCore::queueFlagSignal(std::function<void()> signal)
+{
+    QMutexLocker locker(&flagSignalsMutex);
+    if (!signal) {
+        pendingFlagsReset = true;
+        pendingFlagSignals.clear();
+    } else if (!pendingFlagsReset) {
+        pendingFlagSignals.append(std::move(signal));
+    }
+    if (!flagSignalsQueued) {
+        // Emitted from the event loop, so receivers don't run while the core is locked and
+        // views refresh once for a batch of changes
+        flagSignalsQueued = true;
+        QMetaObject::invokeMethod(this, "emitFlagSignals", Qt::QueuedConnection);
+    }
+}
+
+void CutterCore::emitFlagSignals()
+{
+    QList<std::function<void()>> queued;
+    bool reset;
+    {
+        QMutexLocker locker(&flagSignalsMutex);
+        queued.swap(pendingFlagSignals);
+        reset = pendingFlagsReset;
+        pendingFlagsReset = false;
+        flagSignalsQueued = false;
+    }
+    if (reset) {
+        emit flagsReset();
+    } else {
+        for (const std::function<void()> &signal : queued) {
+            signal();
+        }
+    }
     emit flagsChanged();
 }
 
@@ -3944,7 +4123,43 @@ void CutterCore::triggerVarsChanged()
 
 void CutterCore::triggerFunctionRenamed(const RVA offset, const QString &newName)
 {
-    emit functionRenamed(offset, newName);
+    queueFunctionSignal([this, offset, newName]() { emit functionRenamed(offset, newName); });
+}
+
+void CutterCore::triggerFunctionChanged(RVA offset)
+{
+    CORE_LOCK();
+    RzAnalysisFunction *fcn = rz_analysis_get_function_at(core->analysis, offset);
+    if (fcn) {
+        FunctionDescription function = functionDescriptionFromFcn(core, fcn);
+        queueFunctionSignal([this, function]() { emit functionChanged(function); });
+    } else {
+        queueFunctionSignal([this]() { emit functionsChanged(); });
+    }
+}
+
+void CutterCore::queueFunctionSignal(std::function<void()> signal)
+{
+    QMutexLocker locker(&functionSignalsMutex);
+    pendingFunctionSignals.append(std::move(signal));
+    if (!functionSignalsQueued) {
+        // Like the flag signals, receivers must not run while the core is locked
+        functionSignalsQueued = true;
+        QMetaObject::invokeMethod(this, "emitFunctionSignals", Qt::QueuedConnection);
+    }
+}
+
+void CutterCore::emitFunctionSignals()
+{
+    QList<std::function<void()>> queued;
+    {
+        QMutexLocker locker(&functionSignalsMutex);
+        queued.swap(pendingFunctionSignals);
+        functionSignalsQueued = false;
+    }
+    for (const std::function<void()> &signal : queued) {
+        signal();
+    }
 }
 
 void CutterCore::loadPDB(const QString &file)
@@ -4086,6 +4301,13 @@ QJsonArray CutterCore::getOpenedFiles()
     return files.array();
 }
 
+QString CutterCore::getBinFilePath()
+{
+    CORE_LOCK();
+    RzBinFile *bf = rz_bin_cur(core->bin);
+    return bf && bf->file ? QString::fromUtf8(bf->file) : QString();
+}
+
 QList<QString> CutterCore::getColorThemes()
 {
     QList<QString> r;
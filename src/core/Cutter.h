@@ -29,6 +29,9 @@ class RizinTaskDialog;
 
 #include <rz_project.h>
 
+#include <atomic>
+#include <functional>
+
 #define Core() (CutterCore::instance())
 
 class RzCoreLocked;
@@ -39,6 +42,7 @@ class CUTTER_EXPORT CutterCore : public QObject
 
     friend class RzCoreLocked;
     friend class RizinTask;
+    friend class RizinCmdTask;
 
 public:
     explicit CutterCore(QObject *parent = nullptr);
@@ -54,6 +58,16 @@ public:
 
     RVA getOffset() const { return core_->offset; }
 
+    /**
+     * @brief Number of rizin commands run so far through cmd(), cmdRaw(), cmdj() and
+     * RizinCmdTask, used by the GUI benchmark
+     */
+    quint64 getCommandCount() const { return commandCount; }
+    /**
+     * @brief Number of times a thread took the core lock without holding it already
+     */
+    quint64 getCoreLockCount() const { return coreLockCount; }
+
     /* Core functions (commands) */
     static QString sanitizeStringForCommand(QString s);
     /**
@@ -279,6 +293,10 @@ public:
     bool mapFile(QString path, RVA mapaddr);
     void loadScript(const QString &scriptname);
     QJsonArray getOpenedFiles();
+    /**
+     * @brief Path of the file the current binary was loaded from
+     */
+    QString getBinFilePath();
 
     /* Seek functions */
     void seek(QString thing);
@@ -550,7 +568,19 @@ public:
     QList<StringDescription> getAllStrings();
     QList<FlagspaceDescription> getAllFlagspaces();
     QList<FlagDescription> getAllFlags(QString flagspace = QString());
-    QList<SectionDescription> getAllSections();
+    /**
+     * @brief Get flags matching the given filters without changing the selected flagspace
+     * @param flagspace only list flags of this flagspace, all flags if empty
+     * @param from only list flags at or after this offset
+     * @param to only list flags before this offset
+     * @param namePrefix only list flags whose name starts with this prefix
+     */
+    QList<FlagDescription> getFlags(const QString &flagspace = QString(), RVA from = 0,
+                                    RVA to = RVA_MAX, const QString &namePrefix = QString());
+    /**
+     * @param entropy compute the entropy of each section, which reads all of them
+     */
+    QList<SectionDescription> getAllSections(bool entropy = true);
     QList<SegmentDescription> getAllSegments();
     QList<EntrypointDescription> getAllEntrypoint();
     QList<BinClassDescription> getAllClassesFromBin();
@@ -617,6 +647,12 @@ public:
 
     QList<MemoryMapDescription> getMemoryMap();
     QList<SearchDescription> getAllSearch(QString searchFor, QString space, QString in);
+    /**
+     * @brief Get the address ranges covered by a search boundary
+     * @param in search.in mode, for example "io.maps" or "dbg.maps"
+     * @return list of (start address, size) pairs
+     */
+    QList<QPair<RVA, RVA>> getSearchBoundaries(const QString &in);
     BlockStatistics getBlockStatistics(unsigned int blocksCount);
     QList<BreakpointDescription> getBreakpoints();
     QList<ProcessDescription> getAllProcesses();
@@ -649,6 +685,11 @@ public:
     /* Signals related */
     void triggerVarsChanged();
     void triggerFunctionRenamed(const RVA offset, const QString &newName);
+    /**
+     * @brief Emit functionChanged for the function at \a offset after its properties were
+     * modified directly through the RzAnalysisFunction
+     */
+    void triggerFunctionChanged(RVA offset);
     void triggerRefreshAll();
     void triggerAsmOptionsChanged();
     void triggerGraphOptionsChanged();
@@ -699,8 +740,35 @@ signals:
 
     void functionRenamed(const RVA offset, const QString &new_name);
     void varsChanged();
+    /**
+     * @brief emitted when functions changed in a way not covered by functionAdded,
+     * functionRemoved, functionChanged and functionRenamed
+     */
     void functionsChanged();
+    void functionAdded(const FunctionDescription &function);
+    void functionRemoved(const FunctionDescription &function);
+    /**
+     * @brief emitted when properties of an existing function like its size, stack frame or
+     * calling convention changed
+     */
+    void functionChanged(const FunctionDescription &function);
+    /**
+     * @brief emitted once for all flag changes made until control returns to the event loop,
+     * after the signals of the single changes or flagsReset
+     */
     void flagsChanged();
+    /**
+     * @brief emitted when flags changed in a way not covered by flagAdded, flagRemoved,
+     * flagChanged and flagRenamed, lists of flags have to be reloaded
+     */
+    void flagsReset();
+    void flagAdded(const FlagDescription &flag);
+    void flagRemoved(const FlagDescription &flag);
+    /**
+     * @brief emitted when an existing flag was moved or resized by adding it again
+     */
+    void flagChanged(const FlagDescription &oldFlag, const FlagDescription &flag);
+    void flagRenamed(const QString &oldName, const QString &newName);
     void commentsChanged(RVA addr);
     void registersChanged();
     void instructionChanged(RVA offset);
@@ -772,6 +840,8 @@ private:
 #endif
     int coreLockDepth = 0;
     void *coreBed = nullptr;
+    std::atomic<quint64> commandCount { 0 };
+    std::atomic<quint64> coreLockCount { 0 };
 
     AsyncTaskManager *asyncTaskManager;
     RVA offsetPriorDebugging = RVA_INVALID;
@@ -787,7 +857,31 @@ private:
     QSharedPointer<RizinCmdTask> debugTask;
     RizinTaskDialog *debugTaskDialog;
 
+    /**
+     * Signals of flag changes, collected while the core is locked and emitted from the event loop
+     */
+    QMutex flagSignalsMutex;
+    QList<std::function<void()>> pendingFlagSignals;
+    bool pendingFlagsReset = false;
+    bool flagSignalsQueued = false;
+
+    /**
+     * Signals of function changes, built while the core is locked and emitted from the event loop
+     */
+    QMutex functionSignalsMutex;
+    QList<std::function<void()>> pendingFunctionSignals;
+    bool functionSignalsQueued = false;
+
     QVector<QString> getCutterRCFilePaths() const;
+    void emitFunctionCreated(RVA addr, int countBefore);
+    /**
+     * @brief Queue \a signal to be emitted together with flagsChanged, or flagsReset if \a signal
+     * is empty
+     */
+    void queueFlagSignal(std::function<void()> signal = nullptr);
+    Q_INVOKABLE void emitFlagSignals();
+    void queueFunctionSignal(std::function<void()> signal);
+    Q_INVOKABLE void emitFunctionSignals();
 };
 
 class CUTTER_EXPORT RzCoreLocked
@@ -131,6 +131,7 @@ struct FlagDescription
     RVA size;
     QString name;
     QString realname;
+    QString flagspace;
 };
 
 struct SectionDescription
@@ -368,7 +369,7 @@ struct Chunk
 {
     RVA offset;
     QString status;
-    int size;
+    ut64 size;
 };
 
 struct Arena
@@ -11,6 +11,9 @@
 #include "common/TempConfig.h"
 #include "common/RunScriptTask.h"
 #include "common/PythonManager.h"
+#include "common/StartupProfiler.h"
+#include "common/GuiBenchmark.h"
+#include "common/ProjectTask.h"
 #include "plugins/CutterPlugin.h"
 #include "plugins/PluginManager.h"
 #include "CutterConfig.h"
@@ -104,6 +107,7 @@
 #include <QStyledItemDelegate>
 #include <QStyleFactory>
 #include <QTextCursor>
+#include <QTimer>
 #include <QtGlobal>
 #include <QToolButton>
 #include <QToolTip>
@@ -117,6 +121,9 @@
 
 #define PROJECT_FILE_FILTER tr("Rizin Project (*.rzdb)")
 
+// How long an analysis with published intermediate results waits for the UI to fetch them
+static const int kMaxAnalysisPauseMs = 3000;
+
 template<class T>
 T *getNewInstance(MainWindow *m)
 {
@@ -199,9 +206,20 @@ void MainWindow::initUI()
     connect(core, &CutterCore::newMessage, this->consoleDock, &ConsoleWidget::addOutput);
     connect(core, &CutterCore::newDebugMessage, this->consoleDock, &ConsoleWidget::addDebugOutput);
 
+    // Flag completion for the omnibar doesn't depend on the Flags dock being constructed
+    connect(core, &CutterCore::refreshAll, this, &MainWindow::refreshOmniBarFlags);
+    connect(core, &CutterCore::flagsChanged, this, &MainWindow::refreshOmniBarFlags);
+    connect(core, &CutterCore::codeRebased, this, &MainWindow::refreshOmniBarFlags);
+
     connect(core, &CutterCore::showMemoryWidgetRequested, this,
             static_cast<void (MainWindow::*)()>(&MainWindow::showMemoryWidget));
 
+    autosaveTimer = new QTimer(this);
+    connect(autosaveTimer, &QTimer::timeout, this, &MainWindow::autosaveProject);
+    connect(Config(), &Configuration::projectAutosaveIntervalChanged, this,
+            &MainWindow::updateAutosaveTimer);
+    updateAutosaveTimer();
+
     updateTasksIndicator();
     connect(core->getAsyncTaskManager(), &AsyncTaskManager::tasksChanged, this,
             &MainWindow::updateTasksIndicator);
@@ -370,39 +388,85 @@ void MainWindow::initDocks()
 
     dashboardDock = new Dashboard(this);
     functionsDock = new FunctionsWidget(this);
-    typesDock = new TypesWidget(this);
-    searchDock = new SearchWidget(this);
-    commentsDock = new CommentsWidget(this);
-    stringsDock = new StringsWidget(this);
-
-    QList<CutterDockWidget *> debugDocks = { stackDock = new StackWidget(this),
-                                             threadsDock = new ThreadsWidget(this),
-                                             processesDock = new ProcessesWidget(this),
-                                             backtraceDock = new BacktraceWidget(this),
-                                             registersDock = new RegistersWidget(this),
-                                             memoryMapDock = new MemoryMapWidget(this),
-                                             breakpointDock = new BreakpointWidget(this),
-                                             registerRefsDock = new RegisterRefsWidget(this),
-                                             heapDock = new HeapDockWidget(this) };
+
+    // Docks which are hidden or tabbed away in the default layouts are only constructed once
+    // they become visible. The placeholders take their object name from the widget class and
+    // translate their title in its context, the last argument is the slot the dock normally runs
+    // on refreshAll.
+    addLazyDock<TypesWidget>(typesDock, QT_TRANSLATE_NOOP("TypesWidget", "Types"),
+                             "refreshTypes");
+    addLazyDock<SearchWidget>(searchDock, QT_TRANSLATE_NOOP("SearchWidget", "Search"),
+                              "refreshSearchspaces");
+    addLazyDock<CommentsWidget>(commentsDock, QT_TRANSLATE_NOOP("CommentsWidget", "Comments"),
+                                "refreshTree");
+    addLazyDock<StringsWidget>(stringsDock, QT_TRANSLATE_NOOP("StringsWidget", "Strings"),
+                               "refreshStrings");
+
+    QList<CutterDockWidget *> debugDocks = {
+        addLazyDock<StackWidget>(stackDock, QT_TRANSLATE_NOOP("StackWidget", "Stack"),
+                                 "updateContents"),
+        addLazyDock<ThreadsWidget>(threadsDock, QT_TRANSLATE_NOOP("ThreadsWidget", "Threads"),
+                                   "updateContents"),
+        addLazyDock<ProcessesWidget>(processesDock,
+                                     QT_TRANSLATE_NOOP("ProcessesWidget", "Processes"),
+                                     "updateContents"),
+        addLazyDock<BacktraceWidget>(backtraceDock,
+                                     QT_TRANSLATE_NOOP("BacktraceWidget", "Backtrace"),
+                                     "updateContents"),
+        addLazyDock<RegistersWidget>(registersDock,
+                                     QT_TRANSLATE_NOOP("RegistersWidget", "Registers"),
+                                     "updateContents"),
+        addLazyDock<MemoryMapWidget>(memoryMapDock,
+                                     QT_TRANSLATE_NOOP("MemoryMapWidget", "Memory Map"),
+                                     "refreshMemoryMap"),
+        addLazyDock<BreakpointWidget>(breakpointDock,
+                                      QT_TRANSLATE_NOOP("BreakpointWidget", "Breakpoints"),
+                                      "refreshBreakpoint"),
+        addLazyDock<RegisterRefsWidget>(
+                registerRefsDock,
+                QT_TRANSLATE_NOOP("RegisterRefsWidget", "Register References"),
+                "refreshRegisterRef"),
+        addLazyDock<HeapDockWidget>(heapDock, QT_TRANSLATE_NOOP("HeapDockWidget", "Heap"))
+    };
 
     QList<CutterDockWidget *> infoDocks = {
-        classesDock = new ClassesWidget(this),
-        entrypointDock = new EntrypointWidget(this),
-        exportsDock = new ExportsWidget(this),
-        flagsDock = new FlagsWidget(this),
-        headersDock = new HeadersWidget(this),
-        importsDock = new ImportsWidget(this),
-        relocsDock = new RelocsWidget(this),
-        resourcesDock = new ResourcesWidget(this),
-        sdbDock = new SdbWidget(this),
-        sectionsDock = new SectionsWidget(this),
-        segmentsDock = new SegmentsWidget(this),
-        symbolsDock = new SymbolsWidget(this),
-        vTablesDock = new VTablesWidget(this),
-        zignaturesDock = new ZignaturesWidget(this),
-        rzGraphDock = new RizinGraphWidget(this),
-        callGraphDock = new CallGraphWidget(this, false),
-        globalCallGraphDock = new CallGraphWidget(this, true),
+        addLazyDock<ClassesWidget>(classesDock, QT_TRANSLATE_NOOP("ClassesWidget", "Classes")),
+        addLazyDock<EntrypointWidget>(entrypointDock,
+                                      QT_TRANSLATE_NOOP("EntrypointWidget", "Entry Points"),
+                                      "fillEntrypoint"),
+        addLazyDock<ExportsWidget>(exportsDock, QT_TRANSLATE_NOOP("ExportsWidget", "Exports"),
+                                   "refreshExports"),
+        addLazyDock<FlagsWidget>(flagsDock, QT_TRANSLATE_NOOP("FlagsWidget", "Flags"),
+                                 "refreshFlagspaces"),
+        addLazyDock<HeadersWidget>(headersDock, QT_TRANSLATE_NOOP("HeadersWidget", "Headers"),
+                                   "refreshHeaders"),
+        addLazyDock<ImportsWidget>(importsDock, QT_TRANSLATE_NOOP("ImportsWidget", "Imports"),
+                                   "refreshImports"),
+        addLazyDock<RelocsWidget>(relocsDock, QT_TRANSLATE_NOOP("RelocsWidget", "Relocs"),
+                                  "refreshRelocs"),
+        addLazyDock<ResourcesWidget>(resourcesDock,
+                                     QT_TRANSLATE_NOOP("ResourcesWidget", "Resources"),
+                                     "refreshResources"),
+        addLazyDock<SdbWidget>(sdbDock, QT_TRANSLATE_NOOP("SdbWidget", "SDB Browser"), "reload"),
+        addLazyDock<SectionsWidget>(sectionsDock, QT_TRANSLATE_NOOP("SectionsWidget", "Sections"),
+                                    "refreshSections"),
+        addLazyDock<SegmentsWidget>(segmentsDock, QT_TRANSLATE_NOOP("SegmentsWidget", "Segments"),
+                                    "refreshSegments"),
+        addLazyDock<SymbolsWidget>(symbolsDock, QT_TRANSLATE_NOOP("SymbolsWidget", "Symbols"),
+                                   "refreshSymbols"),
+        addLazyDock<VTablesWidget>(vTablesDock, QT_TRANSLATE_NOOP("VTablesWidget", "&VTable"),
+                                   "refreshVTables"),
+        addLazyDock<ZignaturesWidget>(zignaturesDock,
+                                      QT_TRANSLATE_NOOP("ZignaturesWidget", "Zignatures"),
+                                      "refreshZignatures"),
+        addLazyDock<RizinGraphWidget>(rzGraphDock,
+                                      QT_TRANSLATE_NOOP("RizinGraphWidget", "Rizin graphs")),
+        addLazyDock(callGraphDock, "CallGraphWidget",
+                    QCoreApplication::translate("CallGraphWidget", "Callgraph"),
+                    [](MainWindow *main) { return new CallGraphWidget(main, false); }),
+        addLazyDock(globalCallGraphDock, "CallGraphWidget;0",
+                    QCoreApplication::translate("CallGraphWidget", "Global Callgraph"),
+                    [](MainWindow *main) { return new CallGraphWidget(main, true); }),
     };
 
     auto makeActionList = [this](QList<CutterDockWidget *> docks) {
@@ -441,6 +505,66 @@ void MainWindow::initDocks()
     }
 }
 
+template<class T>
+CutterDockWidget *MainWindow::addLazyDock(CutterDockWidget *&member, const char *title,
+                                          const char *refreshSlot)
+{
+    const char *className = T::staticMetaObject.className();
+    return addLazyDock(member, className, QCoreApplication::translate(className, title),
+                       getNewInstance<T>, refreshSlot);
+}
+
+CutterDockWidget *MainWindow::addLazyDock(CutterDockWidget *&member, const QString &name,
+                                          const QString &title, LazyDockWidget::Factory factory,
+                                          const char *refreshSlot)
+{
+    auto placeholder = new LazyDockWidget(this, name, title, factory, refreshSlot);
+    lazyDockMembers.insert(placeholder, &member);
+    // Queued, the dock layout must not be modified while it is processing a visibility change
+    connect(
+            placeholder, &CutterDockWidget::becameVisibleToUser, this,
+            [this, placeholder]() { materializeDock(placeholder); }, Qt::QueuedConnection);
+    member = placeholder;
+    return placeholder;
+}
+
+void MainWindow::materializeDock(LazyDockWidget *placeholder)
+{
+    auto it = lazyDockMembers.find(placeholder);
+    if (it == lazyDockMembers.end()) {
+        return;
+    }
+    CutterDockWidget **member = it.value();
+    lazyDockMembers.erase(it);
+
+    CutterDockWidget *dock = placeholder->createDock();
+    if (placeholder->isFloating()) {
+        addDockWidget(Qt::TopDockWidgetArea, dock);
+        dock->setFloating(true);
+        dock->setGeometry(placeholder->geometry());
+    } else {
+        tabifyDockWidget(placeholder, dock);
+    }
+
+    QAction *placeholderAction = placeholder->toggleViewAction();
+    for (QMenu *menu : { ui->menuWindows, ui->menuAddInfoWidgets, ui->menuAddDebugWidgets }) {
+        if (menu->actions().contains(placeholderAction)) {
+            dock->toggleViewAction()->setEnabled(placeholderAction->isEnabled());
+            menu->insertAction(placeholderAction, dock->toggleViewAction());
+            menu->removeAction(placeholderAction);
+        }
+    }
+
+    dockWidgets.replace(dockWidgets.indexOf(placeholder), dock);
+    *member = dock;
+
+    removeDockWidget(placeholder);
+    placeholder->deleteLater();
+
+    dock->show();
+    dock->raise();
+}
+
 void MainWindow::toggleOverview(bool visibility, GraphWidget *targetGraph)
 {
     if (!overviewDock) {
@@ -596,9 +720,7 @@ void MainWindow::displayInitialOptionsDialog(const InitialOptions &options, bool
 
     if (skipOptionsDialog) {
         if (!options.projectFile.isEmpty()) {
-            if (!openProject(options.projectFile)) {
-                displayNewFileDialog();
-            };
+            openProject(options.projectFile);
         } else {
             o->setupAndStartAnalysis();
         }
@@ -607,34 +729,140 @@ void MainWindow::displayInitialOptionsDialog(const InitialOptions &options, bool
     }
 }
 
-bool MainWindow::openProject(const QString &file)
+void MainWindow::followAnalysis(AnalTask *task, bool finalizeOnFirstResults)
 {
-    RzProjectErr err;
-    RzList *res = rz_list_new();
-    {
-        RzCoreLocked core(Core());
-        err = rz_project_load_file(core, file.toUtf8().constData(), true, res);
+    task->setPublishInterval(Config()->getAnalysisPublishInterval());
+    bool finalized = !finalizeOnFirstResults;
+    connect(task, &AnalTask::intermediateResultsAvailable, task,
+            [this, task, finalized](int step, int stepCount) mutable {
+                core->message(tr("Analysis step %1 of %2 done, showing intermediate results")
+                                      .arg(step)
+                                      .arg(stepCount));
+                setAnalysisStepRunning(false);
+                setEditingDisabled(true);
+                if (!finalized) {
+                    finalized = true;
+                    finalizeOpen();
+                } else {
+                    refreshAll();
+                }
+                resumeAnalysisWhenIdle(task);
+            });
+    connect(task, &AsyncTask::finished, this, [this]() {
+        setAnalysisStepRunning(false);
+        setEditingDisabled(false);
+    });
+}
+
+void MainWindow::setEditingDisabled(bool disabled)
+{
+    if (editingDisabled == disabled) {
+        return;
+    }
+    editingDisabled = disabled;
+    for (QAction *action : { ui->actionMap, ui->actionImportPDB, ui->actionAnalyze,
+                             ui->menuSetMode->menuAction(), ui->actionCommitChanges,
+                             ui->actionSave, ui->actionSaveAs, ui->actionRun_Script,
+                             ui->menuDebug->menuAction() }) {
+        action->setEnabled(!disabled);
     }
-    if (err != RZ_PROJECT_ERR_SUCCESS) {
-        const char *s = rz_project_err_message(err);
-        QString msg = tr("Failed to open project: %1").arg(QString::fromUtf8(s));
-        RzListIter *it;
-        CutterRListForeach(res, it, const char, s) { msg += "\n" + QString::fromUtf8(s); }
-        QMessageBox::critical(this, tr("Open Project"), msg);
-        rz_list_free(res);
-        return false;
+    consoleDock->setEnabled(!disabled);
+    if (disabled) {
+        core->message(tr("Editing is disabled until the analysis is done."));
+    }
+}
+
+void MainWindow::setAnalysisStepRunning(bool running)
+{
+    if (analysisStepRunning == running) {
+        return;
+    }
+    analysisStepRunning = running;
+    if (running) {
+        QApplication::setOverrideCursor(Qt::BusyCursor);
+    } else {
+        QApplication::restoreOverrideCursor();
     }
+}
+
+void MainWindow::resumeAnalysisWhenIdle(AnalTask *task)
+{
+    // Widgets fetch their data in background tasks, let those run on the paused core
+    // instead of waiting for the next analysis step. Tasks started later and long running ones,
+    // e.g. a search, must not stall the analysis.
+    AsyncTaskManager *manager = core->getAsyncTaskManager();
+    QList<AsyncTask *> pending;
+    for (const AsyncTask::Ptr &running : manager->getTasks()) {
+        if (running.data() != task) {
+            pending.append(running.data());
+        }
+    }
+    auto connection = QSharedPointer<QMetaObject::Connection>::create();
+    auto resume = [this, task, connection]() {
+        if (!*connection) {
+            return;
+        }
+        QObject::disconnect(*connection);
+        *connection = QMetaObject::Connection();
+        // The analysis may have been interrupted while paused
+        if (task->isRunning()) {
+            setAnalysisStepRunning(true);
+        }
+        task->resume();
+    };
+    auto resumeIfDone = [manager, pending, resume]() {
+        for (const AsyncTask::Ptr &running : manager->getTasks()) {
+            if (pending.contains(running.data())) {
+                return;
+            }
+        }
+        resume();
+    };
+    *connection = connect(manager, &AsyncTaskManager::tasksChanged, task, resumeIfDone);
+    QTimer::singleShot(kMaxAnalysisPauseMs, task, resume);
+    resumeIfDone();
+}
+
+void MainWindow::openProject(const QString &file, const std::function<void(bool)> &finished)
+{
+    auto *task = new ProjectLoadTask(file);
+    AsyncTask::Ptr taskPtr(task);
+
+    connect(task, &AsyncTask::finished, this, [this, task, finished]() {
+        RzProjectErr err = task->getError();
+        if (err != RZ_PROJECT_ERR_SUCCESS) {
+            const char *s = rz_project_err_message(err);
+            QString msg = tr("Failed to open project: %1").arg(QString::fromUtf8(s));
+            for (const QString &message : task->getMessages()) {
+                msg += "\n" + message;
+            }
+            QMessageBox::critical(this, tr("Open Project"), msg);
+            if (finished) {
+                finished(false);
+            } else {
+                displayNewFileDialog();
+            }
+            return;
+        }
 
-    Config()->addRecentProject(file);
+        if (finished) {
+            finished(true);
+        }
+        Config()->addRecentProject(task->getFile());
+        setFilename(task->getFile().trimmed());
+        finalizeOpen();
+    });
+
+    auto *taskDialog = new AsyncTaskDialog(taskPtr);
+    taskDialog->setAttribute(Qt::WA_DeleteOnClose);
+    taskDialog->show();
 
-    rz_list_free(res);
-    setFilename(file.trimmed());
-    finalizeOpen();
-    return true;
+    core->getAsyncTaskManager()->start(taskPtr);
 }
 
 void MainWindow::finalizeOpen()
 {
+    StartupProfiler::Phase phase("fileOpen", "finalizeOpen");
     core->getOpcodes();
     core->updateSeek();
     refreshAll();
@@ -684,25 +912,36 @@ void MainWindow::finalizeOpen()
             // continue looping in case there is a graph widget
         }
     }
+
+    phase.end();
+    StartupProfiler *profiler = StartupProfiler::instance();
+    double startupMs = profiler->elapsedNs() / 1e6;
+    QString profilePath = profiler->finish();
+    if (!profilePath.isEmpty()) {
+        core->message(tr("Startup profile written to %1: ready after %2 ms, peak RSS %3 KiB")
+                              .arg(profilePath)
+                              .arg(startupMs, 0, 'f', 1)
+                              .arg(StartupProfiler::peakRssKb()));
+    }
+
+    if (GuiBenchmark::instance()->isEnabled()) {
+        QTimer::singleShot(0, this, [this]() { GuiBenchmark::instance()->run(this); });
+    }
 }
 
-RzProjectErr MainWindow::saveProject(bool *canceled)
+RzProjectErr MainWindow::saveProject(bool *canceled, bool wait)
 {
     QString file = core->getConfig("prj.file");
     if (file.isEmpty()) {
-        return saveProjectAs(canceled);
+        return saveProjectAs(canceled, wait);
     }
     if (canceled) {
         *canceled = false;
     }
-    RzProjectErr err = rz_project_save_file(RzCoreLocked(core), file.toUtf8().constData());
-    if (err == RZ_PROJECT_ERR_SUCCESS) {
-        Config()->addRecentProject(file);
-    }
-    return err;
+    return saveProjectFile(file, wait);
 }
 
-RzProjectErr MainWindow::saveProjectAs(bool *canceled)
+RzProjectErr MainWindow::saveProjectAs(bool *canceled, bool wait)
 {
     QString projectFile = core->getConfig("prj.file");
     if (projectFile.isEmpty()) {
@@ -724,11 +963,69 @@ RzProjectErr MainWindow::saveProjectAs(bool *canceled)
     if (canceled) {
         *canceled = false;
     }
-    RzProjectErr err = rz_project_save_file(RzCoreLocked(core), file.toUtf8().constData());
-    if (err == RZ_PROJECT_ERR_SUCCESS) {
-        Config()->addRecentProject(file);
+    return saveProjectFile(file, wait);
+}
+
+RzProjectErr MainWindow::saveProjectFile(const QString &file, bool wait, bool quiet)
+{
+    auto *task = new ProjectSaveTask(file);
+    projectSaveTask = AsyncTask::Ptr(task);
+
+    if (wait) {
+        // The save still runs in the background, the modal dialog keeps the window painted
+        // while it blocks any other interaction
+        AsyncTaskDialog taskDialog(projectSaveTask, this);
+        taskDialog.setModal(true);
+        core->getAsyncTaskManager()->start(projectSaveTask);
+        taskDialog.exec();
+        task->wait();
+        if (task->getError() == RZ_PROJECT_ERR_SUCCESS) {
+            Config()->addRecentProject(file);
+        }
+        return task->getError();
     }
-    return err;
+
+    connect(task, &AsyncTask::finished, this, [this, task, quiet]() {
+        RzProjectErr err = task->getError();
+        if (err == RZ_PROJECT_ERR_SUCCESS) {
+            if (!quiet) {
+                Config()->addRecentProject(task->getFile());
+            }
+        } else if (quiet) {
+            core->message(tr("Failed to save project: %1")
+                                  .arg(QString::fromUtf8(rz_project_err_message(err))));
+        } else {
+            showProjectSaveError(err);
+        }
+    });
+
+    if (!quiet) {
+        auto *taskDialog = new AsyncTaskDialog(projectSaveTask);
+        taskDialog->setAttribute(Qt::WA_DeleteOnClose);
+        taskDialog->show();
+    }
+
+    core->getAsyncTaskManager()->start(projectSaveTask);
+    return RZ_PROJECT_ERR_SUCCESS;
+}
+
+void MainWindow::updateAutosaveTimer()
+{
+    int autosaveInterval = Config()->getProjectAutosaveInterval();
+    if (autosaveInterval > 0) {
+        autosaveTimer->start(autosaveInterval * 60 * 1000);
+    } else {
+        autosaveTimer->stop();
+    }
+}
+
+void MainWindow::autosaveProject()
+{
+    QString file = core->getConfig("prj.file");
+    if (file.isEmpty() || (projectSaveTask && projectSaveTask->isRunning())) {
+        return;
+    }
+    saveProjectFile(file, false, true);
 }
 
 void MainWindow::showProjectSaveError(RzProjectErr err)
@@ -746,6 +1043,15 @@ void MainWindow::refreshOmniBar(const QStringList &flags)
     omnibar->refresh(flags);
 }
 
+void MainWindow::refreshOmniBarFlags()
+{
+    QStringList flagNames;
+    for (const FlagDescription &flag : Core()->getFlags()) {
+        flagNames.append(flag.name);
+    }
+    refreshOmniBar(flagNames);
+}
+
 void MainWindow::setFilename(const QString &fn)
 {
     // Add file name to window title
@@ -776,7 +1082,7 @@ void MainWindow::closeEvent(QCloseEvent *event)
 
     if (ret == QMessageBox::Save) {
         bool canceled;
-        RzProjectErr save_err = saveProject(&canceled);
+        RzProjectErr save_err = saveProject(&canceled, true);
         if (canceled) {
             event->ignore();
             return;
@@ -1279,6 +1585,11 @@ void MainWindow::showDebugDocks()
     }
     functionDockWidthToRestore = functionsDock->maximumWidth();
     functionsDock->setMaximumWidth(200);
+    if (auto placeholder = qobject_cast<LazyDockWidget *>(registersDock)) {
+        // The size constraints have to be set on the real dock, not on the placeholder it
+        // would replace only after the layout has been applied
+        materializeDock(placeholder);
+    }
     auto registerWidth = qhelpers::forceWidth(registersDock, std::min(500, this->width() / 4));
     auto registerHeight = qhelpers::forceHeight(registersDock, std::max(100, height() / 2));
     QDockWidget *widgetToFocus = nullptr;
@@ -1650,6 +1961,7 @@ void MainWindow::on_actionAnalyze_triggered()
     taskDialog->setInterruptOnClose(true);
     taskDialog->setAttribute(Qt::WA_DeleteOnClose);
     taskDialog->show();
+    followAnalysis(analTask, false);
     connect(analTask, &AnalTask::finished, this, &MainWindow::refreshAll);
 
     Core()->getAsyncTaskManager()->start(analTaskPtr);
@@ -1777,8 +2089,19 @@ void MainWindow::mousePressEvent(QMouseEvent *event)
     }
 }
 
-bool MainWindow::eventFilter(QObject *, QEvent *event)
+bool MainWindow::eventFilter(QObject *object, QEvent *event)
 {
+    if (editingDisabled) {
+        // The actions of context menus, e.g. rename or add comment, belong to the menu
+        if (event->type() == QEvent::ContextMenu) {
+            auto widget = qobject_cast<QWidget *>(object);
+            if (widget && widget->window() == this) {
+                return true;
+            }
+        } else if (event->type() == QEvent::Shortcut && qobject_cast<QMenu *>(object->parent())) {
+            return true;
+        }
+    }
     if (event->type() == QEvent::MouseButtonPress) {
         QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
         if (mouseEvent->button() == Qt::ForwardButton || mouseEvent->button() == Qt::BackButton) {
@@ -8,12 +8,16 @@
 #include "common/InitialOptions.h"
 #include "common/IOModesController.h"
 #include "common/CutterLayout.h"
+#include "common/AsyncTask.h"
 #include "MemoryDockWidget.h"
+#include "widgets/LazyDockWidget.h"
 
+#include <functional>
 #include <memory>
 
 #include <QMainWindow>
 #include <QList>
+#include <QHash>
 
 class CutterCore;
 class Omnibar;
@@ -55,6 +59,8 @@ class OverviewWidget;
 class RizinGraphWidget;
 class CallGraphWidget;
 class HeapWidget;
+class AnalTask;
+class QTimer;
 
 namespace Ui {
 class MainWindow;
@@ -74,10 +80,24 @@ public:
     void displayNewFileDialog();
     void displayWelcomeDialog();
     void closeNewFileDialog();
-    bool openProject(const QString &project_name);
+    /**
+     * @brief Load \a project_name in the background and show the window once it is loaded
+     */
+    /**
+     * @brief Load \a project_name in the background and show the window once it is loaded
+     * @param finished called with whether loading succeeded. Without it, the new file dialog is
+     * shown again when loading fails.
+     */
+    void openProject(const QString &project_name,
+                     const std::function<void(bool)> &finished = nullptr);
 
-    RzProjectErr saveProject(bool *canceled);
-    RzProjectErr saveProjectAs(bool *canceled);
+    /**
+     * @brief Save the project in the background
+     * @param wait block until the project is written, otherwise errors are reported when the
+     * background save fails and the return value only covers starting it
+     */
+    RzProjectErr saveProject(bool *canceled, bool wait = false);
+    RzProjectErr saveProjectAs(bool *canceled, bool wait = false);
     void showProjectSaveError(RzProjectErr err);
 
     void closeEvent(QCloseEvent *event) override;
@@ -130,6 +150,13 @@ public:
      */
     QMenu *getContextMenuExtensions(ContextMenuType type);
 
+    /**
+     * @brief Refresh the UI whenever \a task publishes intermediate results
+     * @param finalizeOnFirstResults show the main window with the first results, when \a task
+     * analyzes a newly opened file
+     */
+    void followAnalysis(AnalTask *task, bool finalizeOnFirstResults);
+
 public slots:
     void finalizeOpen();
 
@@ -220,6 +247,8 @@ private:
     ProgressIndicator *tasksProgressIndicator;
     QByteArray emptyState;
     IOModesController ioModesController;
+    AsyncTask::Ptr projectSaveTask;
+    QTimer *autosaveTimer = nullptr;
 
     Configuration *configuration;
 
@@ -227,27 +256,27 @@ private:
     QList<CutterDockWidget *> pluginDocks;
     OverviewWidget *overviewDock = nullptr;
     QAction *actionOverview = nullptr;
-    EntrypointWidget *entrypointDock = nullptr;
+    CutterDockWidget *entrypointDock = nullptr;
     FunctionsWidget *functionsDock = nullptr;
-    ImportsWidget *importsDock = nullptr;
-    ExportsWidget *exportsDock = nullptr;
-    HeadersWidget *headersDock = nullptr;
-    TypesWidget *typesDock = nullptr;
-    SearchWidget *searchDock = nullptr;
-    SymbolsWidget *symbolsDock = nullptr;
-    RelocsWidget *relocsDock = nullptr;
-    CommentsWidget *commentsDock = nullptr;
-    StringsWidget *stringsDock = nullptr;
-    FlagsWidget *flagsDock = nullptr;
+    CutterDockWidget *importsDock = nullptr;
+    CutterDockWidget *exportsDock = nullptr;
+    CutterDockWidget *headersDock = nullptr;
+    CutterDockWidget *typesDock = nullptr;
+    CutterDockWidget *searchDock = nullptr;
+    CutterDockWidget *symbolsDock = nullptr;
+    CutterDockWidget *relocsDock = nullptr;
+    CutterDockWidget *commentsDock = nullptr;
+    CutterDockWidget *stringsDock = nullptr;
+    CutterDockWidget *flagsDock = nullptr;
     Dashboard *dashboardDock = nullptr;
-    SdbWidget *sdbDock = nullptr;
-    SectionsWidget *sectionsDock = nullptr;
-    SegmentsWidget *segmentsDock = nullptr;
-    ZignaturesWidget *zignaturesDock = nullptr;
+    CutterDockWidget *sdbDock = nullptr;
+    CutterDockWidget *sectionsDock = nullptr;
+    CutterDockWidget *segmentsDock = nullptr;
+    CutterDockWidget *zignaturesDock = nullptr;
     ConsoleWidget *consoleDock = nullptr;
-    ClassesWidget *classesDock = nullptr;
-    ResourcesWidget *resourcesDock = nullptr;
-    VTablesWidget *vTablesDock = nullptr;
+    CutterDockWidget *classesDock = nullptr;
+    CutterDockWidget *resourcesDock = nullptr;
+    CutterDockWidget *vTablesDock = nullptr;
     CutterDockWidget *stackDock = nullptr;
     CutterDockWidget *threadsDock = nullptr;
     CutterDockWidget *processesDock = nullptr;
@@ -257,10 +286,15 @@ private:
     NewFileDialog *newFileDialog = nullptr;
     CutterDockWidget *breakpointDock = nullptr;
     CutterDockWidget *registerRefsDock = nullptr;
-    RizinGraphWidget *rzGraphDock = nullptr;
-    CallGraphWidget *callGraphDock = nullptr;
-    CallGraphWidget *globalCallGraphDock = nullptr;
+    CutterDockWidget *rzGraphDock = nullptr;
+    CutterDockWidget *callGraphDock = nullptr;
+    CutterDockWidget *globalCallGraphDock = nullptr;
     CutterDockWidget *heapDock = nullptr;
+    /**
+     * Placeholders of docks which haven't been constructed yet, mapped to the member pointing
+     * to them
+     */
+    QHash<LazyDockWidget *, CutterDockWidget **> lazyDockMembers;
 
     QMenu *disassemblyContextMenuExtensions = nullptr;
     QMenu *addressableContextMenuExtensions = nullptr;
@@ -270,6 +304,47 @@ private:
     void initUI();
     void initToolBar();
     void initDocks();
+    CutterDockWidget *addLazyDock(CutterDockWidget *&member, const QString &name,
+                                  const QString &title, LazyDockWidget::Factory factory,
+                                  const char *refreshSlot = nullptr);
+    /**
+     * @brief Add a placeholder for a dock of type \a T named after its class
+     * @param title untranslated title, translated in the context of \a T
+     */
+    template<class T>
+    CutterDockWidget *addLazyDock(CutterDockWidget *&member, const char *title,
+                                  const char *refreshSlot = nullptr);
+    /**
+     * @brief Replace \a placeholder with the real dock, keeping its place in the layout
+     */
+    void materializeDock(LazyDockWidget *placeholder);
+    void refreshOmniBarFlags();
+    /**
+     * @brief Save to \a file with a ProjectSaveTask
+     * @param quiet don't show a progress dialog and only report errors in the console
+     */
+    RzProjectErr saveProjectFile(const QString &file, bool wait, bool quiet = false);
+    void updateAutosaveTimer();
+    void autosaveProject();
+    /**
+     * @brief Resume \a task once the tasks running now, i.e. the fetches started by refreshing the
+     * UI, are done, but keep it paused for a few seconds at most
+     */
+    void resumeAnalysisWhenIdle(AnalTask *task);
+    /**
+     * @brief Disable editing while an analysis with published intermediate results continues
+     *
+     * Disables the actions that change the core and swallows context menus and their shortcuts,
+     * which is where the widgets offer editing.
+     */
+    void setEditingDisabled(bool disabled);
+    bool editingDisabled = false;
+    /**
+     * @brief Show a busy cursor while an analysis step holds the core, views that query it
+     * directly don't respond until the step is done
+     */
+    void setAnalysisStepRunning(bool running);
+    bool analysisStepRunning = false;
     void initBackForwardMenu();
     void displayInitialOptionsDialog(const InitialOptions &options = InitialOptions(),
                                      bool skipOptionsDialog = false);
@@ -167,6 +167,9 @@ void InitialOptionsDialog::loadOptions(const InitialOptions &options)
 
     ui->analSlider->setValue(analLevel);
 
+    ui->analysisCacheCheckBox->setChecked(options.useAnalysisCache
+                                          || Config()->getAnalysisCacheEnabled());
+
     shellcode = options.shellcode;
 
     if (!options.forceBinPlugin.isEmpty()) {
@@ -275,6 +278,8 @@ void InitialOptionsDialog::setupAndStartAnalysis(/*int level, QList<QString> adv
         options.forceBinPlugin = pluginDesc.name;
     }
     options.demangle = ui->demangleCheckBox->isChecked();
+    options.useAnalysisCache = ui->analysisCacheCheckBox->isChecked();
+    Config()->setAnalysisCacheEnabled(options.useAnalysisCache);
     if (ui->pdbCheckBox->isChecked()) {
         options.pdbFile = ui->pdbLineEdit->text();
     }
@@ -305,11 +310,17 @@ void InitialOptionsDialog::setupAndStartAnalysis(/*int level, QList<QString> adv
 
     MainWindow *main = this->main;
     connect(analTask, &AnalTask::openFileFailed, main, &MainWindow::openNewFileFailed);
+    main->followAnalysis(analTask, true);
     connect(analTask, &AsyncTask::finished, main, [analTask, main]() {
         if (analTask->getOpenFileFailed()) {
             return;
         }
-        main->finalizeOpen();
+        if (analTask->getResultsPublished()) {
+            // The window was already shown with intermediate results
+            main->refreshAll();
+        } else {
+            main->finalizeOpen();
+        }
     });
 
     AsyncTask::Ptr analTaskPtr(analTask);
@@ -9,6 +9,7 @@
 #include <QFileDialog>
 #include <QtGui>
 #include <QMessageBox>
+#include <QPointer>
 #include <QDir>
 #include <QPushButton>
 #include <QLineEdit>
@@ -346,10 +347,22 @@ void NewFileDialog::loadFile(const QString &filename)
 void NewFileDialog::loadProject(const QString &project)
 {
     MainWindow *main = new MainWindow();
-    if (!main->openProject(project)) {
-        return;
-    }
-    close();
+    // Stay open while the project is loaded, so another one can be picked if loading fails
+    setEnabled(false);
+    QPointer<NewFileDialog> dialog(this);
+    main->openProject(project, [dialog, main](bool success) {
+        if (!success) {
+            main->deleteLater();
+        }
+        if (!dialog) {
+            return;
+        }
+        if (success) {
+            dialog->close();
+        } else {
+            dialog->setEnabled(true);
+        }
+    });
 }
 
 void NewFileDialog::loadShellcode(const QString &shellcode, const int size)
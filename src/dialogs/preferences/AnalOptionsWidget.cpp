@@ -52,6 +52,10 @@ AnalOptionsWidget::AnalOptionsWidget(PreferencesDialog *dialog)
     connect(ui->preludeLineEdit, &QLineEdit::textChanged, this,
             &AnalOptionsWidget::updateAnalPrelude);
     updateAnalOptionsFromVars();
+
+    ui->projectAutosaveSpinBox->setValue(Config()->getProjectAutosaveInterval());
+    connect<void (QSpinBox::*)(int)>(ui->projectAutosaveSpinBox, &QSpinBox::valueChanged,
+                                     Config(), &Configuration::setProjectAutosaveInterval);
 }
 
 AnalOptionsWidget::~AnalOptionsWidget() {}
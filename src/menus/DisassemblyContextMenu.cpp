@@ -1034,11 +1034,16 @@ void DisassemblyContextMenu::on_actionEditFunction_triggered()
             QString new_name = dialog.getNameText();
             Core()->renameFunction(fcn->addr, new_name);
             QString new_start_addr = dialog.getStartAddrText();
+            RVA old_addr = fcn->addr;
             fcn->addr = Core()->math(new_start_addr);
             QString new_stack_size = dialog.getStackSizeText();
             fcn->stack = int(Core()->math(new_stack_size));
             Core()->cmdRaw("afc " + dialog.getCallConSelected());
-            emit Core()->functionsChanged();
+            if (fcn->addr == old_addr) {
+                Core()->triggerFunctionChanged(fcn->addr);
+            } else {
+                emit Core()->functionsChanged();
+            }
         }
     }
 }
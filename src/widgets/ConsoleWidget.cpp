@@ -8,6 +8,9 @@
 #include <QSettings>
 #include <QDir>
 #include <QUuid>
+#include <QInputDialog>
+#include <QTextBlock>
+#include <QRegularExpression>
 #include <iostream>
 #include "core/Cutter.h"
 #include "ConsoleWidget.h"
@@ -38,6 +41,44 @@ static const int invalidHistoryPos = -1;
 
 static const char *consoleWrapSettingsKey = "console.wrap";
 
+// Color sequences older than this are dropped from the state carried to the next line, later
+// ones override them in most cases
+static const int maxAnsiStateSequences = 8;
+
+/**
+ * @brief Updates \a state, the SGR sequences still active after \a text was printed
+ *
+ * Lines are converted to HTML one by one, so the sequences active at the start of a line have
+ * to be prepended to it to keep colors which span several lines.
+ */
+static void updateAnsiState(const QString &text, QStringList *state)
+{
+    static const QRegularExpression sgr(QStringLiteral("\x1b\\[([0-9;]*)m"));
+    QRegularExpressionMatchIterator it = sgr.globalMatch(text);
+    while (it.hasNext()) {
+        QRegularExpressionMatch match = it.next();
+        QString params = match.captured(1);
+        if (params.isEmpty() || params == QLatin1String("0")) {
+            state->clear();
+            continue;
+        }
+        if (params.startsWith(QLatin1String("0;"))) {
+            state->clear();
+            state->append(QStringLiteral("\x1b[") + params.mid(2) + QLatin1Char('m'));
+        } else {
+            state->append(match.captured(0));
+        }
+        while (state->size() > maxAnsiStateSequences) {
+            state->removeFirst();
+        }
+    }
+}
+
+// Output is inserted at most once per frame and this many lines at a time,
+// the rest is kept for the following frames so the UI stays responsive
+static const int outputFlushInterval = 16;
+static const int maxLinesPerFlush = 2000;
+
 ConsoleWidget::ConsoleWidget(MainWindow *main)
     : CutterDockWidget(main),
       ui(new Ui::ConsoleWidget),
@@ -72,8 +113,13 @@ ConsoleWidget::ConsoleWidget(MainWindow *main)
         }
     });
 
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(outputFlushInterval);
+    connect(&flushTimer, &QTimer::timeout, this, &ConsoleWidget::flushPendingOutput);
+    setScrollback(Config()->getConsoleScrollback());
+
     QAction *actionClear = new QAction(tr("Clear Output"), this);
-    connect(actionClear, &QAction::triggered, ui->outputTextEdit, &QPlainTextEdit::clear);
+    connect(actionClear, &QAction::triggered, this, &ConsoleWidget::clearOutput);
     addAction(actionClear);
 
     // Ctrl+l to clear the output
@@ -87,6 +133,19 @@ ConsoleWidget::ConsoleWidget(MainWindow *main)
     connect(actionWrapLines, &QAction::triggered, this, [this](bool checked) { setWrap(checked); });
     actions.append(actionWrapLines);
 
+    QAction *actionScrollback = new QAction(tr("Set Scrollback Limit..."), ui->outputTextEdit);
+    connect(actionScrollback, &QAction::triggered, this, [this]() {
+        bool ok;
+        int lines = QInputDialog::getInt(this, tr("Scrollback Limit"),
+                                         tr("Number of lines to keep:"),
+                                         Config()->getConsoleScrollback(), 100, 10000000, 1000, &ok);
+        if (ok) {
+            Config()->setConsoleScrollback(lines);
+            setScrollback(lines);
+        }
+    });
+    actions.append(actionScrollback);
+
     // Completion
     completionActive = false;
     completer = new QCompleter(&completionModel, this);
@@ -187,18 +246,68 @@ void ConsoleWidget::setupFont()
 
 void ConsoleWidget::addOutput(const QString &msg)
 {
-    ui->outputTextEdit->appendPlainText(msg);
-    scrollOutputToEnd();
+    queueOutput(msg, OutputFormat::Plain);
 }
 
 void ConsoleWidget::addDebugOutput(const QString &msg)
 {
     if (debugOutputEnabled) {
-        ui->outputTextEdit->appendHtml("<font color=\"red\"> [DEBUG]:\t" + msg + "</font>");
-        scrollOutputToEnd();
+        queueOutput("<font color=\"red\"> [DEBUG]:\t" + msg + "</font>", OutputFormat::Html);
+    }
+}
+
+void ConsoleWidget::queueOutput(const QString &text, OutputFormat format)
+{
+    pendingOutput.append({ text, format });
+    if (!flushTimer.isActive()) {
+        flushTimer.start();
     }
 }
 
+void ConsoleWidget::flushPendingOutput()
+{
+    QTextDocument *document = ui->outputTextEdit->document();
+    QTextCursor cursor(document);
+    cursor.movePosition(QTextCursor::End);
+    cursor.beginEditBlock();
+    for (int i = 0; i < maxLinesPerFlush && !pendingOutput.isEmpty(); i++) {
+        PendingLine line = pendingOutput.takeFirst();
+        if (!document->isEmpty()) {
+            cursor.insertBlock(QTextBlockFormat(), QTextCharFormat());
+        }
+        switch (line.format) {
+        case OutputFormat::Plain:
+            cursor.insertText(line.text);
+            break;
+        case OutputFormat::Ansi:
+            cursor.insertHtml(CutterCore::ansiEscapeToHtml(line.text));
+            break;
+        case OutputFormat::Html:
+            cursor.insertHtml(line.text);
+            break;
+        }
+    }
+    cursor.endEditBlock();
+    scrollOutputToEnd();
+
+    if (!pendingOutput.isEmpty()) {
+        flushTimer.start();
+    }
+}
+
+void ConsoleWidget::clearOutput()
+{
+    pendingOutput.clear();
+    ui->outputTextEdit->clear();
+}
+
+void ConsoleWidget::setScrollback(int lines)
+{
+    // Keeping more pending lines than fit into the scrollback would be wasted work
+    pendingOutput.setCapacity(lines);
+    ui->outputTextEdit->setMaximumBlockCount(lines);
+}
+
 void ConsoleWidget::focusInputLineEdit()
 {
     ui->rzInputLineEdit->setFocus();
@@ -228,11 +337,18 @@ void ConsoleWidget::executeCommand(const QString &command)
 
     RVA oldOffset = Core()->getOffset();
     commandTask = QSharedPointer<CommandTask>(
-            new CommandTask(command, CommandTask::ColorMode::MODE_256, true));
+            new CommandTask(command, CommandTask::ColorMode::MODE_256, false));
     connect(commandTask.data(), &CommandTask::finished, this,
             [this, cmd_line, command, oldOffset](const QString &result) {
-                ui->outputTextEdit->appendHtml(result);
-                scrollOutputToEnd();
+                QString output = result;
+                if (output.endsWith(QLatin1Char('\n'))) {
+                    output.chop(1);
+                }
+                QStringList ansiState;
+                for (const QString &line : output.split(QLatin1Char('\n'))) {
+                    queueOutput(ansiState.join(QString()) + line, OutputFormat::Ansi);
+                    updateAnsiState(line, &ansiState);
+                }
                 historyAdd(command);
                 commandTask.clear();
                 ui->rzInputLineEdit->setEnabled(true);
@@ -427,10 +543,11 @@ void ConsoleWidget::processQueuedOutput()
         fprintf(origStderr, "%s", output.toStdString().c_str());
 
         // Get the last segment that wasn't overwritten by carriage return
-        output = output.trimmed();
-        output = output.remove(0, output.lastIndexOf('\r')).trimmed();
-        ui->outputTextEdit->appendHtml(CutterCore::ansiEscapeToHtml(output));
-        scrollOutputToEnd();
+        QString line = output.trimmed();
+        line = line.remove(0, line.lastIndexOf('\r')).trimmed();
+        queueOutput(pipeAnsiState.join(QString()) + line, OutputFormat::Ansi);
+        // From the shown text only, so the state matches what the console displays
+        updateAnsiState(line, &pipeAnsiState);
     }
 }
 
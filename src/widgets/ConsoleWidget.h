@@ -9,6 +9,8 @@
 #include <QStringListModel>
 #include <QSocketNotifier>
 #include <QLocalSocket>
+#include <QContiguousCache>
+#include <QTimer>
 
 #include <memory>
 
@@ -67,7 +69,27 @@ private slots:
      */
     void processQueuedOutput();
 
+    /**
+     * @brief Inserts lines queued by queueOutput into the output view
+     */
+    void flushPendingOutput();
+
+    void setScrollback(int lines);
+
 private:
+    enum class OutputFormat { Plain, Ansi, Html };
+    struct PendingLine
+    {
+        QString text;
+        OutputFormat format;
+    };
+
+    /**
+     * @brief Queues a line for display. Lines are inserted in batches once per frame,
+     * lines which are pushed out of the scrollback before that are never colorized.
+     */
+    void queueOutput(const QString &text, OutputFormat format);
+    void clearOutput();
     void scrollOutputToEnd();
     void historyAdd(const QString &input);
     void invalidateHistoryPosition();
@@ -96,6 +118,12 @@ private:
     QCompleter *completer;
     QShortcut *historyUpShortcut;
     QShortcut *historyDownShortcut;
+    QContiguousCache<PendingLine> pendingOutput;
+    /**
+     * @brief SGR sequences still active at the end of the output read from the pipe so far
+     */
+    QStringList pipeAnsiState;
+    QTimer flushTimer;
     FILE *origStderr = nullptr;
     FILE *origStdout = nullptr;
     FILE *origStdin = nullptr;
@@ -1,5 +1,6 @@
 #include "CutterDockWidget.h"
 #include "core/MainWindow.h"
+#include "common/StartupProfiler.h"
 
 #include <QEvent>
 #include <QShortcut>
@@ -12,6 +13,11 @@ CutterDockWidget::CutterDockWidget(MainWindow *parent) : QDockWidget(parent), ma
     installEventFilter(this);
     updateIsVisibleToUser();
     connect(toggleViewAction(), &QAction::triggered, this, &QWidget::raise);
+    if (StartupProfiler::instance()->isEnabled()) {
+        // Connected before the slots of the subclass, see StartupProfiler::beginRefreshFanOut
+        connect(Core(), &CutterCore::refreshAll, this,
+                [this]() { StartupProfiler::instance()->markRefreshReceiver(objectName()); });
+    }
 }
 
 CutterDockWidget::~CutterDockWidget() = default;
@@ -164,6 +164,7 @@ void CutterGraphView::updateColors()
     backgroundColor = ConfigColor("gui.background");
     disassemblySelectionColor = ConfigColor("lineHighlight");
     PCSelectionColor = ConfigColor("highlightPC");
+    mBreakpointColor = ConfigColor("gui.breakpoint_background");
 
     jmpColor = ConfigColor("graph.trufae");
     brtrueColor = ConfigColor("graph.true");
@@ -174,6 +175,7 @@ void CutterGraphView::updateColors()
 
 void CutterGraphView::colorsUpdatedSlot()
 {
+    setCacheDirty();
     updateColors();
     refreshView();
 }
@@ -192,7 +194,7 @@ GraphLayout::LayoutConfig CutterGraphView::getLayoutConfig()
 
 void CutterGraphView::updateLayout()
 {
-    setGraphLayout(GraphView::makeGraphLayout(graphLayout, horizontalLayoutAction->isChecked()));
+    setGraphLayout(graphLayout, horizontalLayoutAction->isChecked());
     saveCurrentBlock();
     setLayoutConfig(getLayoutConfig());
     computeGraphPlacement();
@@ -202,6 +204,7 @@ void CutterGraphView::updateLayout()
 
 void CutterGraphView::fontsUpdatedSlot()
 {
+    setCacheDirty();
     initFont();
     refreshView();
 }
@@ -244,6 +247,15 @@ void CutterGraphView::refreshView()
 {
     initFont();
     setLayoutConfig(getLayoutConfig());
+    setCacheDirty();
+    viewport()->update();
+}
+
+void CutterGraphView::drawBlockOverview(QPainter &p, GraphView::GraphBlock &block, bool)
+{
+    p.setPen(QPen(graphNodeColor, 0));
+    p.setBrush(disassemblyBackgroundColor);
+    p.drawRect(QRectF(block.x, block.y, block.width, block.height));
 }
 
 bool CutterGraphView::gestureEvent(QGestureEvent *event)
@@ -103,6 +103,7 @@ protected:
     void wheelEvent(QWheelEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
     bool gestureEvent(QGestureEvent *event) override;
+    void drawBlockOverview(QPainter &p, GraphView::GraphBlock &block, bool interactive) override;
 
     /**
      * @brief Save the the currently viewed or displayed block.
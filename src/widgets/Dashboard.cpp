@@ -4,6 +4,7 @@
 #include "common/JsonModel.h"
 #include "common/JsonTreeItem.h"
 #include "common/TempConfig.h"
+#include "common/FileDigestTask.h"
 #include "dialogs/VersionInfoDialog.h"
 
 #include "core/MainWindow.h"
@@ -15,6 +16,7 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QFile>
+#include <QFileInfo>
 #include <QLayoutItem>
 #include <QString>
 #include <QMessageBox>
@@ -30,6 +32,74 @@ Dashboard::Dashboard(MainWindow *main) : CutterDockWidget(main), ui(new Ui::Dash
 
 Dashboard::~Dashboard() {}
 
+void Dashboard::updateDigest()
+{
+    // Delete hashesWidget if it isn't null to avoid duplicate components
+    if (hashesWidget) {
+        hashesWidget->deleteLater();
+    }
+
+    // Define dynamic components to hold the hashes
+    hashesWidget = new QWidget();
+    QFormLayout *hashesLayout = new QFormLayout;
+    hashesWidget->setLayout(hashesLayout);
+    ui->hashesVerticalLayout->addWidget(hashesWidget);
+
+    // Add hashes as a pair of Hash Name : Hash Value.
+    auto addRow = [hashesLayout](const QString &name, const QString &value) {
+        // Define a Read-Only line edit to display the hash value
+        QLineEdit *hashLineEdit = new QLineEdit();
+        hashLineEdit->setReadOnly(true);
+        hashLineEdit->setText(value);
+
+        // Set cursor position to begining to avoid long hashes (e.g sha256)
+        // to look truncated at the begining
+        hashLineEdit->setCursorPosition(0);
+
+        // Add both controls to a form layout in a single row
+        hashesLayout->addRow(new QLabel(QString("<b>%1:</b>").arg(name)), hashLineEdit);
+        return hashLineEdit;
+    };
+
+    QString path = Core()->getBinFilePath();
+    if (!QFileInfo(path).isFile()) {
+        // Not a local file, let rizin read it through io
+        QJsonObject hashes = Core()->cmdj("itj").object();
+        for (const QString &key : hashes.keys()) {
+            addRow(key.toUpper(), hashes.value(key).toString());
+        }
+
+        TempConfig tempConfig;
+        tempConfig.set("io.va", false);
+        // Calculate the Entropy of the entire binary from offset 0 to $s
+        // where $s is the size of the entire file
+        addRow(tr("Entropy"), Core()->cmdRawAt("ph entropy $s", 0).trimmed());
+        return;
+    }
+
+    QList<QLineEdit *> digestEdits;
+    for (const QString &name : { QString("MD5"), QString("SHA1"), QString("SHA256"),
+                                 QString("CRC32"), tr("Entropy") }) {
+        digestEdits.append(addRow(name, tr("Computing...")));
+    }
+    auto showDigest = [digestEdits](const FileDigest &digest) {
+        QStringList values = { QString::fromLatin1(digest.md5), QString::fromLatin1(digest.sha1),
+                               QString::fromLatin1(digest.sha256),
+                               QString("%1").arg(digest.crc32, 8, 16, QLatin1Char('0')),
+                               QString::number(digest.entropy, 'f', 8) };
+        for (int i = 0; i < digestEdits.size(); i++) {
+            digestEdits[i]->setText(values[i]);
+            digestEdits[i]->setCursorPosition(0);
+        }
+    };
+
+    // The request ends when hashesWidget is replaced
+    FileDigest digest;
+    if (FileDigestTask::request(path, hashesWidget, showDigest, &digest)) {
+        showDigest(digest);
+    }
+}
+
 void Dashboard::updateContents()
 {
     QJsonDocument docu = Core()->getFileInfo();
@@ -75,54 +145,7 @@ void Dashboard::updateContents()
     setBool(this->ui->relocsEdit, item2, "relocs");
 
     // Add file hashes, analysis info and libraries
-
-    QJsonObject hashes = Core()->cmdj("itj").object();
-
-    // Delete hashesWidget if it isn't null to avoid duplicate components
-    if (hashesWidget) {
-        hashesWidget->deleteLater();
-    }
-
-    // Define dynamic components to hold the hashes
-    hashesWidget = new QWidget();
-    QFormLayout *hashesLayout = new QFormLayout;
-    hashesWidget->setLayout(hashesLayout);
-    ui->hashesVerticalLayout->addWidget(hashesWidget);
-
-    // Add hashes as a pair of Hash Name : Hash Value.
-    for (const QString &key : hashes.keys()) {
-        // Create a bold QString with the hash name uppercased
-        QString label = QString("<b>%1:</b>").arg(key.toUpper());
-
-        // Define a Read-Only line edit to display the hash value
-        QLineEdit *hashLineEdit = new QLineEdit();
-        hashLineEdit->setReadOnly(true);
-        hashLineEdit->setText(hashes.value(key).toString());
-
-        // Set cursor position to begining to avoid long hashes (e.g sha256)
-        // to look truncated at the begining
-        hashLineEdit->setCursorPosition(0);
-
-        // Add both controls to a form layout in a single row
-        hashesLayout->addRow(new QLabel(label), hashLineEdit);
-    }
-
-    // Add the Entropy value of the file to the dashboard
-    {
-        // Scope for TempConfig
-        TempConfig tempConfig;
-        tempConfig.set("io.va", false);
-
-        // Calculate the Entropy of the entire binary from offset 0 to $s
-        // where $s is the size of the entire file
-        QString entropy = Core()->cmdRawAt("ph entropy $s", 0).trimmed();
-
-        // Define a Read-Only line edit to display the entropy value
-        QLineEdit *entropyLineEdit = new QLineEdit();
-        entropyLineEdit->setReadOnly(true);
-        entropyLineEdit->setText(entropy);
-        hashesLayout->addRow(new QLabel(tr("<b>Entropy:</b>")), entropyLineEdit);
-    }
+    updateDigest();
 
     QJsonObject analinfo = Core()->cmdj("aaij").object();
     setPlainText(ui->functionsLineEdit, QString::number(analinfo["fcns"].toInt()));
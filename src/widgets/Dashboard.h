@@ -33,6 +33,10 @@ private:
     std::unique_ptr<Ui::Dashboard> ui;
     void setPlainText(QLineEdit *textBox, const QString &text);
     void setBool(QLineEdit *textBox, const QJsonObject &jsonObject, const QString &key);
+    /**
+     * @brief Show the hashes and entropy of the file, computed in the background
+     */
+    void updateDigest();
 
     QWidget *hashesWidget = nullptr;
 };
@@ -90,6 +90,11 @@ DecompilerWidget::DecompilerWidget(MainWindow *main)
     connect(Core(), &CutterCore::functionRenamed, this, &DecompilerWidget::doRefresh);
     connect(Core(), &CutterCore::varsChanged, this, &DecompilerWidget::doRefresh);
     connect(Core(), &CutterCore::functionsChanged, this, &DecompilerWidget::doRefresh);
+    connect(Core(), &CutterCore::functionAdded, this, &DecompilerWidget::refreshIfFunctionShown);
+    connect(Core(), &CutterCore::functionRemoved, this,
+            &DecompilerWidget::refreshIfFunctionShown);
+    connect(Core(), &CutterCore::functionChanged, this,
+            &DecompilerWidget::refreshIfFunctionShown);
     connect(Core(), &CutterCore::flagsChanged, this, &DecompilerWidget::doRefresh);
     connect(Core(), &CutterCore::commentsChanged, this, &DecompilerWidget::refreshIfChanged);
     connect(Core(), &CutterCore::instructionChanged, this, &DecompilerWidget::refreshIfChanged);
@@ -224,6 +229,13 @@ void DecompilerWidget::refreshIfChanged(RVA addr)
     }
 }
 
+void DecompilerWidget::refreshIfFunctionShown(const FunctionDescription &function)
+{
+    if (function.offset == decompiledFunctionAddr || function.contains(seekable->getOffset())) {
+        doRefresh();
+    }
+}
+
 void DecompilerWidget::doRefresh()
 {
     RVA addr = seekable->getOffset();
@@ -103,6 +103,10 @@ private:
      * @param addr Address at which a change occurred.
      */
     void refreshIfChanged(RVA addr);
+    /**
+     * @brief Refresh if \a function is the decompiled one or contains the seek
+     */
+    void refreshIfFunctionShown(const FunctionDescription &function);
     /**
      * @brief Refreshes the decompiler.
      *
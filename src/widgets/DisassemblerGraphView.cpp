@@ -50,8 +50,22 @@ DisassemblerGraphView::DisassemblerGraphView(QWidget *parent, CutterSeekable *se
     connect(Core(), &CutterCore::instructionChanged, this, &DisassemblerGraphView::refreshView);
     connect(Core(), &CutterCore::breakpointsChanged, this, &DisassemblerGraphView::refreshView);
     connect(Core(), &CutterCore::functionsChanged, this, &DisassemblerGraphView::refreshView);
+    // Other functions don't change the graph
+    auto refreshIfFunctionShown = [this](const FunctionDescription &function) {
+        if (function.offset == currentFcnAddr || function.contains(seekable->getOffset())) {
+            refreshView();
+        }
+    };
+    connect(Core(), &CutterCore::functionAdded, this, refreshIfFunctionShown);
+    connect(Core(), &CutterCore::functionRemoved, this, refreshIfFunctionShown);
+    connect(Core(), &CutterCore::functionChanged, this, refreshIfFunctionShown);
     connect(Core(), &CutterCore::asmOptionsChanged, this, &DisassemblerGraphView::refreshView);
     connect(Core(), &CutterCore::refreshCodeViews, this, &DisassemblerGraphView::refreshView);
+    // The program counter is highlighted
+    connect(Core(), &CutterCore::registersChanged, this, [this]() {
+        setCacheDirty();
+        viewport()->update();
+    });
 
     connectSeekChanged(false);
 
@@ -185,6 +199,7 @@ void DisassemblerGraphView::loadCurrentGraph()
 
     disassembly_blocks.clear();
     blocks.clear();
+    breakpoints = Core()->getBreakpointsAddresses();
 
     if (highlight_token) {
         delete highlight_token;
@@ -223,6 +238,8 @@ void DisassemblerGraphView::loadCurrentGraph()
     RVA entry = func["offset"].toVariant().toULongLong();
 
     setEntry(entry);
+    const bool showEntryOffset = Config()->getGraphBlockEntryOffset();
+    const int offsetColor = Config()->colorId("offset");
     for (const QJsonValueRef &value : func["blocks"].toArray()) {
         QJsonObject block = value.toObject();
         RVA block_entry = block["offset"].toVariant().toULongLong();
@@ -234,10 +251,10 @@ void DisassemblerGraphView::loadCurrentGraph()
         GraphBlock gb;
         gb.entry = block_entry;
         db.entry = block_entry;
-        if (Config()->getGraphBlockEntryOffset()) {
+        if (showEntryOffset) {
             // QColor(0,0,0,0) is transparent
-            db.header_text = Text("[" + RAddressString(db.entry) + "]", ConfigColor("offset"),
-                                  QColor(0, 0, 0, 0));
+            db.header_text = Text("[" + RAddressString(db.entry) + "]",
+                                  Config()->getColor(offsetColor), QColor(0, 0, 0, 0));
         }
         db.true_path = RVA_INVALID;
         db.false_path = RVA_INVALID;
@@ -362,8 +379,6 @@ void DisassemblerGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block,
     p.setFont(Config()->getFont());
     p.drawRect(blockRect);
 
-    breakpoints = Core()->getBreakpointsAddresses();
-
     // Render node
     DisassemblyBlock &db = disassembly_blocks[block.entry];
     bool block_selected = false;
@@ -475,7 +490,7 @@ void DisassemblerGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block,
 
         QColor instrColor;
         if (Core()->isBreakpoint(breakpoints, instr.addr)) {
-            instrColor = ConfigColor("gui.breakpoint_background");
+            instrColor = mBreakpointColor;
         } else if (instr.addr == PCAddr) {
             instrColor = PCSelectionColor;
         } else if (auto background = bih->getBasicInstruction(instr.addr)) {
@@ -657,6 +672,8 @@ const DisassemblerGraphView::Instr *DisassemblerGraphView::instrForAddress(RVA a
 
 void DisassemblerGraphView::onSeekChanged(RVA addr)
 {
+    // The selected instruction moves with the seek
+    setCacheDirty();
     blockMenu->setOffset(addr);
     DisassemblyBlock *db = blockForAddress(addr);
     bool switchFunction = false;
@@ -748,6 +765,7 @@ void DisassemblerGraphView::seekLocal(RVA addr, bool update_viewport)
     connectSeekChanged(true);
     seekable->seek(addr);
     connectSeekChanged(false);
+    setCacheDirty();
     if (update_viewport) {
         viewport()->update();
     }
@@ -819,6 +837,7 @@ void DisassemblerGraphView::blockClicked(GraphView::GraphBlock &block, QMouseEve
     if (highlight_token) {
         blockMenu->setCurHighlightedWord(highlight_token->content);
     }
+    setCacheDirty();
     viewport()->update();
 }
 
@@ -891,6 +910,8 @@ bool DisassemblerGraphView::helpEvent(QHelpEvent *event)
 void DisassemblerGraphView::blockTransitionedTo(GraphView::GraphBlock *to)
 {
     currentBlockAddress = to->entry;
+    // Edges of the current block are highlighted
+    setCacheDirty();
     if (transition_dont_seek) {
         transition_dont_seek = false;
         return;
@@ -940,11 +961,12 @@ void DisassemblerGraphView::restoreCurrentBlock()
     onSeekChanged(this->seekable->getOffset()); // try to keep the view on current block
 }
 
-void DisassemblerGraphView::paintEvent(QPaintEvent *event)
+void DisassemblerGraphView::drawBlockOverview(QPainter &p, GraphView::GraphBlock &block, bool)
 {
-    // DisassemblerGraphView is always dirty
-    setCacheDirty();
-    GraphView::paintEvent(event);
+    auto bb = Core()->getBBHighlighter()->getBasicBlock(block.entry);
+    p.setPen(QPen(graphNodeColor, 0));
+    p.setBrush(bb ? QColor(bb->color) : disassemblyBackgroundColor);
+    p.drawRect(QRectF(block.x, block.y, block.width, block.height));
 }
 
 bool DisassemblerGraphView::Instr::contains(ut64 addr) const
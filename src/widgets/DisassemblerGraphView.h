@@ -134,7 +134,7 @@ public slots:
     void copySelection();
 
 protected:
-    void paintEvent(QPaintEvent *event) override;
+    void drawBlockOverview(QPainter &p, GraphView::GraphBlock &block, bool interactive) override;
     void blockContextMenuRequested(GraphView::GraphBlock &block, QContextMenuEvent *event,
                                    QPoint pos) override;
     void contextMenuEvent(QContextMenuEvent *event) override;
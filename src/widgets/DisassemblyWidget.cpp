@@ -146,6 +146,11 @@ DisassemblyWidget::DisassemblyWidget(MainWindow *main)
     connect(Core(), &CutterCore::commentsChanged, this, [this]() { refreshDisasm(); });
     connect(Core(), SIGNAL(flagsChanged()), this, SLOT(refreshDisasm()));
     connect(Core(), SIGNAL(functionsChanged()), this, SLOT(refreshDisasm()));
+    connect(Core(), &CutterCore::functionAdded, this, &DisassemblyWidget::refreshIfFunctionInRange);
+    connect(Core(), &CutterCore::functionRemoved, this,
+            &DisassemblyWidget::refreshIfFunctionInRange);
+    connect(Core(), &CutterCore::functionChanged, this,
+            &DisassemblyWidget::refreshIfFunctionInRange);
     connect(Core(), &CutterCore::functionRenamed, this, [this]() { refreshDisasm(); });
     connect(Core(), SIGNAL(varsChanged()), this, SLOT(refreshDisasm()));
     connect(Core(), SIGNAL(asmOptionsChanged()), this, SLOT(refreshDisasm()));
@@ -243,6 +248,13 @@ void DisassemblyWidget::refreshIfInRange(RVA offset)
     }
 }
 
+void DisassemblyWidget::refreshIfFunctionInRange(const FunctionDescription &function)
+{
+    if (function.offset <= bottomOffset && function.offset + function.linearSize > topOffset) {
+        refreshDisasm();
+    }
+}
+
 void DisassemblyWidget::refreshDisasm(RVA offset)
 {
     if (!disasmRefresh->attemptRefresh(offset == RVA_INVALID ? nullptr : new RVA(offset))) {
@@ -280,6 +292,7 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
     mDisasTextEdit->document()->clear();
     QTextCursor cursor(mDisasTextEdit->document());
     QTextBlockFormat regular = cursor.blockFormat();
+    const int breakpointColor = Config()->colorId("gui.breakpoint_background");
     for (const DisassemblyLine &line : lines) {
         if (line.offset < topOffset) { // overflow
             break;
@@ -287,7 +300,7 @@ void DisassemblyWidget::refreshDisasm(RVA offset)
         cursor.insertHtml(line.text);
         if (Core()->isBreakpoint(breakpoints, line.offset)) {
             QTextBlockFormat f;
-            f.setBackground(ConfigColor("gui.breakpoint_background"));
+            f.setBackground(Config()->getColor(breakpointColor));
             cursor.setBlockFormat(f);
         }
         auto a = new DisassemblyTextBlockUserData(line);
@@ -53,6 +53,7 @@ public slots:
 protected slots:
     void on_seekChanged(RVA offset);
     void refreshIfInRange(RVA offset);
+    void refreshIfFunctionInRange(const FunctionDescription &function);
     void refreshDisasm(RVA offset = RVA_INVALID);
 
     bool updateMaxLines();
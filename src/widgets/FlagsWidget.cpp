@@ -143,7 +143,7 @@ bool FlagsSortFilterProxyModel::lessThan(const QModelIndex &left, const QModelIn
 }
 
 FlagsWidget::FlagsWidget(MainWindow *main)
-    : CutterDockWidget(main), ui(new Ui::FlagsWidget), main(main), tree(new CutterTreeWidget(this))
+    : CutterDockWidget(main), ui(new Ui::FlagsWidget), tree(new CutterTreeWidget(this))
 {
     ui->setupUi(this);
 
@@ -180,7 +180,11 @@ FlagsWidget::FlagsWidget(MainWindow *main)
 
     setScrollMode();
 
-    connect(Core(), &CutterCore::flagsChanged, this, &FlagsWidget::flagsChanged);
+    connect(Core(), &CutterCore::flagsReset, this, &FlagsWidget::flagsChanged);
+    connect(Core(), &CutterCore::flagAdded, this, &FlagsWidget::flagAdded);
+    connect(Core(), &CutterCore::flagRemoved, this, &FlagsWidget::flagRemoved);
+    connect(Core(), &CutterCore::flagChanged, this, &FlagsWidget::flagChanged);
+    connect(Core(), &CutterCore::flagRenamed, this, &FlagsWidget::flagRenamed);
     connect(Core(), &CutterCore::codeRebased, this, &FlagsWidget::flagsChanged);
     connect(Core(), &CutterCore::refreshAll, this, &FlagsWidget::refreshFlagspaces);
     connect(Core(), &CutterCore::commentsChanged, this,
@@ -232,6 +236,69 @@ void FlagsWidget::flagsChanged()
     refreshFlagspaces();
 }
 
+void FlagsWidget::flagAdded(const FlagDescription &flag)
+{
+    if (!flag.flagspace.isEmpty() && ui->flagspaceCombo->findText(flag.flagspace) < 0) {
+        // The flag created a new flagspace
+        refreshFlagspaces();
+        return;
+    }
+
+    QString flagspace = currentFlagspace();
+    if (!flagspace.isEmpty() && flag.flagspace != flagspace) {
+        return;
+    }
+
+    int row = flagRow(flag.name);
+    if (row >= 0) {
+        flags_model->updateListRow(flags, row, flag);
+    } else {
+        rowByName.insert(flag.name, flags.size());
+        flags_model->insertListRow(flags, flags.size(), flag);
+        tree->showItemsNumber(flags_proxy_model->rowCount());
+    }
+}
+
+void FlagsWidget::flagRemoved(const FlagDescription &flag)
+{
+    int row = flagRow(flag.name);
+    if (row < 0) {
+        return;
+    }
+    removeFlagRow(row);
+    tree->showItemsNumber(flags_proxy_model->rowCount());
+}
+
+void FlagsWidget::flagChanged(const FlagDescription &oldFlag, const FlagDescription &flag)
+{
+    QString flagspace = currentFlagspace();
+    if (!flagspace.isEmpty() && flag.flagspace != flagspace) {
+        flagRemoved(oldFlag);
+        return;
+    }
+    int row = flagRow(oldFlag.name);
+    if (row >= 0) {
+        rowByName.remove(oldFlag.name);
+        rowByName.insert(flag.name, row);
+        flags_model->updateListRow(flags, row, flag);
+    } else {
+        flagAdded(flag);
+    }
+}
+
+void FlagsWidget::flagRenamed(const QString &oldName, const QString &newName)
+{
+    int row = flagRow(oldName);
+    if (row < 0) {
+        return;
+    }
+    flags[row].name = newName;
+    rowByName.remove(oldName);
+    rowByName.insert(newName, row);
+    emit flags_model->dataChanged(flags_model->index(row, FlagsModel::NAME),
+                                  flags_model->index(row, FlagsModel::NAME));
+}
+
 void FlagsWidget::refreshFlagspaces()
 {
     int cur_idx = ui->flagspaceCombo->currentIndex();
@@ -259,23 +326,38 @@ void FlagsWidget::refreshFlags()
     if (disableFlagRefresh) {
         return;
     }
-    QString flagspace;
-
-    QVariant flagspace_data = ui->flagspaceCombo->currentData();
-    if (flagspace_data.isValid())
-        flagspace = flagspace_data.value<FlagspaceDescription>().name;
 
     flags_model->beginResetModel();
-    flags = Core()->getAllFlags(flagspace);
+    flags = Core()->getFlags(currentFlagspace());
+    rowByName.clear();
+    rowByName.reserve(flags.size());
+    for (int i = 0; i < flags.size(); i++) {
+        rowByName.insert(flags[i].name, i);
+    }
     flags_model->endResetModel();
 
     tree->showItemsNumber(flags_proxy_model->rowCount());
+}
 
-    // TODO: this is not a very good place for the following:
-    QStringList flagNames;
-    for (const FlagDescription &i : flags)
-        flagNames.append(i.name);
-    main->refreshOmniBar(flagNames);
+QString FlagsWidget::currentFlagspace() const
+{
+    QVariant flagspace_data = ui->flagspaceCombo->currentData();
+    if (flagspace_data.isValid())
+        return flagspace_data.value<FlagspaceDescription>().name;
+    return QString();
+}
+
+int FlagsWidget::flagRow(const QString &name) const
+{
+    return rowByName.value(name, -1);
+}
+
+void FlagsWidget::removeFlagRow(int row)
+{
+    rowByName.remove(flags[row].name);
+    if (flags_model->removeListRowUnordered(flags, row) >= 0) {
+        rowByName.insert(flags[row].name, row);
+    }
 }
 
 void FlagsWidget::setScrollMode()
@@ -74,19 +74,29 @@ private slots:
     void on_actionDelete_triggered();
 
     void flagsChanged();
+    void flagAdded(const FlagDescription &flag);
+    void flagRemoved(const FlagDescription &flag);
+    void flagChanged(const FlagDescription &oldFlag, const FlagDescription &flag);
+    void flagRenamed(const QString &oldName, const QString &newName);
     void refreshFlagspaces();
 
 private:
     std::unique_ptr<Ui::FlagsWidget> ui;
-    MainWindow *main;
 
     bool disableFlagRefresh = false;
     FlagsModel *flags_model;
     FlagsSortFilterProxyModel *flags_proxy_model;
     QList<FlagDescription> flags;
+    /**
+     * @brief Row of each flag in flags by name, so single changes don't search the whole list
+     */
+    QHash<QString, int> rowByName;
     CutterTreeWidget *tree;
 
     void refreshFlags();
+    QString currentFlagspace() const;
+    int flagRow(const QString &name) const;
+    void removeFlagRow(int row);
     void setScrollMode();
 };
 
@@ -41,6 +41,12 @@ FunctionModel::FunctionModel(QList<FunctionDescription> *functions, QSet<RVA> *i
 {
     connect(Core(), &CutterCore::seekChanged, this, &FunctionModel::seekChanged);
     connect(Core(), &CutterCore::functionRenamed, this, &FunctionModel::functionRenamed);
+    connect(Core(), &CutterCore::functionAdded, this, &FunctionModel::functionAdded);
+    connect(Core(), &CutterCore::functionRemoved, this, &FunctionModel::functionRemoved);
+    connect(Core(), &CutterCore::functionChanged, this, &FunctionModel::functionChanged);
+    // The widget replaces the whole list between beginResetModel and endResetModel
+    connect(this, &QAbstractItemModel::modelReset, this, &FunctionModel::rebuildRowIndex);
+    rebuildRowIndex();
 }
 
 QModelIndex FunctionModel::index(int row, int column, const QModelIndex &parent) const
@@ -309,6 +315,11 @@ QString FunctionModel::name(const QModelIndex &index) const
 }
 
 void FunctionModel::seekChanged(RVA)
+{
+    currentIndexMaybeChanged();
+}
+
+void FunctionModel::currentIndexMaybeChanged()
 {
     int previousIndex = currentIndex;
     if (updateCurrentIndex()) {
@@ -346,12 +357,60 @@ bool FunctionModel::updateCurrentIndex()
 
 void FunctionModel::functionRenamed(const RVA offset, const QString &new_name)
 {
+    int row = functionRow(offset);
+    if (row >= 0) {
+        (*functions)[row].name = new_name;
+        emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+    }
+}
+
+void FunctionModel::functionAdded(const FunctionDescription &function)
+{
+    int row = functionRow(function.offset);
+    if (row >= 0) {
+        updateListRow(*functions, row, function);
+    } else {
+        rowByOffset.insert(function.offset, functions->count());
+        insertListRow(*functions, functions->count(), function);
+    }
+    currentIndexMaybeChanged();
+}
+
+void FunctionModel::functionRemoved(const FunctionDescription &function)
+{
+    int row = functionRow(function.offset);
+    if (row < 0) {
+        return;
+    }
+    rowByOffset.remove(function.offset);
+    if (removeListRowUnordered(*functions, row) >= 0) {
+        rowByOffset.insert(functions->at(row).offset, row);
+    }
+    // The last row moved, don't emit dataChanged for a stale index
+    currentIndex = -1;
+    currentIndexMaybeChanged();
+}
+
+void FunctionModel::functionChanged(const FunctionDescription &function)
+{
+    int row = functionRow(function.offset);
+    if (row >= 0) {
+        updateListRow(*functions, row, function);
+        currentIndexMaybeChanged();
+    }
+}
+
+int FunctionModel::functionRow(RVA offset) const
+{
+    return rowByOffset.value(offset, -1);
+}
+
+void FunctionModel::rebuildRowIndex()
+{
+    rowByOffset.clear();
+    rowByOffset.reserve(functions->count());
     for (int i = 0; i < functions->count(); i++) {
-        FunctionDescription &function = (*functions)[i];
-        if (function.offset == offset) {
-            function.name = new_name;
-            emit dataChanged(index(i, 0), index(i, columnCount() - 1));
-        }
+        rowByOffset.insert(functions->at(i).offset, i);
     }
 }
 
@@ -27,6 +27,10 @@ private:
     bool nested;
 
     int currentIndex;
+    /**
+     * @brief Row of each function by offset, so single changes don't search the whole list
+     */
+    QHash<RVA, int> rowByOffset;
 
     bool functionIsImport(ut64 addr) const;
 
@@ -79,6 +83,14 @@ public:
 private slots:
     void seekChanged(RVA addr);
     void functionRenamed(const RVA offset, const QString &new_name);
+    void functionAdded(const FunctionDescription &function);
+    void functionRemoved(const FunctionDescription &function);
+    void functionChanged(const FunctionDescription &function);
+
+private:
+    int functionRow(RVA offset) const;
+    void rebuildRowIndex();
+    void currentIndexMaybeChanged();
 };
 
 class FunctionSortFilterProxyModel : public AddressableFilterProxyModel
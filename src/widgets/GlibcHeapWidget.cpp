@@ -5,6 +5,9 @@
 #include "core/MainWindow.h"
 #include "QHeaderView"
 #include "dialogs/GlibcHeapInfoDialog.h"
+#include "widgets/HeapMapWidget.h"
+
+#include <algorithm>
 
 GlibcHeapWidget::GlibcHeapWidget(MainWindow *main, QWidget *parent)
     : QWidget(parent),
@@ -27,7 +30,10 @@ GlibcHeapWidget::GlibcHeapWidget(MainWindow *main, QWidget *parent)
     chunkInfoAction = new QAction(tr("Detailed Chunk Info"), this);
     binInfoAction = new QAction(tr("Bins Info"), this);
 
-    connect(Core(), &CutterCore::refreshAll, this, &GlibcHeapWidget::updateContents);
+    connect(Core(), &CutterCore::refreshAll, this, [this]() {
+        modelHeap->invalidate();
+        updateContents();
+    });
     connect(Core(), &CutterCore::debugTaskStateChanged, this, &GlibcHeapWidget::updateContents);
     connect(viewHeap, &QAbstractItemView::doubleClicked, this, &GlibcHeapWidget::onDoubleClicked);
     connect<void (QComboBox::*)(int)>(arenaSelectorView, &QComboBox::currentIndexChanged, this,
@@ -40,6 +46,8 @@ GlibcHeapWidget::GlibcHeapWidget(MainWindow *main, QWidget *parent)
     connect(binInfoAction, &QAction::triggered, this, &GlibcHeapWidget::viewBinInfo);
     connect(ui->binsButton, &QPushButton::clicked, this, &GlibcHeapWidget::viewBinInfo);
     connect(ui->arenaButton, &QPushButton::clicked, this, &GlibcHeapWidget::viewArenaInfo);
+    connect(ui->heapMap, &HeapMapWidget::chunkClicked, this,
+            &GlibcHeapWidget::onHeapMapChunkClicked);
 
     addressableItemContextMenu.addAction(chunkInfoAction);
     addressableItemContextMenu.addAction(binInfoAction);
@@ -102,6 +110,21 @@ void GlibcHeapWidget::updateChunks()
 {
     modelHeap->reload();
     viewHeap->resizeColumnsToContents();
+    ui->heapMap->setChunks(modelHeap->getChunks());
+}
+
+void GlibcHeapWidget::onHeapMapChunkClicked(RVA offset)
+{
+    const QVector<Chunk> &chunks = modelHeap->getChunks();
+    auto it = std::lower_bound(chunks.constBegin(), chunks.constEnd(), offset,
+                               [](const Chunk &chunk, RVA addr) { return chunk.offset < addr; });
+    if (it == chunks.constEnd() || it->offset != offset) {
+        return;
+    }
+    QModelIndex index = modelHeap->index(static_cast<int>(it - chunks.constBegin()),
+                                         GlibcHeapModel::OffsetColumn);
+    viewHeap->setCurrentIndex(index);
+    viewHeap->scrollTo(index);
 }
 
 void GlibcHeapWidget::customMenuRequested(QPoint pos)
@@ -111,10 +134,56 @@ void GlibcHeapWidget::customMenuRequested(QPoint pos)
 
 void GlibcHeapModel::reload()
 {
-    beginResetModel();
-    values.clear();
-    values = Core()->getHeapChunks(arena_addr);
-    endResetModel();
+    if (walker.getArena() != arena_addr) {
+        walker.setArena(arena_addr);
+    }
+    GlibcHeapWalker::Delta delta = walker.update();
+    const QVector<Chunk> &chunks = walker.getChunks();
+    if (delta.reset) {
+        beginResetModel();
+        values = chunks;
+        changes = walker.getChanges();
+        endResetModel();
+        return;
+    }
+    if (!delta.changed) {
+        return;
+    }
+
+    // Replace the rows between the chunks that kept their offsets
+    const QVector<GlibcHeapWalker::Change> &newChanges = walker.getChanges();
+    int removedCount = values.size() - delta.commonPrefix - delta.commonSuffix;
+    if (removedCount > 0) {
+        beginRemoveRows(QModelIndex(), delta.commonPrefix, delta.commonPrefix + removedCount - 1);
+        values.remove(delta.commonPrefix, removedCount);
+        changes.remove(delta.commonPrefix, removedCount);
+        endRemoveRows();
+    }
+    int insertedCount = chunks.size() - delta.commonPrefix - delta.commonSuffix;
+    if (insertedCount > 0) {
+        beginInsertRows(QModelIndex(), delta.commonPrefix, delta.commonPrefix + insertedCount - 1);
+        values.insert(delta.commonPrefix, insertedCount, Chunk());
+        changes.insert(delta.commonPrefix, insertedCount, GlibcHeapWalker::Change::Unchanged);
+        std::copy(chunks.constBegin() + delta.commonPrefix,
+                  chunks.constBegin() + delta.commonPrefix + insertedCount,
+                  values.begin() + delta.commonPrefix);
+        std::copy(newChanges.constBegin() + delta.commonPrefix,
+                  newChanges.constBegin() + delta.commonPrefix + insertedCount,
+                  changes.begin() + delta.commonPrefix);
+        endInsertRows();
+    }
+
+    // Only the kept rows whose status or highlight changed are repainted
+    for (int row : delta.changedRows) {
+        values[row] = chunks[row];
+        changes[row] = newChanges[row];
+        emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+    }
+}
+
+void GlibcHeapModel::invalidate()
+{
+    walker.invalidate();
 }
 
 int GlibcHeapModel::columnCount(const QModelIndex &) const
@@ -146,6 +215,24 @@ QVariant GlibcHeapModel::data(const QModelIndex &index, int role) const
         default:
             return QVariant();
         }
+    case Qt::BackgroundRole:
+        if (changes.at(index.row()) != GlibcHeapWalker::Change::Unchanged) {
+            return ConfigColor("graph.diff.unmatch");
+        }
+        return QVariant();
+    case Qt::ToolTipRole:
+        switch (changes.at(index.row())) {
+        case GlibcHeapWalker::Change::Added:
+            return tr("New chunk since the last step");
+        case GlibcHeapWalker::Change::Allocated:
+            return tr("Allocated since the last step");
+        case GlibcHeapWalker::Change::Freed:
+            return tr("Freed since the last step");
+        case GlibcHeapWalker::Change::Resized:
+            return tr("Split or merged since the last step");
+        default:
+            return QVariant();
+        }
     default:
         return QVariant();
     }
@@ -4,6 +4,7 @@
 #include <QDockWidget>
 #include "CutterDockWidget.h"
 #include "core/Cutter.h"
+#include "common/GlibcHeapWalker.h"
 #include <QTableView>
 #include <QComboBox>
 #include <AddressableItemContextMenu.h>
@@ -18,7 +19,15 @@ class GlibcHeapModel : public QAbstractTableModel
 public:
     explicit GlibcHeapModel(QObject *parent = nullptr);
     enum Column { OffsetColumn = 0, SizeColumn, StatusColumn, ColumnCount };
+    /**
+     * @brief Update the chunks of arena_addr, rows of unchanged chunks are kept
+     */
     void reload();
+    /**
+     * @brief Walk the whole arena again on the next reload
+     */
+    void invalidate();
+    const QVector<Chunk> &getChunks() const { return values; }
     int rowCount(const QModelIndex &parent) const override;
     int columnCount(const QModelIndex &parent) const override;
     QVariant data(const QModelIndex &index, int role) const override;
@@ -26,7 +35,9 @@ public:
     RVA arena_addr = 0;
 
 private:
+    GlibcHeapWalker walker;
     QVector<Chunk> values;
+    QVector<GlibcHeapWalker::Change> changes;
 };
 
 class GlibcHeapWidget : public QWidget
@@ -45,6 +56,7 @@ private slots:
     void viewChunkInfo();
     void viewBinInfo();
     void viewArenaInfo();
+    void onHeapMapChunkClicked(RVA offset);
 
 private:
     void updateArenas();
@@ -5,8 +5,12 @@
 #include <queue>
 #include <stack>
 #include <cassert>
+#include <iterator>
+#include <numeric>
 #include <queue>
 
+#include <QElapsedTimer>
+
 #include "common/BinaryTrees.h"
 
 /** @class GraphGridLayout
@@ -190,32 +194,96 @@ GraphGridLayout::GraphGridLayout(GraphGridLayout::LayoutType layoutType) : Graph
     }
 }
 
-std::vector<ut64> GraphGridLayout::topoSort(LayoutState &state, ut64 entry)
+int GraphGridLayout::indexGraph(GraphLayout::Graph &blocks, ut64 entry, LayoutState &state)
+{
+    // Edges to unknown blocks get an empty block, so that every edge can be resolved to an index
+    std::vector<ut64> missingTargets;
+    for (auto &blockIt : blocks) {
+        for (auto &edge : blockIt.second.edges) {
+            if (blocks.find(edge.target) == blocks.end()) {
+                missingTargets.push_back(edge.target);
+            }
+        }
+    }
+    for (auto target : missingTargets) {
+        blocks[target].entry = target;
+    }
+
+    // Ties in the grid placement and edge routing are broken by block order. Number the blocks in
+    // the iteration order of an address keyed hash map filled in graph order, which keeps the
+    // layout of a graph stable.
+    std::unordered_map<ut64, int> blockIndex;
+    for (auto &blockIt : blocks) {
+        blockIndex[blockIt.first] = 0;
+    }
+    state.blocks.reserve(blocks.size());
+    for (auto &indexIt : blockIndex) {
+        indexIt.second = static_cast<int>(state.blocks.size());
+        state.blocks.push_back(&blocks[indexIt.first]);
+    }
+    state.graphOrder.reserve(blocks.size());
+    for (auto &blockIt : blocks) {
+        state.graphOrder.push_back(blockIndex[blockIt.first]);
+    }
+    state.grid_blocks.resize(state.blocks.size());
+
+    state.edgeStart.resize(state.blocks.size() + 1);
+    size_t edgeCount = 0;
+    for (size_t i = 0; i < state.blocks.size(); i++) {
+        state.edgeStart[i] = edgeCount;
+        edgeCount += state.blocks[i]->edges.size();
+    }
+    state.edgeStart.back() = edgeCount;
+    state.edge.resize(edgeCount);
+    for (size_t i = 0; i < state.blocks.size(); i++) {
+        auto &edges = state.blocks[i]->edges;
+        for (size_t j = 0; j < edges.size(); j++) {
+            state.edge[state.edgeStart[i] + j].dest = blockIndex[edges[j].target];
+        }
+    }
+
+    auto entryIt = blockIndex.find(entry);
+    return entryIt != blockIndex.end() ? entryIt->second : 0;
+}
+
+std::vector<ut64> GraphGridLayout::topologyKey(const Graph &blocks, ut64 entry)
 {
-    auto &blocks = *state.blocks;
+    std::vector<ut64> key;
+    key.reserve(blocks.size() * 3 + 1);
+    key.push_back(entry);
+    for (auto &blockIt : blocks) {
+        key.push_back(blockIt.first);
+        key.push_back(blockIt.second.edges.size());
+        for (auto &edge : blockIt.second.edges) {
+            key.push_back(edge.target);
+        }
+    }
+    return key;
+}
 
+std::vector<int> GraphGridLayout::topoSort(LayoutState &state, int entry)
+{
     // Run DFS to:
     // * select backwards/loop edges
     // * perform toposort
-    std::vector<ut64> blockOrder;
+    std::vector<int> blockOrder;
+    blockOrder.reserve(state.blocks.size());
     enum class State : uint8_t { NotVisited = 0, InStack, Visited };
-    std::unordered_map<ut64, State> visited;
-    visited.reserve(state.blocks->size());
-    std::stack<std::pair<ut64, size_t>> stack;
-    auto dfsFragment = [&visited, &blocks, &state, &stack, &blockOrder](ut64 first) {
+    std::vector<State> visited(state.blocks.size(), State::NotVisited);
+    std::stack<std::pair<int, size_t>> stack;
+    auto dfsFragment = [&visited, &state, &stack, &blockOrder](int first) {
         visited[first] = State::InStack;
-        stack.push({ first, 0 });
+        stack.push({ first, state.edgeStart[first] });
         while (!stack.empty()) {
             auto v = stack.top().first;
             auto edge_index = stack.top().second;
-            const auto &block = blocks[v];
-            if (edge_index < block.edges.size()) {
+            if (edge_index < state.edgeStart[v + 1]) {
                 ++stack.top().second;
-                auto target = block.edges[edge_index].target;
+                auto target = state.edge[edge_index].dest;
                 auto &targetState = visited[target];
                 if (targetState == State::NotVisited) {
                     targetState = State::InStack;
-                    stack.push({ target, 0 });
+                    stack.push({ target, state.edgeStart[target] });
                     state.grid_blocks[v].dag_edge.push_back(target);
                 } else if (targetState == State::Visited) {
                     state.grid_blocks[v].dag_edge.push_back(target);
@@ -232,9 +300,9 @@ std::vector<ut64> GraphGridLayout::topoSort(LayoutState &state, ut64 entry)
     // is still kept at top unless it's impossible to do while maintaining
     // topological order.
     dfsFragment(entry);
-    for (auto &blockIt : blocks) {
-        if (visited[blockIt.first] == State::NotVisited) {
-            dfsFragment(blockIt.first);
+    for (auto blockId : state.graphOrder) {
+        if (visited[blockId] == State::NotVisited) {
+            dfsFragment(blockId);
         }
     }
 
@@ -242,7 +310,7 @@ std::vector<ut64> GraphGridLayout::topoSort(LayoutState &state, ut64 entry)
 }
 
 void GraphGridLayout::assignRows(GraphGridLayout::LayoutState &state,
-                                 const std::vector<unsigned long long> &blockOrder)
+                                 const std::vector<int> &blockOrder)
 {
     for (auto it = blockOrder.rbegin(), end = blockOrder.rend(); it != end; it++) {
         auto &block = state.grid_blocks[*it];
@@ -256,8 +324,7 @@ void GraphGridLayout::assignRows(GraphGridLayout::LayoutState &state,
 
 void GraphGridLayout::selectTree(GraphGridLayout::LayoutState &state)
 {
-    for (auto &blockIt : state.grid_blocks) {
-        auto &block = blockIt.second;
+    for (auto &block : state.grid_blocks) {
         for (auto targetId : block.dag_edge) {
             auto &targetBlock = state.grid_blocks[targetId];
             if (!targetBlock.has_parent && targetBlock.row == block.row + 1) {
@@ -271,84 +338,121 @@ void GraphGridLayout::selectTree(GraphGridLayout::LayoutState &state)
 void GraphGridLayout::CalculateLayout(GraphLayout::Graph &blocks, ut64 entry, int &width,
                                       int &height) const
 {
-    LayoutState layoutState;
-    layoutState.blocks = &blocks;
     if (blocks.empty()) {
         return;
     }
-    if (blocks.find(entry) == blocks.end()) {
-        entry = blocks.begin()->first;
+    QElapsedTimer timer;
+    timer.start();
+    auto finishPhase = [&](qint64 PhaseTimings::*phase) {
+        if (phaseTimings) {
+            phaseTimings->*phase = timer.nsecsElapsed();
+            timer.restart();
+        }
+    };
+    if (phaseTimings) {
+        *phaseTimings = PhaseTimings();
     }
 
-    for (auto &it : blocks) {
-        GridBlock block;
-        block.id = it.first;
-        layoutState.grid_blocks[it.first] = block;
-    }
+    // Everything up to the edge main columns only depends on the graph structure. When only the
+    // block sizes changed since the previous call, continue from the state it left at that point.
+    LayoutState layoutState;
+    std::vector<ut64> topology = topologyKey(blocks, entry);
+    if (topology == topologyCache.topology) {
+        layoutState = topologyCache.state;
+        for (size_t i = 0; i < layoutState.blocks.size(); i++) {
+            ut64 address = topologyCache.addresses[i];
+            auto blockIt = blocks.find(address);
+            if (blockIt == blocks.end()) {
+                // Empty block for an unknown edge target, as created by indexGraph
+                blockIt = blocks.emplace(address, GraphBlock()).first;
+                blockIt->second.entry = address;
+            }
+            layoutState.blocks[i] = &blockIt->second;
+        }
+        finishPhase(&PhaseTimings::indexGraph);
+    } else {
+        int entryIndex = indexGraph(blocks, entry, layoutState);
+        finishPhase(&PhaseTimings::indexGraph);
+
+        auto blockOrder = topoSort(layoutState, entryIndex);
+        finishPhase(&PhaseTimings::topoSort);
+        computeAllBlockPlacement(blockOrder, layoutState);
+
+        for (size_t i = 0; i < layoutState.blocks.size(); i++) {
+            auto &startBlock = layoutState.grid_blocks[i];
+            startBlock.outputCount = layoutState.edgeStart[i + 1] - layoutState.edgeStart[i];
+        }
+        for (auto &edge : layoutState.edge) {
+            layoutState.grid_blocks[edge.dest].inputCount++;
+        }
 
-    auto blockOrder = topoSort(layoutState, entry);
-    computeAllBlockPlacement(blockOrder, layoutState);
+        layoutState.columns = 1;
+        layoutState.rows = 1;
+        for (auto &node : layoutState.grid_blocks) {
+            // count is at least index + 1
+            layoutState.rows = std::max(layoutState.rows, size_t(node.row) + 1);
+            // block is 2 column wide
+            layoutState.columns = std::max(layoutState.columns, size_t(node.col) + 2);
+        }
+        finishPhase(&PhaseTimings::blockPlacement);
 
-    for (auto &blockIt : blocks) {
-        layoutState.edge[blockIt.first].resize(blockIt.second.edges.size());
-        for (size_t i = 0; i < blockIt.second.edges.size(); i++) {
-            layoutState.edge[blockIt.first][i].dest = blockIt.second.edges[i].target;
-            blockIt.second.edges[i].arrow = GraphEdge::Down;
+        calculateEdgeMainColumn(layoutState);
+        finishPhase(&PhaseTimings::edgeMainColumn);
+
+        topologyCache.topology = std::move(topology);
+        topologyCache.addresses.resize(layoutState.blocks.size());
+        size_t graphIndex = 0;
+        for (auto &blockIt : blocks) {
+            topologyCache.addresses[layoutState.graphOrder[graphIndex++]] = blockIt.first;
         }
+        topologyCache.state = layoutState;
     }
-    for (const auto &edgeList : layoutState.edge) {
-        auto &startBlock = layoutState.grid_blocks[edgeList.first];
-        startBlock.outputCount = edgeList.second.size();
-        for (auto &edge : edgeList.second) {
-            auto &targetBlock = layoutState.grid_blocks[edge.dest];
-            targetBlock.inputCount++;
+    for (auto block : layoutState.blocks) {
+        for (auto &edge : block->edges) {
+            edge.arrow = GraphEdge::Down;
         }
     }
 
-    layoutState.columns = 1;
-    layoutState.rows = 1;
-    for (auto &node : layoutState.grid_blocks) {
-        // count is at least index + 1
-        layoutState.rows = std::max(layoutState.rows, size_t(node.second.row) + 1);
-        // block is 2 column wide
-        layoutState.columns = std::max(layoutState.columns, size_t(node.second.col) + 2);
-    }
-
     layoutState.rowHeight.assign(layoutState.rows, 0);
     layoutState.columnWidth.assign(layoutState.columns, 0);
-    for (auto &node : layoutState.grid_blocks) {
-        const auto &inputBlock = blocks[node.first];
-        layoutState.rowHeight[node.second.row] =
-                std::max(inputBlock.height, layoutState.rowHeight[node.second.row]);
-        layoutState.columnWidth[node.second.col] =
-                std::max(inputBlock.width / 2, layoutState.columnWidth[node.second.col]);
-        layoutState.columnWidth[node.second.col + 1] =
-                std::max(inputBlock.width / 2, layoutState.columnWidth[node.second.col + 1]);
+    for (size_t i = 0; i < layoutState.blocks.size(); i++) {
+        const auto &node = layoutState.grid_blocks[i];
+        const auto &inputBlock = *layoutState.blocks[i];
+        layoutState.rowHeight[node.row] =
+                std::max(inputBlock.height, layoutState.rowHeight[node.row]);
+        layoutState.columnWidth[node.col] =
+                std::max(inputBlock.width / 2, layoutState.columnWidth[node.col]);
+        layoutState.columnWidth[node.col + 1] =
+                std::max(inputBlock.width / 2, layoutState.columnWidth[node.col + 1]);
     }
 
-    routeEdges(layoutState);
+    roughRouting(layoutState);
+    finishPhase(&PhaseTimings::roughRouting);
+    elaborateEdgePlacement(layoutState);
+    finishPhase(&PhaseTimings::elaborateEdgePlacement);
 
     convertToPixelCoordinates(layoutState, width, height);
+    finishPhase(&PhaseTimings::pixelCoordinates);
     if (useLayoutOptimization) {
         optimizeLayout(layoutState);
         cropToContent(blocks, width, height);
+        finishPhase(&PhaseTimings::optimizeLayout);
     }
 }
 
 void GraphGridLayout::findMergePoints(GraphGridLayout::LayoutState &state) const
 {
-    for (auto &blockIt : state.grid_blocks) {
-        auto &block = blockIt.second;
-        GridBlock *mergeBlock = nullptr;
+    for (auto &block : state.grid_blocks) {
+        int mergeBlock = -1;
         int grandChildCount = 0;
         for (auto edge : block.tree_edge) {
             auto &targetBlock = state.grid_blocks[edge];
             if (targetBlock.tree_edge.size()) {
-                mergeBlock = &state.grid_blocks[targetBlock.tree_edge[0]];
+                mergeBlock = targetBlock.tree_edge[0];
             }
             grandChildCount += targetBlock.tree_edge.size();
         }
-        if (!mergeBlock || grandChildCount != 1) {
+        if (mergeBlock == -1 || grandChildCount != 1) {
             continue;
         }
         int blocksGoingToMerge = 0;
@@ -357,7 +461,7 @@ void GraphGridLayout::findMergePoints(GraphGridLayout::LayoutState &state) const
             auto &targetBlock = state.grid_blocks[edge];
             bool goesToMerge = false;
             for (auto secondEdgeTarget : targetBlock.dag_edge) {
-                if (secondEdgeTarget == mergeBlock->id) {
+                if (secondEdgeTarget == mergeBlock) {
                     goesToMerge = true;
                     break;
                 }
@@ -372,14 +476,14 @@ void GraphGridLayout::findMergePoints(GraphGridLayout::LayoutState &state) const
             }
         }
         if (blocksGoingToMerge) {
-            block.mergeBlock = mergeBlock->id;
+            block.mergeBlock = mergeBlock;
             state.grid_blocks[block.tree_edge[blockWithTreeEdge]].col =
                     blockWithTreeEdge * 2 - (blocksGoingToMerge - 1);
         }
     }
 }
 
-void GraphGridLayout::computeAllBlockPlacement(const std::vector<ut64> &blockOrder,
+void GraphGridLayout::computeAllBlockPlacement(const std::vector<int> &blockOrder,
                                                LayoutState &layoutState) const
 {
     assignRows(layoutState, blockOrder);
@@ -512,8 +616,7 @@ void GraphGridLayout::computeAllBlockPlacement(const std::vector<ut64> &blockOrd
     // entrypoint. There can be more of them in case of switch statement analysis failure,
     // unreahable basic blocks or using the algorithm for non control flow graphs.
     int nextEmptyColumn = 0;
-    for (auto &blockIt : layoutState.grid_blocks) {
-        auto &block = blockIt.second;
+    for (auto &block : layoutState.grid_blocks) {
         if (block.row == 0) { // place all the roots first
             auto offset = -block.leftPosition;
             block.col += nextEmptyColumn + offset;
@@ -531,13 +634,6 @@ void GraphGridLayout::computeAllBlockPlacement(const std::vector<ut64> &blockOrd
     }
 }
 
-void GraphGridLayout::routeEdges(GraphGridLayout::LayoutState &state) const
-{
-    calculateEdgeMainColumn(state);
-    roughRouting(state);
-    elaborateEdgePlacement(state);
-}
-
 void GraphGridLayout::calculateEdgeMainColumn(GraphGridLayout::LayoutState &state) const
 {
     // Find an empty column as close as possible to start or end block's column.
@@ -547,27 +643,25 @@ void GraphGridLayout::calculateEdgeMainColumn(GraphGridLayout::LayoutState &stat
 
     struct Event
     {
-        size_t blockId;
+        int blockId;
         size_t edgeId;
         int row;
         enum Type { Edge = 0, Block = 1 } type;
     };
     // create events
     std::vector<Event> events;
-    events.reserve(state.grid_blocks.size() * 2);
-    for (const auto &it : state.grid_blocks) {
-        events.push_back({ it.first, 0, it.second.row, Event::Block });
-        const auto &inputBlock = (*state.blocks)[it.first];
-        int startRow = it.second.row + 1;
-
-        auto gridEdges = state.edge[it.first];
-        gridEdges.resize(inputBlock.edges.size());
-        for (size_t i = 0; i < inputBlock.edges.size(); i++) {
-            auto targetId = inputBlock.edges[i].target;
-            gridEdges[i].dest = targetId;
-            const auto &targetGridBlock = state.grid_blocks[targetId];
+    events.reserve(state.grid_blocks.size() + state.edge.size());
+    for (size_t i = 0; i < state.grid_blocks.size(); i++) {
+        const auto &gridBlock = state.grid_blocks[i];
+        const int blockId = static_cast<int>(i);
+        events.push_back({ blockId, 0, gridBlock.row, Event::Block });
+        int startRow = gridBlock.row + 1;
+
+        for (size_t e = state.edgeStart[i]; e < state.edgeStart[i + 1]; e++) {
+            const auto &targetGridBlock = state.grid_blocks[state.edge[e].dest];
             int endRow = targetGridBlock.row;
-            events.push_back({ it.first, i, std::max(startRow, endRow), Event::Edge });
+            events.push_back({ blockId, e - state.edgeStart[i], std::max(startRow, endRow),
+                               Event::Edge });
         }
     }
     std::sort(events.begin(), events.end(), [](const Event &a, const Event &b) {
@@ -581,12 +675,12 @@ void GraphGridLayout::calculateEdgeMainColumn(GraphGridLayout::LayoutState &stat
     PointSetMinTree blockedColumns(state.columns + 1, -1);
     for (const auto &event : events) {
         if (event.type == Event::Block) {
-            auto block = state.grid_blocks[event.blockId];
+            const auto &block = state.grid_blocks[event.blockId];
             blockedColumns.set(block.col + 1, event.row);
         } else {
-            auto block = state.grid_blocks[event.blockId];
+            const auto &block = state.grid_blocks[event.blockId];
             int column = block.col + 1;
-            auto &edge = state.edge[event.blockId][event.edgeId];
+            auto &edge = state.edge[state.edgeStart[event.blockId] + event.edgeId];
             const auto &targetBlock = state.grid_blocks[edge.dest];
             auto topRow = std::min(block.row + 1, targetBlock.row);
             auto targetColumn = targetBlock.col + 1;
@@ -628,9 +722,9 @@ void GraphGridLayout::calculateEdgeMainColumn(GraphGridLayout::LayoutState &stat
                 } else {
                     // In case of tie choose based on edge index. Should result in true branches
                     // being mostly on one side, false branches on other side.
-                    edge.mainColumn = event.edgeId < state.edge[event.blockId].size() / 2
-                            ? nearestLeft
-                            : nearestRight;
+                    size_t edgeCount = state.edgeStart[event.blockId + 1]
+                            - state.edgeStart[event.blockId];
+                    edge.mainColumn = event.edgeId < edgeCount / 2 ? nearestLeft : nearestRight;
                 }
             }
         }
@@ -650,11 +744,10 @@ void GraphGridLayout::roughRouting(GraphGridLayout::LayoutState &state) const
         return 0;
     };
 
-    for (auto &blockIt : state.grid_blocks) {
-        auto &blockEdges = state.edge[blockIt.first];
-        for (size_t i = 0; i < blockEdges.size(); i++) {
-            auto &edge = blockEdges[i];
-            const auto &start = blockIt.second;
+    for (size_t blockId = 0; blockId < state.grid_blocks.size(); blockId++) {
+        for (size_t e = state.edgeStart[blockId]; e < state.edgeStart[blockId + 1]; e++) {
+            auto &edge = state.edge[e];
+            const auto &start = state.grid_blocks[blockId];
             const auto &target = state.grid_blocks[edge.dest];
 
             edge.addPoint(start.row + 1, start.col + 1);
@@ -682,9 +775,9 @@ void GraphGridLayout::roughRouting(GraphGridLayout::LayoutState &state) const
 
             // reduce edge spacing when there is large amount of edges connected to single block
             auto startSpacingOverride =
-                    getSpacingOverride((*state.blocks)[start.id].width, start.outputCount);
+                    getSpacingOverride(state.blocks[blockId]->width, start.outputCount);
             auto targetSpacingOverride =
-                    getSpacingOverride((*state.blocks)[target.id].width, target.inputCount);
+                    getSpacingOverride(state.blocks[edge.dest]->width, target.inputCount);
             edge.points.front().spacingOverride = startSpacingOverride;
             edge.points.back().spacingOverride = targetSpacingOverride;
             if (edge.points.size() <= 2) {
@@ -987,19 +1080,16 @@ void GraphGridLayout::elaborateEdgePlacement(GraphGridLayout::LayoutState &state
     std::vector<int> edgeOffsets;
 
     // Vertical segments
-    for (auto &edgeListIt : state.edge) {
-        for (const auto &edge : edgeListIt.second) {
-            for (size_t j = 1; j < edge.points.size(); j += 2) {
-                segments.push_back(
-                        segmentFromPoint(edge.points[j], edge,
-                                         edge.points[j - 1].row * 2, // edges in even rows
-                                         edge.points[j].row * 2, edge.points[j].col));
-            }
+    for (const auto &edge : state.edge) {
+        for (size_t j = 1; j < edge.points.size(); j += 2) {
+            segments.push_back(segmentFromPoint(edge.points[j], edge,
+                                                edge.points[j - 1].row * 2, // edges in even rows
+                                                edge.points[j].row * 2, edge.points[j].col));
         }
     }
-    for (auto &blockIt : state.grid_blocks) {
-        auto &node = blockIt.second;
-        auto width = (*state.blocks)[blockIt.first].width;
+    for (size_t i = 0; i < state.grid_blocks.size(); i++) {
+        auto &node = state.grid_blocks[i];
+        auto width = state.blocks[i]->width;
         auto leftWidth = width / 2;
         // not the same as leftWidth, you would think that one pixel offset isn't visible, but it is
         auto rightWidth = width - leftWidth;
@@ -1018,16 +1108,17 @@ void GraphGridLayout::elaborateEdgePlacement(GraphGridLayout::LayoutState &state
 
     auto copySegmentsToEdges = [&](bool col) {
         int edgeIndex = 0;
-        for (auto &edgeListIt : state.edge) {
-            for (auto &edge : edgeListIt.second) {
+        for (size_t blockId = 0; blockId < state.grid_blocks.size(); blockId++) {
+            for (size_t e = state.edgeStart[blockId]; e < state.edgeStart[blockId + 1]; e++) {
+                auto &edge = state.edge[e];
                 for (size_t j = col ? 1 : 2; j < edge.points.size(); j += 2) {
                     int offset = edgeOffsets[edgeIndex++];
                     if (col) {
                         GraphBlock *block = nullptr;
                         if (j == 1) {
-                            block = &(*state.blocks)[edgeListIt.first];
+                            block = state.blocks[blockId];
                         } else if (j + 1 == edge.points.size()) {
-                            block = &(*state.blocks)[edge.dest];
+                            block = state.blocks[edge.dest];
                         }
                         if (block) {
                             int blockWidth = block->width;
@@ -1066,25 +1157,22 @@ void GraphGridLayout::elaborateEdgePlacement(GraphGridLayout::LayoutState &state
     rightSides.clear();
 
     edgeIndex = 0;
-    for (auto &edgeListIt : state.edge) {
-        for (const auto &edge : edgeListIt.second) {
-            for (size_t j = 2; j < edge.points.size(); j += 2) {
-                int y0 = state.edgeColumnOffset[edge.points[j - 1].col] + edge.points[j - 1].offset;
-                int y1 = state.edgeColumnOffset[edge.points[j + 1].col] + edge.points[j + 1].offset;
-                segments.push_back(
-                        segmentFromPoint(edge.points[j], edge, y0, y1, edge.points[j].row));
-            }
+    for (const auto &edge : state.edge) {
+        for (size_t j = 2; j < edge.points.size(); j += 2) {
+            int y0 = state.edgeColumnOffset[edge.points[j - 1].col] + edge.points[j - 1].offset;
+            int y1 = state.edgeColumnOffset[edge.points[j + 1].col] + edge.points[j + 1].offset;
+            segments.push_back(segmentFromPoint(edge.points[j], edge, y0, y1, edge.points[j].row));
         }
     }
     edgeOffsets.resize(edgeIndex);
-    for (auto &blockIt : state.grid_blocks) {
-        auto &node = blockIt.second;
-        auto blockWidth = (*state.blocks)[node.id].width;
+    for (size_t i = 0; i < state.grid_blocks.size(); i++) {
+        auto &node = state.grid_blocks[i];
+        auto blockWidth = state.blocks[i]->width;
         int leftSide = state.edgeColumnOffset[node.col + 1]
                 + state.edgeColumnWidth[node.col + 1] / 2 - blockWidth / 2;
         int rightSide = leftSide + blockWidth;
 
-        int h = (*state.blocks)[blockIt.first].height;
+        int h = state.blocks[i]->height;
         int freeSpace = state.rowHeight[node.row] - h;
         int topProfile = state.rowHeight[node.row];
         int bottomProfile = h;
@@ -1109,16 +1197,14 @@ void GraphGridLayout::adjustColumnWidths(GraphGridLayout::LayoutState &state) co
 {
     state.rowHeight.assign(state.rows, 0);
     state.columnWidth.assign(state.columns, 0);
-    for (auto &node : state.grid_blocks) {
-        const auto &inputBlock = (*state.blocks)[node.first];
-        state.rowHeight[node.second.row] =
-                std::max(inputBlock.height, state.rowHeight[node.second.row]);
-        int edgeWidth = state.edgeColumnWidth[node.second.col + 1];
+    for (size_t i = 0; i < state.grid_blocks.size(); i++) {
+        const auto &node = state.grid_blocks[i];
+        const auto &inputBlock = *state.blocks[i];
+        state.rowHeight[node.row] = std::max(inputBlock.height, state.rowHeight[node.row]);
+        int edgeWidth = state.edgeColumnWidth[node.col + 1];
         int columnWidth = (inputBlock.width - edgeWidth) / 2;
-        state.columnWidth[node.second.col] =
-                std::max(columnWidth, state.columnWidth[node.second.col]);
-        state.columnWidth[node.second.col + 1] =
-                std::max(columnWidth, state.columnWidth[node.second.col + 1]);
+        state.columnWidth[node.col] = std::max(columnWidth, state.columnWidth[node.col]);
+        state.columnWidth[node.col + 1] = std::max(columnWidth, state.columnWidth[node.col + 1]);
     }
 }
 
@@ -1152,25 +1238,26 @@ void GraphGridLayout::convertToPixelCoordinates(GraphGridLayout::LayoutState &st
                                     state.edgeRowOffset);
 
     // block pixel positions
-    for (auto &block : (*state.blocks)) {
-        const auto &gridBlock = state.grid_blocks[block.first];
+    for (size_t blockId = 0; blockId < state.blocks.size(); blockId++) {
+        auto &block = *state.blocks[blockId];
+        const auto &gridBlock = state.grid_blocks[blockId];
 
-        block.second.x = state.edgeColumnOffset[gridBlock.col + 1]
-                + state.edgeColumnWidth[gridBlock.col + 1] / 2 - block.second.width / 2;
-        block.second.y = state.rowOffset[gridBlock.row];
+        block.x = state.edgeColumnOffset[gridBlock.col + 1]
+                + state.edgeColumnWidth[gridBlock.col + 1] / 2 - block.width / 2;
+        block.y = state.rowOffset[gridBlock.row];
         if (verticalBlockAlignmentMiddle) {
-            block.second.y += (state.rowHeight[gridBlock.row] - block.second.height) / 2;
+            block.y += (state.rowHeight[gridBlock.row] - block.height) / 2;
         }
     }
     // edge pixel positions
-    for (auto &it : (*state.blocks)) {
-        auto &block = it.second;
+    for (size_t blockId = 0; blockId < state.blocks.size(); blockId++) {
+        auto &block = *state.blocks[blockId];
         for (size_t i = 0; i < block.edges.size(); i++) {
             auto &resultEdge = block.edges[i];
             resultEdge.polyline.clear();
             resultEdge.polyline.push_back(QPointF(0, block.y + block.height));
 
-            const auto &edge = state.edge[it.first][i];
+            const auto &edge = state.edge[state.edgeStart[blockId] + i];
             for (size_t j = 1; j < edge.points.size(); j++) {
                 if (j & 1) { // vertical segment
                     int column = edge.points[j].col;
@@ -1186,7 +1273,7 @@ void GraphGridLayout::convertToPixelCoordinates(GraphGridLayout::LayoutState &st
             }
         }
     }
-    connectEdgeEnds(*state.blocks);
+    connectEdgeEnds(state);
 }
 
 void GraphGridLayout::cropToContent(GraphLayout::Graph &graph, int &width, int &height) const
@@ -1235,13 +1322,13 @@ void GraphGridLayout::cropToContent(GraphLayout::Graph &graph, int &width, int &
     height = maxPos[1] - minPos[1];
 }
 
-void GraphGridLayout::connectEdgeEnds(GraphLayout::Graph &graph) const
+void GraphGridLayout::connectEdgeEnds(LayoutState &state) const
 {
-    for (auto &it : graph) {
-        auto &block = it.second;
+    for (size_t blockId = 0; blockId < state.blocks.size(); blockId++) {
+        auto &block = *state.blocks[blockId];
         for (size_t i = 0; i < block.edges.size(); i++) {
             auto &resultEdge = block.edges[i];
-            const auto &target = graph[resultEdge.target];
+            const auto &target = *state.blocks[state.edge[state.edgeStart[blockId] + i].dest];
             resultEdge.polyline[0].ry() = block.y + block.height;
             resultEdge.polyline.back().ry() = target.y;
         }
@@ -1254,127 +1341,145 @@ using Constraint = std::pair<std::pair<int, int>, int>;
 /**
  * @brief Single pass of linear program optimizer.
  * Changes variables until a constraint is hit, afterwards the two variables are changed together.
- * @param n number of variables
- * @param objectiveFunction coefficients for function \f$\sum c_i x_i\f$ which needs to be minimized
+ *
+ * Groups of variables that are changed together are kept in a union-find structure in which each
+ * variable stores its offset to the parent. The value of a variable is the value of its group
+ * representative plus the offset, so joining groups doesn't require rewriting the constraints.
+ * Each group keeps a copy of its constraints, when joining groups the shorter list is appended to
+ * the longer one. Constraints that became internal to a group are removed lazily.
+ * @param objectiveFunction coefficients for function \f$\sum c_i x_i\f$ which needs to be
+ * minimized, used as scratch space
  * @param inequalities inequality constraints \f$x_{e_i} - x_{f_i} \leq b_i\f$
  * @param equalities equality constraints \f$x_{e_i} - x_{f_i} = b_i\f$
  * @param solution input/output argument, returns results, needs to be initialized with a feasible
  * solution
  * @param stickWhenNotMoving variable grouping strategy
  */
-static void optimizeLinearProgramPass(size_t n, std::vector<int> objectiveFunction,
-                                      std::vector<Constraint> inequalities,
-                                      std::vector<Constraint> equalities,
+static void optimizeLinearProgramPass(std::vector<int> &objectiveFunction,
+                                      const std::vector<Constraint> &inequalities,
+                                      const std::vector<Constraint> &equalities,
                                       std::vector<int> &solution, bool stickWhenNotMoving)
 {
+    const size_t n = solution.size();
+    assert(n == objectiveFunction.size());
     std::vector<int> group(n);
     std::iota(group.begin(), group.end(), 0); // initially each variable is in it's own group
-    assert(n == objectiveFunction.size());
-    assert(n == solution.size());
+    // Variable value relative to the parent in group, 0 for the group representatives
+    std::vector<int> offset(n, 0);
+    std::vector<int> groupSize(n, 1);
+    // Number of constraints between the group and other groups
     std::vector<size_t> edgeCount(n);
 
-    LinkedListPool<size_t> edgePool(inequalities.size() * 2);
-
-    std::vector<decltype(edgePool)::List> edges(n);
-
     auto getGroup = [&](int v) {
-        while (group[v] != v) {
-            group[v] = group[group[v]];
-            v = group[v];
+        int root = v;
+        int rootOffset = 0;
+        while (group[root] != root) {
+            rootOffset += offset[root];
+            root = group[root];
+        }
+        while (group[v] != root) {
+            int next = group[v];
+            int nextOffset = rootOffset - offset[v];
+            group[v] = root;
+            offset[v] = rootOffset;
+            rootOffset = nextOffset;
+            v = next;
         }
-        return v;
+        return root;
     };
-    auto joinGroup = [&](int a, int b) { group[getGroup(b)] = getGroup(a); };
-
-    for (auto &constraint : inequalities) {
-        int a = constraint.first.first;
-        int b = constraint.first.second;
-        size_t index = &constraint - &inequalities.front();
-        edges[a] = edgePool.append(edges[a], edgePool.makeList(index));
-        edges[b] = edgePool.append(edges[b], edgePool.makeList(index));
-        edgeCount[a]++;
-        edgeCount[b]++;
+    // Value of variable v which is in group g, v must be compressed by getGroup
+    auto value = [&](int v, int g) { return solution[g] + offset[v]; };
+
+    for (const auto &constraint : inequalities) {
+        edgeCount[constraint.first.first]++;
+        edgeCount[constraint.first.second]++;
+    }
+    std::vector<std::vector<Constraint>> edges(n);
+    for (size_t i = 0; i < n; i++) {
+        edges[i].reserve(edgeCount[i]);
+    }
+    for (const auto &constraint : inequalities) {
+        edges[constraint.first.first].push_back(constraint);
+        edges[constraint.first.second].push_back(constraint);
     }
     std::vector<uint8_t> processed(n);
     // Smallest variable value in the group relative to main one, this is used to maintain implicit
     // x_i >= 0 constraint
     std::vector<int> groupRelativeMin(n, 0);
 
+    // Attach group b to group a, returns the representative of joined group.
     auto joinSegmentGroups = [&](int a, int b) {
         a = getGroup(a);
         b = getGroup(b);
-        joinGroup(a, b);
-        edgeCount[a] += edgeCount[b];
-        objectiveFunction[a] += objectiveFunction[b];
-        int internalEdgeCount = 0;
-        auto writeIt = edgePool.head(edges[b]);
-        // update inequalities and remove some of the constraints between variables that are now
-        // grouped
-        for (auto it = edgePool.head(edges[b]); it; ++it) {
-            auto &constraint = inequalities[*it];
-            int other = constraint.first.first + constraint.first.second - b;
-            if (getGroup(other)
-                == a) { // skip inequalities where both variables are now in the same group
-                internalEdgeCount++;
+        int longerGroup = edges[a].size() >= edges[b].size() ? a : b;
+        int shorterGroup = longerGroup == a ? b : a;
+        // Count the constraints between two groups using the shorter list, removing them together
+        // with the ones that were already internal.
+        auto &shorter = edges[shorterGroup];
+        size_t betweenEdgeCount = 0;
+        size_t kept = 0;
+        for (const auto &constraint : shorter) {
+            int firstGroup = getGroup(constraint.first.first);
+            int secondGroup = getGroup(constraint.first.second);
+            if (firstGroup == secondGroup) {
                 continue;
             }
-            *writeIt++ = *it;
-            // Modify the inequalities for the group being attached relative to the main variable in
-            // the group to which it is being attached.
-            int diff = solution[a] - solution[b];
-            if (b == constraint.first.first) {
-                constraint.first.first = a;
-                constraint.second += diff;
-            } else {
-                constraint.first.second = a;
-                constraint.second -= diff;
+            if (firstGroup == longerGroup || secondGroup == longerGroup) {
+                betweenEdgeCount++;
+                continue;
             }
+            shorter[kept++] = constraint;
+        }
+        auto &longer = edges[longerGroup];
+        longer.insert(longer.end(), shorter.begin(), shorter.begin() + kept);
+        std::vector<Constraint>().swap(shorter);
+
+        int root = groupSize[a] >= groupSize[b] ? a : b;
+        int child = root == a ? b : a;
+        group[child] = root;
+        offset[child] = solution[child] - solution[root];
+        groupSize[root] += groupSize[child];
+        edgeCount[root] = edgeCount[a] + edgeCount[b] - 2 * betweenEdgeCount;
+        objectiveFunction[root] = objectiveFunction[a] + objectiveFunction[b];
+        groupRelativeMin[root] = std::min(groupRelativeMin[root],
+                                          groupRelativeMin[child] + offset[child]);
+        processed[root] = processed[a];
+        if (root != longerGroup) {
+            std::swap(edges[longerGroup], edges[root]);
         }
-        edges[a] = edgePool.append(edges[a], edgePool.splitHead(edges[b], writeIt));
-        edgeCount[a] -= internalEdgeCount;
-        groupRelativeMin[a] =
-                std::min(groupRelativeMin[a], groupRelativeMin[b] + solution[b] - solution[a]);
+        return root;
     };
 
-    for (auto &equality : equalities) {
+    for (const auto &equality : equalities) {
         // process equalities, assumes that initial solution is feasible solution and matches
         // equality constraints
         int a = getGroup(equality.first.first);
         int b = getGroup(equality.first.second);
         if (a == b) {
-            equality = { { 0, 0 }, 0 };
             continue;
         }
         // always join smallest group to bigger one
         if (edgeCount[a] > edgeCount[b]) {
             std::swap(a, b);
-            // Update the equality equation so that later variable values can be calculated by
-            // simply iterating through them without need to check which direction the group joining
-            // was done.
-            std::swap(equality.first.first, equality.first.second);
-            equality.second = -equality.second;
         }
         joinSegmentGroups(b, a);
-        equality = { { a, b }, solution[a] - solution[b] };
-        processed[a] = 1;
     }
 
     // Priority queue for processing groups starting with currently smallest one. Doing it this way
     // should result in number of constraints within group doubling each time two groups are joined.
-    // That way each constraint is processed no more than log(n) times.
-    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>,
-                        std::greater<std::pair<int, int>>>
+    std::priority_queue<std::pair<size_t, int>, std::vector<std::pair<size_t, int>>,
+                        std::greater<std::pair<size_t, int>>>
             queue;
     for (size_t i = 0; i < n; i++) {
-        if (!processed[i]) {
+        if (group[i] == int(i) && !processed[i]) {
             queue.push({ edgeCount[i], i });
         }
     }
     while (!queue.empty()) {
         int g = queue.top().second;
-        int size = queue.top().first;
+        size_t size = queue.top().first;
         queue.pop();
-        if ((size_t)size != edgeCount[g] || processed[g]) {
+        if (group[g] != g || size != edgeCount[g] || processed[g]) {
             continue;
         }
         int direction = objectiveFunction[g];
@@ -1384,42 +1489,39 @@ static void optimizeLinearProgramPass(size_t n, std::vector<int> objectiveFuncti
         // Find the first constraint which will be hit by changing the variable in the desired
         // direction defined by objective function.
         int limitingGroup = -1;
-        int smallestMove = 0;
-        if (direction < 0) {
-            smallestMove = INT_MAX;
-            for (auto it = edgePool.head(edges[g]); it; ++it) {
-                auto &inequality = inequalities[*it];
-                if (g == inequality.first.second) {
-                    continue;
-                }
-                int other = inequality.first.second;
-                if (getGroup(other) == g) {
+        int smallestMove = direction < 0 ? INT_MAX : -solution[g] - groupRelativeMin[g];
+        auto &groupEdges = edges[g];
+        size_t kept = 0;
+        for (const auto &inequality : groupEdges) {
+            int first = inequality.first.first;
+            int second = inequality.first.second;
+            int firstGroup = getGroup(first);
+            int secondGroup = getGroup(second);
+            if (firstGroup == secondGroup) {
+                continue;
+            }
+            groupEdges[kept++] = inequality;
+            if (direction < 0) {
+                if (firstGroup != g) {
                     continue;
                 }
-                int move = solution[other] + inequality.second - solution[g];
+                int move = value(second, secondGroup) + inequality.second - value(first, g);
                 if (move < smallestMove) {
                     smallestMove = move;
-                    limitingGroup = other;
-                }
-            }
-        } else {
-            smallestMove = -solution[g] - groupRelativeMin[g]; // keep all variables >= 0
-            for (auto it = edgePool.head(edges[g]); it; ++it) {
-                auto &inequality = inequalities[*it];
-                if (g == inequality.first.first) {
-                    continue;
+                    limitingGroup = secondGroup;
                 }
-                int other = inequality.first.first;
-                if (getGroup(other) == g) {
+            } else {
+                if (secondGroup != g) {
                     continue;
                 }
-                int move = solution[other] - inequality.second - solution[g];
+                int move = value(first, firstGroup) - inequality.second - value(second, g);
                 if (move > smallestMove) {
                     smallestMove = move;
-                    limitingGroup = other;
+                    limitingGroup = firstGroup;
                 }
             }
         }
+        groupEdges.resize(kept);
         assert(smallestMove != INT_MAX);
         if (smallestMove == INT_MAX) {
             // Unbound variable, this means that linear program wasn't set up correctly.
@@ -1432,46 +1534,70 @@ static void optimizeLinearProgramPass(size_t n, std::vector<int> objectiveFuncti
         }
         processed[g] = 1;
         if (limitingGroup != -1) {
-            joinSegmentGroups(limitingGroup, g);
-            if (!processed[limitingGroup]) {
-                queue.push({ edgeCount[limitingGroup], limitingGroup });
+            int joined = joinSegmentGroups(limitingGroup, g);
+            if (!processed[joined]) {
+                queue.push({ edgeCount[joined], joined });
             }
-            equalities.push_back({ { g, limitingGroup }, solution[g] - solution[limitingGroup] });
         } // else do nothing if limited by variable >= 0
     }
-    for (auto it = equalities.rbegin(), end = equalities.rend(); it != end; ++it) {
-        solution[it->first.first] = solution[it->first.second] + it->second;
+    for (size_t i = 0; i < n; i++) {
+        int g = getGroup(i);
+        solution[i] = value(i, g);
+    }
+}
+
+/**
+ * @brief Sort the inequalities and remove the redundant ones, keeping the strictest constraint
+ * for each pair of variables.
+ *
+ * Most of the constraints come from neighboring segments, so instead of sorting the whole list
+ * they are distributed by the first variable and only the short runs for each variable get sorted.
+ */
+static void removeRedundantInequalities(size_t n, std::vector<Constraint> &inequalities)
+{
+    std::vector<size_t> start(n + 1, 0);
+    for (const auto &constraint : inequalities) {
+        start[constraint.first.first + 1]++;
+    }
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    std::vector<Constraint> sorted(inequalities.size());
+    {
+        std::vector<size_t> position(start.begin(), start.end() - 1);
+        for (const auto &constraint : inequalities) {
+            sorted[position[constraint.first.first]++] = constraint;
+        }
+    }
+    inequalities.clear();
+    for (size_t i = 0; i < n; i++) {
+        auto begin = sorted.begin() + start[i];
+        auto end = sorted.begin() + start[i + 1];
+        std::sort(begin, end);
+        std::unique_copy(begin, end, std::back_inserter(inequalities),
+                         [](const Constraint &a, const Constraint &b) {
+                             return a.first == b.first;
+                         });
     }
 }
 
 /**
  * @brief Linear programming solver
  * Does not guarantee optimal solution.
- * @param n number of variables
+ *
+ * The vertical pass of the layout is created from the result of the horizontal one, so the two
+ * linear programs can't be solved concurrently. Arguments are taken by value so that callers can
+ * move their vectors in instead of copying them.
  * @param objectiveFunction coefficients for function \f$\sum c_i x_i\f$ which needs to be minimized
  * @param inequalities inequality constraints \f$x_{e_i} - x_{f_i} \leq b_i\f$
  * @param equalities equality constraints \f$x_{e_i} - x_{f_i} = b_i\f$
  * @param solution input/output argument, returns results, needs to be initialized with a feasible
  * solution
  */
-static void optimizeLinearProgram(size_t n, const std::vector<int> &objectiveFunction,
+static void optimizeLinearProgram(std::vector<int> objectiveFunction,
                                   std::vector<Constraint> inequalities,
-                                  const std::vector<Constraint> &equalities,
-                                  std::vector<int> &solution)
+                                  std::vector<Constraint> equalities, std::vector<int> &solution)
 {
-    // Remove redundant inequalities
-    std::sort(inequalities.begin(), inequalities.end());
-    auto uniqueEnd = std::unique(
-            inequalities.begin(), inequalities.end(),
-            [](const Constraint &a, const Constraint &b) { return a.first == b.first; });
-    inequalities.erase(uniqueEnd, inequalities.end());
-
-    static const int ITERATIONS = 1;
-    for (int i = 0; i < ITERATIONS; i++) {
-        optimizeLinearProgramPass(n, objectiveFunction, inequalities, equalities, solution, true);
-        // optimizeLinearProgramPass(n, objectiveFunction, inequalities, equalities, solution,
-        // false);
-    }
+    removeRedundantInequalities(solution.size(), inequalities);
+    optimizeLinearProgramPass(objectiveFunction, inequalities, equalities, solution, true);
 }
 
 namespace {
@@ -1563,12 +1689,13 @@ static void createInequalitiesFromSegments(std::vector<Segment> segments,
 
 void GraphGridLayout::optimizeLayout(GraphGridLayout::LayoutState &state) const
 {
-    std::unordered_map<uint64_t, int> blockMapping;
-    size_t blockIndex = 0;
-    for (auto &blockIt : *state.blocks) {
-        blockMapping[blockIt.first] = blockIndex++;
+    // Variables 0..blockCount-1 are the block positions in graph order, edge segments follow
+    const size_t blockCount = state.blocks.size();
+    std::vector<int> blockVariables(blockCount);
+    for (size_t i = 0; i < blockCount; i++) {
+        blockVariables[state.graphOrder[i]] = static_cast<int>(i);
     }
-    std::vector<size_t> variableGroups(blockMapping.size());
+    std::vector<size_t> variableGroups(blockCount);
     std::iota(variableGroups.begin(), variableGroups.end(), 0);
 
     std::vector<int> objectiveFunction;
@@ -1589,9 +1716,9 @@ void GraphGridLayout::optimizeLayout(GraphGridLayout::LayoutState &state) const
     auto addInequality = [&](size_t a, int posA, size_t b, int posB, int minSpacing) {
         inequalities.push_back(createInequality(a, posA, b, posB, minSpacing, solution));
     };
-    auto addBlockSegmentEquality = [&](ut64 blockId, int edgeVariable, int edgeVariablePos) {
-        int blockPos = (*state.blocks)[blockId].x;
-        int blockVariable = blockMapping[blockId];
+    auto addBlockSegmentEquality = [&](int blockId, int edgeVariable, int edgeVariablePos) {
+        int blockPos = state.blocks[blockId]->x;
+        int blockVariable = blockVariables[blockId];
         equalities.push_back({ { blockVariable, edgeVariable }, blockPos - edgeVariablePos });
     };
     auto setFeasibleSolution = [&](size_t variable, int value) {
@@ -1605,10 +1732,10 @@ void GraphGridLayout::optimizeLayout(GraphGridLayout::LayoutState &state) const
             assert(v >= 0);
         }
 #endif
-        size_t variableIndex = blockMapping.size();
-        for (auto &blockIt : *state.blocks) {
-            auto &block = blockIt.second;
-            for (auto &edge : blockIt.second.edges) {
+        size_t variableIndex = blockCount;
+        for (size_t blockVariable = 0; blockVariable < blockCount; blockVariable++) {
+            auto &block = *state.blocks[state.graphOrder[blockVariable]];
+            for (auto &edge : block.edges) {
                 for (int i = 1 + int(horizontal); i < edge.polyline.size(); i += 2) {
                     int x = solution[variableIndex++];
                     if (horizontal) {
@@ -1620,26 +1747,29 @@ void GraphGridLayout::optimizeLayout(GraphGridLayout::LayoutState &state) const
                     }
                 }
             }
-            int blockVariable = blockMapping[blockIt.first];
             (horizontal ? block.y : block.x) = solution[blockVariable];
         }
     };
 
     std::vector<Segment> segments;
-    segments.reserve(state.blocks->size() * 2 + state.blocks->size() * 2);
-    size_t variableIndex = state.blocks->size();
+    segments.reserve(blockCount * 2 + state.edge.size() * 2);
+    size_t variableIndex = blockCount;
     size_t edgeIndex = 0;
     // horizontal segments
 
-    objectiveFunction.assign(blockMapping.size(), 1);
-    for (auto &blockIt : *state.blocks) {
-        auto &block = blockIt.second;
-        int blockVariable = blockMapping[blockIt.first];
-        for (auto &edge : block.edges) {
-            auto &targetBlock = (*state.blocks)[edge.target];
+    objectiveFunction.assign(blockCount, 1);
+    for (size_t v = 0; v < blockCount; v++) {
+        const int blockId = state.graphOrder[v];
+        auto &block = *state.blocks[blockId];
+        int blockVariable = static_cast<int>(v);
+        for (size_t i = 0; i < block.edges.size(); i++) {
+            auto &edge = block.edges[i];
+            int targetId = state.edge[state.edgeStart[blockId] + i].dest;
+            int targetVariable = blockVariables[targetId];
+            auto &targetBlock = *state.blocks[targetId];
             if (block.y < targetBlock.y) {
                 int spacing = block.height + layoutConfig.blockVerticalSpacing;
-                inequalities.push_back({ { blockVariable, blockMapping[edge.target] }, -spacing });
+                inequalities.push_back({ { blockVariable, targetVariable }, -spacing });
             }
             if (edge.polyline.size() < 3) {
                 continue;
@@ -1652,7 +1782,7 @@ void GraphGridLayout::optimizeLayout(GraphGridLayout::LayoutState &state) const
                 }
                 int x = edge.polyline[i].y();
                 segments.push_back({ x, int(variableIndex), y0, y1 });
-                variableGroups.push_back(blockMapping.size() + edgeIndex);
+                variableGroups.push_back(blockCount + edgeIndex);
                 setFeasibleSolution(variableIndex, x);
                 if (i > 2) {
                     int prevX = edge.polyline[i - 2].y();
@@ -1668,27 +1798,31 @@ void GraphGridLayout::optimizeLayout(GraphGridLayout::LayoutState &state) const
         setFeasibleSolution(blockVariable, block.y);
     }
 
-    createInequalitiesFromSegments(std::move(segments), solution, variableGroups,
-                                   blockMapping.size(), layoutConfig.blockVerticalSpacing,
+    createInequalitiesFromSegments(std::move(segments), solution, variableGroups, blockCount,
+                                   layoutConfig.blockVerticalSpacing,
                                    layoutConfig.edgeVerticalSpacing, inequalities);
 
     objectiveFunction.resize(solution.size());
-    optimizeLinearProgram(solution.size(), objectiveFunction, inequalities, equalities, solution);
+    optimizeLinearProgram(std::move(objectiveFunction), std::move(inequalities),
+                          std::move(equalities), solution);
     copyVariablesToPositions(solution, true);
-    connectEdgeEnds(*state.blocks);
+    connectEdgeEnds(state);
 
     // vertical segments
-    variableGroups.resize(blockMapping.size());
+    variableGroups.resize(blockCount);
     solution.clear();
     equalities.clear();
     inequalities.clear();
     objectiveFunction.clear();
     segments.clear();
-    variableIndex = blockMapping.size();
+    variableIndex = blockCount;
     edgeIndex = 0;
-    for (auto &blockIt : *state.blocks) {
-        auto &block = blockIt.second;
-        for (auto &edge : block.edges) {
+    for (size_t v = 0; v < blockCount; v++) {
+        const int blockId = state.graphOrder[v];
+        auto &block = *state.blocks[blockId];
+        int blockVariable = static_cast<int>(v);
+        for (size_t i = 0; i < block.edges.size(); i++) {
+            auto &edge = block.edges[i];
             if (edge.polyline.size() < 2) {
                 continue;
             }
@@ -1701,7 +1835,7 @@ void GraphGridLayout::optimizeLayout(GraphGridLayout::LayoutState &state) const
                 }
                 int x = edge.polyline[i].x();
                 segments.push_back({ x, int(variableIndex), y0, y1 });
-                variableGroups.push_back(blockMapping.size() + edgeIndex);
+                variableGroups.push_back(blockCount + edgeIndex);
                 setFeasibleSolution(variableIndex, x);
                 if (i > 2) {
                     int prevX = edge.polyline[i - 2].x();
@@ -1710,41 +1844,46 @@ void GraphGridLayout::optimizeLayout(GraphGridLayout::LayoutState &state) const
                 variableIndex++;
             }
             size_t lastEdgeVariableIndex = variableIndex - 1;
-            addBlockSegmentEquality(blockIt.first, firstEdgeVariable, edge.polyline[1].x());
-            addBlockSegmentEquality(edge.target, lastEdgeVariableIndex, segments.back().x);
+            addBlockSegmentEquality(blockId, firstEdgeVariable, edge.polyline[1].x());
+            addBlockSegmentEquality(state.edge[state.edgeStart[blockId] + i].dest,
+                                    lastEdgeVariableIndex, segments.back().x);
             edgeIndex++;
         }
-        int blockVariable = blockMapping[blockIt.first];
         segments.push_back({ block.x, blockVariable, block.y, block.y + block.height });
         segments.push_back(
                 { block.x + block.width, blockVariable, block.y, block.y + block.height });
         setFeasibleSolution(blockVariable, block.x);
     }
 
-    createInequalitiesFromSegments(std::move(segments), solution, variableGroups,
-                                   blockMapping.size(), layoutConfig.blockHorizontalSpacing,
+    createInequalitiesFromSegments(std::move(segments), solution, variableGroups, blockCount,
+                                   layoutConfig.blockHorizontalSpacing,
                                    layoutConfig.edgeHorizontalSpacing, inequalities);
 
     objectiveFunction.resize(solution.size());
     // horizontal centering constraints
-    for (auto &blockIt : *state.blocks) {
-        auto &block = blockIt.second;
-        int blockVariable = blockMapping[blockIt.first];
+    for (size_t v = 0; v < blockCount; v++) {
+        const int blockId = state.graphOrder[v];
+        auto &block = *state.blocks[blockId];
+        int blockVariable = static_cast<int>(v);
         if (block.edges.size() == 2) {
-            auto &blockLeft = (*state.blocks)[block.edges[0].target];
-            auto &blockRight = (*state.blocks)[block.edges[1].target];
+            int leftId = state.edge[state.edgeStart[blockId]].dest;
+            int rightId = state.edge[state.edgeStart[blockId] + 1].dest;
+            int leftVariable = blockVariables[leftId];
+            int rightVariable = blockVariables[rightId];
+            auto &blockLeft = *state.blocks[leftId];
+            auto &blockRight = *state.blocks[rightId];
             auto middle = block.x + block.width / 2;
             if (blockLeft.x + blockLeft.width < middle && blockRight.x > middle) {
-                addInequality(blockMapping[block.edges[0].target], blockLeft.x + blockLeft.width,
-                              blockVariable, middle, layoutConfig.blockHorizontalSpacing / 2);
-                addInequality(blockVariable, middle, blockMapping[block.edges[1].target],
-                              blockRight.x, layoutConfig.blockHorizontalSpacing / 2);
-                auto &gridBlock = state.grid_blocks[blockIt.first];
-                if (gridBlock.mergeBlock) {
-                    auto &mergeBlock = (*state.blocks)[gridBlock.mergeBlock];
+                addInequality(leftVariable, blockLeft.x + blockLeft.width, blockVariable, middle,
+                              layoutConfig.blockHorizontalSpacing / 2);
+                addInequality(blockVariable, middle, rightVariable, blockRight.x,
+                              layoutConfig.blockHorizontalSpacing / 2);
+                auto &gridBlock = state.grid_blocks[blockId];
+                if (gridBlock.mergeBlock != -1) {
+                    auto &mergeBlock = *state.blocks[gridBlock.mergeBlock];
                     if (mergeBlock.x + mergeBlock.width / 2 == middle) {
                         equalities.push_back(
-                                { { blockVariable, blockMapping[gridBlock.mergeBlock] },
+                                { { blockVariable, blockVariables[gridBlock.mergeBlock] },
                                   block.x - mergeBlock.x });
                     }
                 }
@@ -1752,6 +1891,7 @@ void GraphGridLayout::optimizeLayout(GraphGridLayout::LayoutState &state) const
         }
     }
 
-    optimizeLinearProgram(solution.size(), objectiveFunction, inequalities, equalities, solution);
+    optimizeLinearProgram(std::move(objectiveFunction), std::move(inequalities),
+                          std::move(equalities), solution);
     copyVariablesToPositions(solution);
 }
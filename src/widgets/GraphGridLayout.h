@@ -20,11 +20,39 @@ public:
 
     GraphGridLayout(LayoutType layoutType = LayoutType::Medium);
     virtual void CalculateLayout(Graph &blocks, ut64 entry, int &width, int &height) const override;
-    void setTightSubtreePlacement(bool enabled) { tightSubtreePlacement = enabled; }
-    void setParentBetweenDirectChild(bool enabled) { parentBetweenDirectChild = enabled; }
+    void setTightSubtreePlacement(bool enabled)
+    {
+        tightSubtreePlacement = enabled;
+        topologyCache.topology.clear();
+    }
+    void setParentBetweenDirectChild(bool enabled)
+    {
+        parentBetweenDirectChild = enabled;
+        topologyCache.topology.clear();
+    }
     void setverticalBlockAlignmentMiddle(bool enabled) { verticalBlockAlignmentMiddle = enabled; }
     void setLayoutOptimization(bool enabled) { useLayoutOptimization = enabled; }
 
+    /**
+     * @brief Time spent in each step of CalculateLayout in nanoseconds.
+     */
+    struct PhaseTimings
+    {
+        qint64 indexGraph = 0;
+        qint64 topoSort = 0;
+        qint64 blockPlacement = 0;
+        qint64 edgeMainColumn = 0;
+        qint64 roughRouting = 0;
+        qint64 elaborateEdgePlacement = 0;
+        qint64 pixelCoordinates = 0;
+        qint64 optimizeLayout = 0;
+    };
+    /**
+     * @brief Record the duration of each phase of the following layouts in \a timings, nullptr
+     * disables it.
+     */
+    void setPhaseTimings(PhaseTimings *timings) { phaseTimings = timings; }
+
 private:
     /// false - use bounding box for smallest subtree when placing them side by side
     bool tightSubtreePlacement = false;
@@ -33,12 +61,12 @@ private:
     /// false if blocks in rows should be aligned at top, true for middle alignment
     bool verticalBlockAlignmentMiddle = false;
     bool useLayoutOptimization = true;
+    PhaseTimings *phaseTimings = nullptr;
 
     struct GridBlock
     {
-        ut64 id;
-        std::vector<ut64> tree_edge; //!< subset of outgoing edges that form a tree
-        std::vector<ut64> dag_edge; //!< subset of outgoing edges that form a dag
+        std::vector<int> tree_edge; //!< subset of outgoing edges that form a tree
+        std::vector<int> dag_edge; //!< subset of outgoing edges that form a dag
         std::size_t has_parent = false;
         int inputCount = 0;
         int outputCount = 0;
@@ -50,7 +78,7 @@ private:
         /// Row in which the block is
         int row = 0;
 
-        ut64 mergeBlock = 0;
+        int mergeBlock = -1; //!< block where the control flow merges, -1 if there is none
 
         int lastRowLeft; //!< left side of subtree last row
         int lastRowRight; //!< right side of subtree last row
@@ -71,7 +99,7 @@ private:
 
     struct GridEdge
     {
-        ut64 dest;
+        int dest;
         int mainColumn = -1;
         std::vector<Point> points;
         int secondaryPriority;
@@ -82,11 +110,21 @@ private:
         }
     };
 
+    /**
+     * @brief Layout state of a graph with blocks numbered 0..n-1 in the iteration order of the
+     * input graph. All the per block and per edge data is stored in flat arrays indexed by these
+     * numbers, the input graph is only accessed by address when building the state.
+     */
     struct LayoutState
     {
-        std::unordered_map<ut64, GridBlock> grid_blocks;
-        std::unordered_map<ut64, GraphBlock> *blocks = nullptr;
-        std::unordered_map<ut64, std::vector<GridEdge>> edge;
+        std::vector<GridBlock> grid_blocks;
+        std::vector<GraphBlock *> blocks;
+        /// Block indices in the iteration order of the input graph
+        std::vector<int> graphOrder;
+        /// Edges of block i are edge[edgeStart[i]] .. edge[edgeStart[i + 1] - 1] in the order of
+        /// GraphBlock::edges
+        std::vector<GridEdge> edge;
+        std::vector<size_t> edgeStart;
         size_t rows = -1;
         size_t columns = -1;
         std::vector<int> columnWidth;
@@ -100,8 +138,31 @@ private:
         std::vector<int> edgeRowOffset;
     };
 
-    using GridBlockMap = std::unordered_map<ut64, GridBlock>;
+    /**
+     * @brief Layout state of the previous CalculateLayout call after the steps which only depend
+     * on the graph structure. Layouts of graphs with the same blocks and edges in the same order,
+     * e.g. after a comment changed the size of a block, start from it instead of from scratch.
+     */
+    struct TopologyCache
+    {
+        /// Output of topologyKey for the graph the state belongs to, empty if there is none
+        std::vector<ut64> topology;
+        /// Address of each block index
+        std::vector<ut64> addresses;
+        LayoutState state;
+    };
+    mutable TopologyCache topologyCache;
 
+    /**
+     * @brief Entry, block addresses and edge targets in iteration order. Graphs with equal keys get
+     * the same block numbering and grid placement.
+     */
+    static std::vector<ut64> topologyKey(const Graph &blocks, ut64 entry);
+    /**
+     * @brief Number the blocks of the graph and build the edge arrays.
+     * @return Index of the entry block
+     */
+    static int indexGraph(Graph &blocks, ut64 entry, LayoutState &state);
     /**
      * @brief Find nodes where control flow merges after splitting.
      * Sets node column offset so that after computing placement merge point is centered bellow
@@ -112,7 +173,7 @@ private:
      * @brief Compute node rows and columns within grid.
      * @param blockOrder Nodes in the reverse topological order.
      */
-    void computeAllBlockPlacement(const std::vector<ut64> &blockOrder,
+    void computeAllBlockPlacement(const std::vector<int> &blockOrder,
                                   LayoutState &layoutState) const;
     /**
      * @brief Perform the topological sorting of graph nodes.
@@ -122,24 +183,20 @@ private:
      * @param entry Entrypoint node. When removing loops prefer placing this node at top.
      * @return Reverse topological ordering.
      */
-    static std::vector<ut64> topoSort(LayoutState &state, ut64 entry);
+    static std::vector<int> topoSort(LayoutState &state, int entry);
 
     /**
      * @brief Assign row positions to nodes.
      * @param state
      * @param blockOrder reverse topological ordering of nodes
      */
-    static void assignRows(LayoutState &state, const std::vector<ut64> &blockOrder);
+    static void assignRows(LayoutState &state, const std::vector<int> &blockOrder);
     /**
      * @brief Select subset of DAG edges that form tree.
      * @param state
      */
     static void selectTree(LayoutState &state);
 
-    /**
-     * @brief routeEdges Route edges, expects node positions to be calculated previously.
-     */
-    void routeEdges(LayoutState &state) const;
     /**
      * @brief Choose which column to use for transition from start node row to target node row.
      */
@@ -186,9 +243,9 @@ private:
     void cropToContent(Graph &graph, int &width, int &height) const;
     /**
      * @brief Connect edge ends to blocks by changing y.
-     * @param graph
+     * @param state
      */
-    void connectEdgeEnds(Graph &graph) const;
+    void connectEdgeEnds(LayoutState &state) const;
     /**
      * @brief Reduce spacing between nodes and edges by pushing everything together ignoring the
      * grid.
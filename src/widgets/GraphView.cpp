@@ -8,11 +8,13 @@
 #include "Helpers.h"
 
 #include <vector>
+#include <algorithm>
 #include <QPainter>
 #include <QMouseEvent>
 #include <QKeyEvent>
 #include <QPropertyAnimation>
 #include <QSvgGenerator>
+#include <QtMath>
 
 #ifndef CUTTER_NO_OPENGL_GRAPH
 #    include <QOpenGLContext>
@@ -21,6 +23,15 @@
 #    include <QOpenGLExtraFunctions>
 #endif
 
+// Edge length of the cached graph tiles in device pixels
+static const int kTileSize = 256;
+// Blocks smaller than this on screen are drawn by drawBlockOverview()
+static const qreal kMinBlockDetailSize = 4;
+// Total number of blocks and edges of the cached layouts
+static const int kLayoutCacheCost = 100000;
+// Ids of custom layout objects, above the ones of the predefined layouts
+static quint64 nextCustomLayoutId = 1ULL << 32;
+
 GraphView::GraphView(QWidget *parent)
     : QAbstractScrollArea(parent),
       useGL(false)
@@ -38,13 +49,19 @@ GraphView::GraphView(QWidget *parent)
         glWidget = nullptr;
     }
 #endif
-    setGraphLayout(makeGraphLayout(Layout::GridMedium));
+    layoutCache.setMaxCost(kLayoutCacheCost);
+    setGraphLayout(Layout::GridMedium);
 }
 
 GraphView::~GraphView() {}
 
 // Callbacks
 
+void GraphView::drawBlockOverview(QPainter &p, GraphView::GraphBlock &block, bool interactive)
+{
+    drawBlock(p, block, interactive);
+}
+
 void GraphView::blockClicked(GraphView::GraphBlock &block, QMouseEvent *event, QPoint pos)
 {
     Q_UNUSED(block);
@@ -129,12 +146,76 @@ void GraphView::contextMenuEvent(QContextMenuEvent *event)
 
 void GraphView::computeGraphPlacement()
 {
-    graphLayoutSystem->CalculateLayout(blocks, entry, width, height);
+    const QPair<ut64, uint> key(entry, layoutCacheHash());
+    CachedLayout *cached = layoutCache.object(key);
+    if (!cached || !restoreCachedLayout(*cached)) {
+        graphLayoutSystem->CalculateLayout(blocks, entry, width, height);
+        int cost = static_cast<int>(blocks.size());
+        for (const auto &blockIt : blocks) {
+            cost += static_cast<int>(blockIt.second.edges.size());
+        }
+        layoutCache.insert(key,
+                           new CachedLayout { layoutId, layoutConfig, blocks, width, height },
+                           cost);
+    }
     setCacheDirty();
     clampViewOffset();
     viewport()->update();
 }
 
+uint GraphView::layoutCacheHash() const
+{
+    std::vector<quint64> data;
+    data.reserve(blocks.size() * 5 + 5);
+    data.push_back(layoutId);
+    data.push_back(layoutConfig.blockHorizontalSpacing);
+    data.push_back(layoutConfig.blockVerticalSpacing);
+    data.push_back(layoutConfig.edgeHorizontalSpacing);
+    data.push_back(layoutConfig.edgeVerticalSpacing);
+    for (const auto &blockIt : blocks) {
+        const GraphBlock &block = blockIt.second;
+        data.push_back(blockIt.first);
+        data.push_back(block.width);
+        data.push_back(block.height);
+        for (const GraphEdge &edge : block.edges) {
+            data.push_back(edge.target);
+        }
+        data.push_back(block.edges.size());
+    }
+    return qHashBits(data.data(), data.size() * sizeof(quint64));
+}
+
+bool GraphView::restoreCachedLayout(const CachedLayout &cached)
+{
+    if (cached.layoutId != layoutId
+        || cached.config.blockHorizontalSpacing != layoutConfig.blockHorizontalSpacing
+        || cached.config.blockVerticalSpacing != layoutConfig.blockVerticalSpacing
+        || cached.config.edgeHorizontalSpacing != layoutConfig.edgeHorizontalSpacing
+        || cached.config.edgeVerticalSpacing != layoutConfig.edgeVerticalSpacing) {
+        return false;
+    }
+    // The layout may have added blocks for edge targets outside of the graph, but every block of
+    // the graph must be there unchanged
+    for (const auto &blockIt : blocks) {
+        const GraphBlock &block = blockIt.second;
+        auto cachedIt = cached.blocks.find(blockIt.first);
+        if (cachedIt == cached.blocks.end() || cachedIt->second.width != block.width
+            || cachedIt->second.height != block.height
+            || cachedIt->second.edges.size() != block.edges.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < block.edges.size(); i++) {
+            if (cachedIt->second.edges[i].target != block.edges[i].target) {
+                return false;
+            }
+        }
+    }
+    blocks = cached.blocks;
+    width = cached.width;
+    height = cached.height;
+    return true;
+}
+
 void GraphView::cleanupEdges(GraphLayout::Graph &graph)
 {
     for (auto &blockIt : graph) {
@@ -173,48 +254,31 @@ void GraphView::setViewScale(qreal scale)
     emit viewScaleChanged(scale);
 }
 
-QSize GraphView::getCacheSize()
-{
-    return
-#ifndef CUTTER_NO_OPENGL_GRAPH
-            useGL ? cacheSize :
-#endif
-                  pixmap.size();
-}
-
-qreal GraphView::getCacheDevicePixelRatioF()
-{
-    return
-#ifndef CUTTER_NO_OPENGL_GRAPH
-            useGL ? 1.0 :
-#endif
-                  qhelpers::devicePixelRatio(&pixmap);
-}
-
 QSize GraphView::getRequiredCacheSize()
 {
     return viewport()->size() * qhelpers::devicePixelRatio(this);
 }
 
-qreal GraphView::getRequiredCacheDevicePixelRatioF()
+void GraphView::paintEvent(QPaintEvent *event)
 {
-    return
-#ifndef CUTTER_NO_OPENGL_GRAPH
-            useGL ? 1.0f :
-#endif
-                  qhelpers::devicePixelRatio(this);
-}
+    // Anything but moving the view may have changed what is drawn, e.g. a highlight that was
+    // updated without marking the cache dirty
+    if (!onlyViewMoved) {
+        setCacheDirty();
+    }
+    onlyViewMoved = false;
 
-void GraphView::paintEvent(QPaintEvent *)
-{
-#ifndef CUTTER_NO_OPENGL_GRAPH
-    if (useGL) {
-        glWidget->makeCurrent();
+    if (!useGL) {
+        paintTiles(event->rect());
+        return;
     }
-#endif
 
-    if (!qFuzzyCompare(getCacheDevicePixelRatioF(), getRequiredCacheDevicePixelRatioF())
-        || getCacheSize() != getRequiredCacheSize()) {
+#ifndef CUTTER_NO_OPENGL_GRAPH
+    glWidget->makeCurrent();
+
+    // The framebuffer only holds the visible part of the graph
+    if (cacheSize != getRequiredCacheSize() || cacheOffset != offset
+        || cacheScale != current_scale) {
         setCacheDirty();
     }
 
@@ -223,23 +287,80 @@ void GraphView::paintEvent(QPaintEvent *)
         cacheDirty = false;
     }
 
-    if (useGL) {
-#ifndef CUTTER_NO_OPENGL_GRAPH
-        auto gl = glWidget->context()->extraFunctions();
-        gl->glBindFramebuffer(GL_READ_FRAMEBUFFER, cacheFBO);
-        gl->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, glWidget->defaultFramebufferObject());
-        auto dpr = qhelpers::devicePixelRatio(this);
-        gl->glBlitFramebuffer(0, 0, cacheSize.width(), cacheSize.height(), 0, 0,
-                              viewport()->width() * dpr, viewport()->height() * dpr,
-                              GL_COLOR_BUFFER_BIT, GL_NEAREST);
-        glWidget->doneCurrent();
+    auto gl = glWidget->context()->extraFunctions();
+    gl->glBindFramebuffer(GL_READ_FRAMEBUFFER, cacheFBO);
+    gl->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, glWidget->defaultFramebufferObject());
+    auto dpr = qhelpers::devicePixelRatio(this);
+    gl->glBlitFramebuffer(0, 0, cacheSize.width(), cacheSize.height(), 0, 0,
+                          viewport()->width() * dpr, viewport()->height() * dpr,
+                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glWidget->doneCurrent();
 #endif
-    } else {
-        QPainter p(viewport());
-        p.drawPixmap(QPoint(0, 0), pixmap);
+}
+
+void GraphView::paintTiles(const QRect &area)
+{
+    const qreal dpr = qhelpers::devicePixelRatio(this);
+    if (cacheDirty || tileScale != current_scale || tileDevicePixelRatio != dpr) {
+        tileCache.clear();
+        tileScale = current_scale;
+        tileDevicePixelRatio = dpr;
+        cacheDirty = false;
+    }
+
+    // Tiles are aligned to device pixels of the whole graph at the current scale, the view
+    // offset is rounded to whole device pixels so they can be copied without resampling
+    const qreal deviceScale = tileScale * dpr;
+    const QPoint origin(qRound(offset.x() * deviceScale), qRound(offset.y() * deviceScale));
+    const QRect deviceArea(origin.x() + qFloor(area.x() * dpr), origin.y() + qFloor(area.y() * dpr),
+                           qCeil(area.width() * dpr) + 1, qCeil(area.height() * dpr) + 1);
+    auto tileIndex = [](int pos) {
+        return pos >= 0 ? pos / kTileSize : -((kTileSize - 1 - pos) / kTileSize);
+    };
+    const int firstX = tileIndex(deviceArea.left());
+    const int lastX = tileIndex(deviceArea.right());
+    const int firstY = tileIndex(deviceArea.top());
+    const int lastY = tileIndex(deviceArea.bottom());
+
+    // Keep two screens worth of tiles, so panning back and forth doesn't render again
+    const QSize deviceSize = viewport()->size() * dpr;
+    const int screenTiles =
+            (deviceSize.width() / kTileSize + 2) * (deviceSize.height() / kTileSize + 2);
+    tileCache.setMaxCost(2 * screenTiles);
+
+    QPainter p(viewport());
+    for (int y = firstY; y <= lastY; y++) {
+        for (int x = firstX; x <= lastX; x++) {
+            const QPair<int, int> key(x, y);
+            QPixmap *tile = tileCache.object(key);
+            if (!tile) {
+                tile = new QPixmap(renderTile(x, y));
+                tileCache.insert(key, tile);
+            }
+            p.drawPixmap(QPointF((x * kTileSize - origin.x()) / dpr,
+                                 (y * kTileSize - origin.y()) / dpr),
+                         *tile);
+        }
     }
 }
 
+QPixmap GraphView::renderTile(int x, int y)
+{
+    QPixmap tile(kTileSize, kTileSize);
+    tile.setDevicePixelRatio(tileDevicePixelRatio);
+    tile.fill(backgroundColor);
+
+    const qreal deviceScale = tileScale * tileDevicePixelRatio;
+    QRectF window(x * kTileSize / deviceScale, y * kTileSize / deviceScale,
+                  kTileSize / deviceScale, kTileSize / deviceScale);
+    QPainter p(&tile);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.scale(tileScale, tileScale);
+    p.translate(-window.topLeft());
+    paintContent(p, window, tileScale, true);
+    return tile;
+}
+
 void GraphView::clampViewOffset()
 {
     const qreal edgeFraction = 0.25;
@@ -253,6 +374,7 @@ void GraphView::clampViewOffset()
 
 void GraphView::setViewOffsetInternal(QPoint pos, bool emitSignal)
 {
+    onlyViewMoved = true;
     offset = pos;
     clampViewOffset();
     if (emitSignal)
@@ -268,65 +390,52 @@ void GraphView::paintGraphCache()
 {
 #ifndef CUTTER_NO_OPENGL_GRAPH
     std::unique_ptr<QOpenGLPaintDevice> paintDevice;
-#endif
     QPainter p;
-    if (useGL) {
-#ifndef CUTTER_NO_OPENGL_GRAPH
-        auto gl = QOpenGLContext::currentContext()->functions();
-
-        bool resizeTex = false;
-        QSize sizeNeed = getRequiredCacheSize();
-        if (!cacheTexture) {
-            gl->glGenTextures(1, &cacheTexture);
-            gl->glBindTexture(GL_TEXTURE_2D, cacheTexture);
-            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            resizeTex = true;
-        } else if (cacheSize != sizeNeed) {
-            gl->glBindTexture(GL_TEXTURE_2D, cacheTexture);
-            resizeTex = true;
-        }
-        if (resizeTex) {
-            cacheSize = sizeNeed;
-            gl->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, cacheSize.width(), cacheSize.height(), 0,
-                             GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-            gl->glGenFramebuffers(1, &cacheFBO);
-            gl->glBindFramebuffer(GL_FRAMEBUFFER, cacheFBO);
-            gl->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
-                                       cacheTexture, 0);
-        } else {
-            gl->glBindFramebuffer(GL_FRAMEBUFFER, cacheFBO);
-        }
-        gl->glViewport(0, 0, viewport()->width(), viewport()->height());
-        gl->glClearColor(backgroundColor.redF(), backgroundColor.greenF(), backgroundColor.blueF(),
-                         1.0f);
-        gl->glClear(GL_COLOR_BUFFER_BIT);
-
-        paintDevice.reset(new QOpenGLPaintDevice(cacheSize));
-        p.begin(paintDevice.get());
-#endif
+    auto gl = QOpenGLContext::currentContext()->functions();
+
+    bool resizeTex = false;
+    QSize sizeNeed = getRequiredCacheSize();
+    if (!cacheTexture) {
+        gl->glGenTextures(1, &cacheTexture);
+        gl->glBindTexture(GL_TEXTURE_2D, cacheTexture);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        resizeTex = true;
+    } else if (cacheSize != sizeNeed) {
+        gl->glBindTexture(GL_TEXTURE_2D, cacheTexture);
+        resizeTex = true;
+    }
+    if (resizeTex) {
+        cacheSize = sizeNeed;
+        gl->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, cacheSize.width(), cacheSize.height(), 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        gl->glGenFramebuffers(1, &cacheFBO);
+        gl->glBindFramebuffer(GL_FRAMEBUFFER, cacheFBO);
+        gl->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                                   cacheTexture, 0);
     } else {
-        auto dpr = qhelpers::devicePixelRatio(this);
-        pixmap = QPixmap(getRequiredCacheSize() * dpr);
-        pixmap.setDevicePixelRatio(dpr);
-        pixmap.fill(backgroundColor);
-        p.begin(&pixmap);
-        p.setRenderHint(QPainter::Antialiasing);
-        p.setViewport(this->viewport()->rect());
+        gl->glBindFramebuffer(GL_FRAMEBUFFER, cacheFBO);
     }
+    gl->glViewport(0, 0, viewport()->width(), viewport()->height());
+    gl->glClearColor(backgroundColor.redF(), backgroundColor.greenF(), backgroundColor.blueF(),
+                     1.0f);
+    gl->glClear(GL_COLOR_BUFFER_BIT);
+
+    paintDevice.reset(new QOpenGLPaintDevice(cacheSize));
+    p.begin(paintDevice.get());
     paint(p, offset, this->viewport()->rect(), current_scale);
+    cacheOffset = offset;
+    cacheScale = current_scale;
 
     p.end();
+#endif
 }
 
 void GraphView::paint(QPainter &p, QPoint offset, QRect viewport, qreal scale, bool interactive)
 {
-    QPointF offsetF(offset.x(), offset.y());
-    p.setBrush(Qt::black);
-
     int render_width = viewport.width();
     int render_height = viewport.height();
 
@@ -335,6 +444,12 @@ void GraphView::paint(QPainter &p, QPoint offset, QRect viewport, qreal scale, b
             QRect(offset, QSize(qRound(render_width / scale), qRound(render_height / scale)));
     p.setWindow(window);
     QRectF windowF(window.x(), window.y(), window.width(), window.height());
+    paintContent(p, windowF, scale, interactive);
+}
+
+void GraphView::paintContent(QPainter &p, const QRectF &window, qreal scale, bool interactive)
+{
+    p.setBrush(Qt::black);
 
     for (auto &blockIt : blocks) {
         GraphBlock &block = blockIt.second;
@@ -342,14 +457,16 @@ void GraphView::paint(QPainter &p, QPoint offset, QRect viewport, qreal scale, b
         QRectF blockRect(block.x, block.y, block.width, block.height);
 
         // Check if block is visible by checking if block intersects with view area
-        if (blockRect.intersects(windowF)) {
-            drawBlock(p, block, interactive);
+        if (blockRect.intersects(window)) {
+            if (std::min(block.width, block.height) * scale < kMinBlockDetailSize) {
+                drawBlockOverview(p, block, interactive);
+            } else {
+                drawBlock(p, block, interactive);
+            }
         }
 
         p.setBrush(Qt::gray);
 
-        // Always draw edges
-        // TODO: Only draw edges if they are actually visible ...
         // Draw edges
         for (GraphEdge &edge : block.edges) {
             if (edge.polyline.empty()) {
@@ -366,6 +483,14 @@ void GraphView::paint(QPainter &p, QPoint offset, QRect viewport, qreal scale, b
             if (pen.widthF() * scale < 2) {
                 pen.setWidth(0);
             }
+
+            // Arrows stick out of the polyline by at most their length
+            const qreal margin = std::max<qreal>(6, pen.widthF());
+            if (!polyline.boundingRect().adjusted(-margin, -margin, margin, margin).intersects(
+                        window)) {
+                continue;
+            }
+
             p.setPen(pen);
             p.setBrush(ec.color);
             p.drawPolyline(polyline);
@@ -533,14 +658,25 @@ QPoint GraphView::logicalToViewCoordinates(QPoint p)
 
 void GraphView::setGraphLayout(std::unique_ptr<GraphLayout> layout)
 {
-    graphLayoutSystem = std::move(layout);
-    if (!graphLayoutSystem) {
-        graphLayoutSystem = makeGraphLayout(Layout::GridMedium);
+    if (!layout) {
+        setGraphLayout(Layout::GridMedium);
+        return;
     }
+    graphLayoutSystem = std::move(layout);
+    graphLayoutSystem->setLayoutConfig(layoutConfig);
+    layoutId = nextCustomLayoutId++;
+}
+
+void GraphView::setGraphLayout(GraphView::Layout layout, bool horizontal)
+{
+    graphLayoutSystem = makeGraphLayout(layout, horizontal);
+    graphLayoutSystem->setLayoutConfig(layoutConfig);
+    layoutId = (static_cast<quint64>(layout) << 1) | (horizontal ? 1 : 0);
 }
 
 void GraphView::setLayoutConfig(const GraphLayout::LayoutConfig &config)
 {
+    layoutConfig = config;
     graphLayoutSystem->setLayoutConfig(config);
 }
 
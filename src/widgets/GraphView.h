@@ -9,6 +9,9 @@
 #include <QElapsedTimer>
 #include <QHelpEvent>
 #include <QGestureEvent>
+#include <QCache>
+#include <QPair>
+#include <QPixmap>
 
 #include <unordered_map>
 #include <unordered_set>
@@ -92,6 +95,11 @@ public:
     QPoint logicalToViewCoordinates(QPoint p);
 
     void setGraphLayout(std::unique_ptr<GraphLayout> layout);
+    /**
+     * @brief Use one of the predefined layouts. Unlike with a custom layout object, results
+     * computed by the same kind of layout earlier are kept in the layout cache.
+     */
+    void setGraphLayout(Layout layout, bool horizontal = false);
     GraphLayout &getGraphLayout() const { return *graphLayoutSystem; }
     void setLayoutConfig(const GraphLayout::LayoutConfig &config);
 
@@ -130,6 +138,12 @@ protected:
      * @param interactive - can be used for disabling elemnts during export
      */
     virtual void drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive = true) = 0;
+    /**
+     * @brief Draw a block that covers only a few pixels on screen, where the details drawn by
+     * drawBlock() can't be made out anyway. Calls drawBlock() by default.
+     */
+    virtual void drawBlockOverview(QPainter &p, GraphView::GraphBlock &block,
+                                   bool interactive = true);
     virtual void blockClicked(GraphView::GraphBlock &block, QMouseEvent *event, QPoint pos);
     virtual void blockDoubleClicked(GraphView::GraphBlock &block, QMouseEvent *event, QPoint pos);
     virtual void blockHelpEvent(GraphView::GraphBlock &block, QHelpEvent *event, QPoint pos);
@@ -177,6 +191,12 @@ private:
     void centerY(bool emitSignal);
 
     void paintGraphCache();
+    /**
+     * @brief Draw the graph in logical coordinates, skipping blocks and edges outside of window
+     */
+    void paintContent(QPainter &p, const QRectF &window, qreal scale, bool interactive);
+    void paintTiles(const QRect &area);
+    QPixmap renderTile(int x, int y);
 
     bool checkPointClicked(QPointF &point, int x, int y, bool above_y = false);
 
@@ -188,6 +208,36 @@ private:
     ut64 entry = 0;
 
     std::unique_ptr<GraphLayout> graphLayoutSystem;
+    GraphLayout::LayoutConfig layoutConfig;
+
+    /**
+     * @brief Result of an earlier computeGraphPlacement(), reused when the same graph is laid out
+     * again, e.g. when navigating back to a function.
+     */
+    struct CachedLayout
+    {
+        quint64 layoutId;
+        GraphLayout::LayoutConfig config;
+        GraphLayout::Graph blocks;
+        int width;
+        int height;
+    };
+    /**
+     * @brief Results indexed by entry and layoutCacheHash(), the cost of an entry is the number of
+     * its blocks and edges.
+     */
+    QCache<QPair<ut64, uint>, CachedLayout> layoutCache;
+    /**
+     * @brief Identifies the kind of layout in use, each custom layout object gets a new one
+     */
+    quint64 layoutId = 0;
+
+    uint layoutCacheHash() const;
+    /**
+     * @brief Take over the positions from \a cached if it was computed for the current graph and
+     * layout.
+     */
+    bool restoreCachedLayout(const CachedLayout &cached);
 
     QPoint scrollBase;
     bool scroll_mode = false;
@@ -195,14 +245,19 @@ private:
     bool useGL;
 
     /**
-     * @brief pixmap that caches the graph nodes
+     * @brief Rendered tiles of the graph at tileScale, indexed by tile column and row. Moving the
+     * view only renders the tiles that come into sight.
      */
-    QPixmap pixmap;
+    QCache<QPair<int, int>, QPixmap> tileCache;
+    qreal tileScale = 0;
+    qreal tileDevicePixelRatio = 0;
 
 #ifndef CUTTER_NO_OPENGL_GRAPH
     uint32_t cacheTexture;
     uint32_t cacheFBO;
     QSize cacheSize;
+    QPoint cacheOffset;
+    qreal cacheScale = 0;
     QOpenGLWidget *glWidget;
 #endif
 
@@ -210,10 +265,12 @@ private:
      * @brief flag to control if the cache is invalid and should be re-created in the next draw
      */
     bool cacheDirty = true;
-    QSize getCacheSize();
-    qreal getCacheDevicePixelRatioF();
+    /**
+     * @brief Set when the view offset changed, the next paint keeps the cache if nothing else
+     * requested it
+     */
+    bool onlyViewMoved = false;
     QSize getRequiredCacheSize();
-    qreal getRequiredCacheDevicePixelRatioF();
 
     void beginMouseDrag(QMouseEvent *event);
 
@@ -213,6 +213,7 @@ void HeapBinsGraphView::blockContextMenuRequested(GraphView::GraphBlock &block,
     if (haveAddresses) {
         const auto &content = blockContent[block.entry];
         selectedBlock = content.address;
+        setCacheDirty();
         addressableItemContextMenu.setTarget(content.address, content.text);
         QPoint pos = event->globalPos();
 
@@ -0,0 +1,204 @@
+#include "HeapMapWidget.h"
+#include "common/Configuration.h"
+#include "common/Helpers.h"
+
+#include <QCursor>
+#include <QImage>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QToolTip>
+#include <QWheelEvent>
+
+#include <algorithm>
+#include <limits>
+
+void HeapChunkIndex::build(const QVector<Chunk> &chunks)
+{
+    offsets.resize(chunks.size());
+    sizes.resize(chunks.size());
+    chunkFlags.resize(chunks.size());
+    sizeClasses.resize(chunks.size());
+    for (int i = 0; i < chunks.size(); i++) {
+        const Chunk &chunk = chunks[i];
+        ut64 size = chunk.size;
+        offsets[i] = chunk.offset;
+        sizes[i] = size;
+        quint8 flags = 0;
+        if (chunk.status == QLatin1String("free")) {
+            flags |= Free;
+        } else if (chunk.status == QLatin1String("corrupted")) {
+            flags |= Corrupted;
+        }
+        chunkFlags[i] = flags;
+        sizeClasses[i] = size ? static_cast<quint8>(63 - qCountLeadingZeroBits(size)) : 0;
+    }
+}
+
+int HeapChunkIndex::find(RVA addr) const
+{
+    auto it = std::upper_bound(offsets.constBegin(), offsets.constEnd(), addr);
+    if (it == offsets.constBegin()) {
+        return -1;
+    }
+    int i = static_cast<int>(it - offsets.constBegin()) - 1;
+    return addr < offsets[i] + sizes[i] ? i : -1;
+}
+
+HeapMapWidget::HeapMapWidget(QWidget *parent) : QAbstractScrollArea(parent)
+{
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    viewport()->setMouseTracking(true);
+}
+
+void HeapMapWidget::setChunks(const QVector<Chunk> &chunks)
+{
+    index.build(chunks);
+    updateScrollBars();
+    viewport()->update();
+}
+
+ut64 HeapMapWidget::bytesPerRow() const
+{
+    return static_cast<ut64>(std::max(viewport()->width(), 1)) * bytesPerPixel;
+}
+
+RVA HeapMapWidget::addressAt(const QPoint &pos) const
+{
+    if (index.isEmpty() || pos.x() < 0 || pos.y() < 0 || pos.x() >= viewport()->width()) {
+        return RVA_INVALID;
+    }
+    ut64 row = static_cast<ut64>(verticalScrollBar()->value() + pos.y());
+    return index.begin() + row * bytesPerRow() + static_cast<ut64>(pos.x()) * bytesPerPixel;
+}
+
+QRgb HeapMapWidget::chunkColor(int i) const
+{
+    const quint8 flags = index.flags(i);
+    if (flags & HeapChunkIndex::Corrupted) {
+        return ConfigColor("gui.navbar.err").rgba();
+    }
+    // Neighbouring size classes get clearly different hues
+    int hue = (index.sizeClass(i) * 47) % 360;
+    if (flags & HeapChunkIndex::Free) {
+        return QColor::fromHsv(hue, 40, 110).rgba();
+    }
+    return QColor::fromHsv(hue, 170, 230).rgba();
+}
+
+void HeapMapWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(viewport());
+    const QColor background = ConfigColor("gui.background");
+    const int w = viewport()->width();
+    const int h = viewport()->height();
+    if (index.isEmpty() || w <= 0 || h <= 0) {
+        painter.fillRect(viewport()->rect(), background);
+        return;
+    }
+
+    QImage image(w, h, QImage::Format_ARGB32);
+    image.fill(background);
+    const RVA end = index.end();
+    int chunk = -1;
+    for (int y = 0; y < h; y++) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        RVA addr = addressAt(QPoint(0, y));
+        for (int x = 0; x < w && addr < end; x++, addr += bytesPerPixel) {
+            // Addresses only grow, so the previous chunk is usually still the right one
+            if (chunk < 0 || addr < index.offset(chunk)
+                || addr >= index.offset(chunk) + index.size(chunk)) {
+                chunk = index.find(addr);
+                if (chunk < 0) {
+                    continue;
+                }
+            }
+            QRgb color = chunkColor(chunk);
+            // Mark where large enough chunks start
+            if (index.offset(chunk) + bytesPerPixel > addr
+                && index.size(chunk) >= 4 * bytesPerPixel) {
+                color = QColor(color).darker(140).rgba();
+            }
+            line[x] = color;
+        }
+        if (addr >= end) {
+            break;
+        }
+    }
+    painter.drawImage(0, 0, image);
+}
+
+void HeapMapWidget::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void HeapMapWidget::scrollContentsBy(int, int)
+{
+    viewport()->update();
+}
+
+void HeapMapWidget::updateScrollBars()
+{
+    const ut64 heapSize = index.end() - index.begin();
+    const ut64 rowBytes = bytesPerRow();
+    const int rows = static_cast<int>(std::min<ut64>((heapSize + rowBytes - 1) / rowBytes,
+                                                     std::numeric_limits<int>::max()));
+    verticalScrollBar()->setPageStep(viewport()->height());
+    verticalScrollBar()->setRange(0, std::max(0, rows - viewport()->height()));
+}
+
+void HeapMapWidget::wheelEvent(QWheelEvent *event)
+{
+    if (!(event->modifiers() & Qt::ControlModifier)) {
+        QAbstractScrollArea::wheelEvent(event);
+        return;
+    }
+    int dy = event->angleDelta().y();
+    if (dy == 0 || index.isEmpty()) {
+        return;
+    }
+    QPoint pos = viewport()->mapFromGlobal(QCursor::pos());
+    RVA anchor = addressAt(pos);
+    if (anchor == RVA_INVALID) {
+        anchor = index.begin();
+    }
+    if (dy > 0) {
+        bytesPerPixel = std::max<ut64>(bytesPerPixel / 2, 1);
+    } else {
+        bytesPerPixel = std::min<ut64>(bytesPerPixel * 2, 1ULL << 30);
+    }
+    updateScrollBars();
+    // Keep the address under the cursor in place
+    int anchorRow = static_cast<int>((anchor - index.begin()) / bytesPerRow());
+    verticalScrollBar()->setValue(anchorRow - pos.y());
+    viewport()->update();
+    event->accept();
+}
+
+void HeapMapWidget::mousePressEvent(QMouseEvent *event)
+{
+    int chunk = index.find(addressAt(qhelpers::mouseEventPos(event).toPoint()));
+    if (chunk >= 0 && event->button() == Qt::LeftButton) {
+        emit chunkClicked(index.offset(chunk));
+    }
+}
+
+void HeapMapWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    int chunk = index.find(addressAt(qhelpers::mouseEventPos(event).toPoint()));
+    if (chunk < 0) {
+        QToolTip::hideText();
+        return;
+    }
+    QString status = index.flags(chunk) & HeapChunkIndex::Free
+            ? tr("free")
+            : (index.flags(chunk) & HeapChunkIndex::Corrupted ? tr("corrupted") : tr("allocated"));
+    QToolTip::showText(qhelpers::mouseEventGlobalPos(event),
+                       tr("Chunk %1\nSize: %2\nStatus: %3")
+                               .arg(RAddressString(index.offset(chunk)))
+                               .arg(RHexString(index.size(chunk)))
+                               .arg(status),
+                       this);
+}
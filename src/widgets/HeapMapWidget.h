@@ -0,0 +1,85 @@
+#ifndef HEAPMAPWIDGET_H
+#define HEAPMAPWIDGET_H
+
+#include "core/Cutter.h"
+
+#include <QAbstractScrollArea>
+#include <QVector>
+
+/**
+ * @brief Compact index of the chunks of a heap, stored as separate arrays sorted by offset so
+ * lookups only touch the offsets.
+ */
+class HeapChunkIndex
+{
+public:
+    enum Flag : quint8 { Free = 1 << 0, Corrupted = 1 << 1 };
+
+    void build(const QVector<Chunk> &chunks);
+
+    int count() const { return offsets.size(); }
+    bool isEmpty() const { return offsets.isEmpty(); }
+    RVA begin() const { return offsets.isEmpty() ? 0 : offsets.first(); }
+    RVA end() const { return offsets.isEmpty() ? 0 : offsets.last() + sizes.last(); }
+
+    /**
+     * @return index of the chunk containing \a addr or -1
+     */
+    int find(RVA addr) const;
+
+    RVA offset(int i) const { return offsets[i]; }
+    ut64 size(int i) const { return sizes[i]; }
+    quint8 flags(int i) const { return chunkFlags[i]; }
+    /**
+     * @brief Binary logarithm of the chunk size
+     */
+    quint8 sizeClass(int i) const { return sizeClasses[i]; }
+
+private:
+    QVector<RVA> offsets;
+    QVector<ut64> sizes;
+    QVector<quint8> chunkFlags;
+    QVector<quint8> sizeClasses;
+};
+
+/**
+ * @brief Bird's-eye view of all chunks of an arena.
+ *
+ * The heap is laid out left to right and top to bottom, every pixel covers the same number of
+ * bytes. Allocated chunks are colored by size class, free chunks are drawn pale. Ctrl + wheel
+ * zooms around the cursor.
+ */
+class HeapMapWidget : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit HeapMapWidget(QWidget *parent = nullptr);
+
+    void setChunks(const QVector<Chunk> &chunks);
+
+signals:
+    void chunkClicked(RVA offset);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    HeapChunkIndex index;
+    /**
+     * Bytes covered by a single pixel
+     */
+    ut64 bytesPerPixel = 16;
+
+    ut64 bytesPerRow() const;
+    RVA addressAt(const QPoint &pos) const;
+    QRgb chunkColor(int i) const;
+    void updateScrollBars();
+};
+
+#endif // HEAPMAPWIDGET_H
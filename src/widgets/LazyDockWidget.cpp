@@ -0,0 +1,34 @@
+#include "LazyDockWidget.h"
+
+LazyDockWidget::LazyDockWidget(MainWindow *main, const QString &name, const QString &title,
+                               Factory factory, const char *refreshSlot)
+    : CutterDockWidget(main), factory(factory), refreshSlot(refreshSlot)
+{
+    setObjectName(name);
+    setWindowTitle(title);
+    setWidget(new QWidget(this));
+}
+
+LazyDockWidget::~LazyDockWidget() = default;
+
+CutterDockWidget *LazyDockWidget::createDock()
+{
+    CutterDockWidget *dock = factory(mainWindow);
+    dock->setObjectName(objectName());
+    dock->setFeatures(features());
+    dock->deserializeViewProperties(viewProperties);
+    if (refreshSlot) {
+        QMetaObject::invokeMethod(dock, refreshSlot);
+    }
+    return dock;
+}
+
+QVariantMap LazyDockWidget::serializeViewProprties()
+{
+    return viewProperties;
+}
+
+void LazyDockWidget::deserializeViewProperties(const QVariantMap &properties)
+{
+    viewProperties = properties;
+}
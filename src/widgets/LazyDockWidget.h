@@ -0,0 +1,45 @@
+#ifndef LAZYDOCKWIDGET_H
+#define LAZYDOCKWIDGET_H
+
+#include "CutterDockWidget.h"
+
+#include <functional>
+
+/**
+ * @brief Lightweight stand-in for a dock which is only constructed once the user looks at it.
+ *
+ * The placeholder carries the object name and title of the real dock, so it is saved and
+ * restored as part of a layout exactly like the real dock would be. View properties given to
+ * the placeholder are kept and passed on to the real dock once it is created.
+ * MainWindow replaces the placeholder with the real dock the first time it becomes visible.
+ */
+class CUTTER_EXPORT LazyDockWidget : public CutterDockWidget
+{
+    Q_OBJECT
+
+public:
+    using Factory = std::function<CutterDockWidget *(MainWindow *)>;
+
+    /**
+     * @param refreshSlot name of a slot of the real dock which fetches its contents, invoked
+     * after construction since the dock missed any previous refreshAll
+     */
+    LazyDockWidget(MainWindow *main, const QString &name, const QString &title, Factory factory,
+                   const char *refreshSlot = nullptr);
+    ~LazyDockWidget() override;
+
+    /**
+     * @brief Construct the real dock with the name and view properties of this placeholder
+     */
+    CutterDockWidget *createDock();
+
+    QVariantMap serializeViewProprties() override;
+    void deserializeViewProperties(const QVariantMap &properties) override;
+
+private:
+    Factory factory;
+    const char *refreshSlot;
+    QVariantMap viewProperties;
+};
+
+#endif // LAZYDOCKWIDGET_H
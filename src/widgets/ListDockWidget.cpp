@@ -62,6 +62,11 @@ void ListDockWidget::setModels(AddressableFilterProxyModel *objectFilterProxyMod
     connect(ui->quickFilterView, &QuickFilterView::filterClosed, ui->treeView,
             static_cast<void (QWidget::*)()>(&QWidget::setFocus));
 
-    connect(ui->quickFilterView, &QuickFilterView::filterTextChanged, this,
-            [this] { tree->showItemsNumber(this->objectFilterProxyModel->rowCount()); });
+    auto updateItemsNumber = [this] {
+        tree->showItemsNumber(this->objectFilterProxyModel->rowCount());
+    };
+    connect(ui->quickFilterView, &QuickFilterView::filterTextChanged, this, updateItemsNumber);
+    // Models may insert or remove single rows instead of resetting
+    connect(objectFilterProxyModel, &QAbstractItemModel::rowsInserted, this, updateItemsNumber);
+    connect(objectFilterProxyModel, &QAbstractItemModel::rowsRemoved, this, updateItemsNumber);
 }
@@ -2,18 +2,25 @@
 #include "ui_SearchWidget.h"
 #include "core/MainWindow.h"
 #include "common/Helpers.h"
+#include "dialogs/AsyncTaskDialog.h"
 
 #include <QDockWidget>
+#include <QFileDialog>
 #include <QTreeWidget>
 #include <QComboBox>
 #include <QShortcut>
 
+#include <numeric>
+
 namespace {
 
 static const int kMaxTooltipWidth = 500;
 static const int kMaxTooltipDisasmPreviewLines = 10;
 static const int kMaxTooltipHexdumpBytes = 64;
 
+// Search space running MultiPatternSearchTask instead of a Rizin search command
+static const QString kPatternListSearchSpace = QStringLiteral("patterns");
+
 }
 
 static const QMap<QString, QString> searchBoundaries {
@@ -194,23 +201,23 @@ SearchWidget::SearchWidget(MainWindow *main) : CutterDockWidget(main), ui(new Ui
             [this]() { qhelpers::emitColumnChanged(search_model, SearchModel::COMMENT); });
 
     QShortcut *enter_press = new QShortcut(QKeySequence(Qt::Key_Return), this);
-    connect(enter_press, &QShortcut::activated, this, [this]() {
-        refreshSearch();
-        checkSearchResultEmpty();
-    });
+    connect(enter_press, &QShortcut::activated, this, &SearchWidget::startSearch);
     enter_press->setContext(Qt::WidgetWithChildrenShortcut);
 
-    connect(ui->searchButton, &QAbstractButton::clicked, this, [this]() {
-        refreshSearch();
-        checkSearchResultEmpty();
-    });
+    connect(ui->searchButton, &QAbstractButton::clicked, this, &SearchWidget::startSearch);
 
     connect(ui->searchspaceCombo,
             static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
             [this](int index) { updatePlaceholderText(index); });
 }
 
-SearchWidget::~SearchWidget() {}
+SearchWidget::~SearchWidget()
+{
+    if (patternSearchTask) {
+        patternSearchTask->interrupt();
+        patternSearchTask->wait();
+    }
+}
 
 void SearchWidget::updateSearchBoundaries()
 {
@@ -253,6 +260,7 @@ void SearchWidget::refreshSearchspaces()
     ui->searchspaceCombo->addItem(tr("hex string"), QVariant("/xj"));
     ui->searchspaceCombo->addItem(tr("ROP gadgets"), QVariant("/Rj"));
     ui->searchspaceCombo->addItem(tr("32bit value"), QVariant("/vj"));
+    ui->searchspaceCombo->addItem(tr("hex pattern list"), QVariant(kPatternListSearchSpace));
 
     if (cur_idx > 0)
         ui->searchspaceCombo->setCurrentIndex(cur_idx);
@@ -260,12 +268,35 @@ void SearchWidget::refreshSearchspaces()
     refreshSearch();
 }
 
+void SearchWidget::startSearch()
+{
+    if (ui->searchspaceCombo->currentData().toString() != kPatternListSearchSpace) {
+        refreshSearch();
+        checkSearchResultEmpty();
+        return;
+    }
+
+    if (ui->filterLineEdit->text().isEmpty()) {
+        QString fileName = QFileDialog::getOpenFileName(this, tr("Select pattern list"));
+        if (fileName.isEmpty()) {
+            return;
+        }
+        ui->filterLineEdit->setText(fileName);
+    }
+    startPatternListSearch();
+}
+
 void SearchWidget::refreshSearch()
 {
     QString searchFor = ui->filterLineEdit->text();
     QString searchSpace = ui->searchspaceCombo->currentData().toString();
     QString searchIn = ui->searchInCombo->currentData().toString();
 
+    if (searchSpace == kPatternListSearchSpace) {
+        // Pattern list searches scan the whole range, they only run when started explicitly
+        return;
+    }
+
     search_model->beginResetModel();
     search = Core()->getAllSearch(searchFor, searchSpace, searchIn);
     search_model->endResetModel();
@@ -273,6 +304,68 @@ void SearchWidget::refreshSearch()
     qhelpers::adjustColumns(ui->searchTreeView, 3, 0);
 }
 
+void SearchWidget::startPatternListSearch()
+{
+    QString errorMessage;
+    QVector<BytePattern> patterns =
+            MultiPatternSearchTask::loadPatternFile(ui->filterLineEdit->text(), &errorMessage);
+    if (!errorMessage.isEmpty() || patterns.isEmpty()) {
+        QMessageBox::warning(this, tr("Invalid pattern list"),
+                             errorMessage.isEmpty() ? tr("The pattern list is empty.")
+                                                    : errorMessage);
+        return;
+    }
+
+    if (patternSearchTask) {
+        patternSearchTask->interrupt();
+        patternSearchTask->wait();
+    }
+
+    QString searchIn = ui->searchInCombo->currentData().toString();
+    patternSearchTask = QSharedPointer<MultiPatternSearchTask>(
+            new MultiPatternSearchTask(patterns, searchIn));
+    QWeakPointer<MultiPatternSearchTask> task = patternSearchTask;
+    connect(patternSearchTask.data(), &MultiPatternSearchTask::searchFinished, this,
+            [this, task](const QList<SearchDescription> &results,
+                         const QVector<quint64> &hitCounts) {
+                // The results of a search that was restarted in the meantime are outdated
+                QSharedPointer<MultiPatternSearchTask> finishedTask = task.toStrongRef();
+                if (!finishedTask || finishedTask != patternSearchTask) {
+                    return;
+                }
+                patternListSearchFinished(finishedTask->getLog(), results, hitCounts);
+            });
+
+    AsyncTask::Ptr taskPtr = patternSearchTask;
+    AsyncTaskDialog *taskDialog = new AsyncTaskDialog(taskPtr, this);
+    taskDialog->setInterruptOnClose(true);
+    taskDialog->setAttribute(Qt::WA_DeleteOnClose);
+    taskDialog->show();
+
+    Core()->getAsyncTaskManager()->start(taskPtr);
+}
+
+void SearchWidget::patternListSearchFinished(const QString &log,
+                                             const QList<SearchDescription> &results,
+                                             const QVector<quint64> &hitCounts)
+{
+    search_model->beginResetModel();
+    search = results;
+    search_model->endResetModel();
+
+    qhelpers::adjustColumns(ui->searchTreeView, 3, 0);
+
+    // The task log is gone once its dialog closes, keep the summary in the console
+    Core()->message(log.trimmed());
+    quint64 totalHits = std::accumulate(hitCounts.begin(), hitCounts.end(), quint64(0));
+    if (static_cast<quint64>(results.size()) < totalHits) {
+        Core()->message(tr("Only the first %1 hits are listed, see search.maxhits.")
+                                .arg(results.size()));
+    }
+
+    checkSearchResultEmpty();
+}
+
 // No Results Found information message when search returns empty
 // Called by &QShortcut::activated and &QAbstractButton::clicked signals
 void SearchWidget::checkSearchResultEmpty()
@@ -293,20 +386,18 @@ void SearchWidget::setScrollMode()
 
 void SearchWidget::updatePlaceholderText(int index)
 {
-    switch (index) {
-    case 1: // string
+    QString searchSpace = ui->searchspaceCombo->itemData(index).toString();
+    if (searchSpace == "/j") {
         ui->filterLineEdit->setPlaceholderText("foobar");
-        break;
-    case 2: // hex string
+    } else if (searchSpace == "/xj") {
         ui->filterLineEdit->setPlaceholderText("deadbeef");
-        break;
-    case 3: // ROP gadgets
+    } else if (searchSpace == "/Rj") {
         ui->filterLineEdit->setPlaceholderText("pop,,pop");
-        break;
-    case 4: // 32bit value
+    } else if (searchSpace == "/vj") {
         ui->filterLineEdit->setPlaceholderText("0xdeadbeef");
-        break;
-    default:
+    } else if (searchSpace == kPatternListSearchSpace) {
+        ui->filterLineEdit->setPlaceholderText(tr("pattern list file, leave empty to browse"));
+    } else {
         ui->filterLineEdit->setPlaceholderText("jmp rax");
     }
 }
@@ -7,6 +7,7 @@
 #include <QSortFilterProxyModel>
 
 #include "core/Cutter.h"
+#include "common/MultiPatternSearch.h"
 #include "CutterDockWidget.h"
 #include "AddressableItemList.h"
 
@@ -74,8 +75,13 @@ private:
     SearchModel *search_model;
     SearchSortFilterProxyModel *search_proxy_model;
     QList<SearchDescription> search;
+    QSharedPointer<MultiPatternSearchTask> patternSearchTask;
 
+    void startSearch();
     void refreshSearch();
+    void startPatternListSearch();
+    void patternListSearchFinished(const QString &log, const QList<SearchDescription> &results,
+                                   const QVector<quint64> &hitCounts);
     void checkSearchResultEmpty();
     void setScrollMode();
     void updatePlaceholderText(int index);
@@ -7,10 +7,12 @@
 
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsTextItem>
+#include <QGraphicsPixmapItem>
 #include <QGraphicsView>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QShortcut>
+#include <QFileInfo>
 #include <QToolTip>
 
 SectionsModel::SectionsModel(QList<SectionDescription> *sections, QObject *parent)
@@ -164,7 +166,7 @@ bool SectionsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &ri
 SectionsWidget::SectionsWidget(MainWindow *main) : ListDockWidget(main)
 {
     setObjectName("SectionsWidget");
-    setWindowTitle(QStringLiteral("Sections"));
+    setWindowTitle(tr("Sections"));
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
 
     sectionsRefreshDeferrer = createRefreshDeferrer([this]() { refreshSections(); });
@@ -203,7 +205,13 @@ void SectionsWidget::initAddrMapDocks()
     QHBoxLayout *addrDockLayout = new QHBoxLayout();
     addrDockLayout->addWidget(rawAddrDock);
     addrDockLayout->addWidget(virtualAddrDock);
-    addrDockWidget->setLayout(addrDockLayout);
+    heatMapCheckBox = new QCheckBox(tr("Entropy Heat Map"));
+    heatMapCheckBox->setChecked(Config()->getEntropyHeatMapEnabled());
+    QVBoxLayout *addrDockWidgetLayout = new QVBoxLayout();
+    addrDockWidgetLayout->setContentsMargins(0, 0, 0, 0);
+    addrDockWidgetLayout->addWidget(heatMapCheckBox);
+    addrDockWidgetLayout->addLayout(addrDockLayout);
+    addrDockWidget->setLayout(addrDockWidgetLayout);
     layout->addWidget(addrDockWidget);
 
     QPixmap map(":/img/icons/previous.svg");
@@ -235,6 +243,12 @@ void SectionsWidget::initConnects()
     });
     connect(Core(), &CutterCore::seekChanged, this, &SectionsWidget::refreshDocks);
     connect(Config(), &Configuration::colorsUpdated, this, &SectionsWidget::refreshSections);
+    connect(heatMapCheckBox, &QCheckBox::toggled, Config(),
+            &Configuration::setEntropyHeatMapEnabled);
+    connect(Config(), &Configuration::entropyHeatMapChanged, this, [this]() {
+        heatMapCheckBox->setChecked(Config()->getEntropyHeatMapEnabled());
+        refreshDocks();
+    });
     connect(toggleButton, &QToolButton::clicked, this, [=] {
         toggleButton->hide();
         addrDockWidget->show();
@@ -255,10 +269,55 @@ void SectionsWidget::refreshSections()
         return;
     }
     sectionsModel->beginResetModel();
-    sections = Core()->getAllSections();
+    sections = Core()->getAllSections(false);
     sectionsModel->endResetModel();
     qhelpers::adjustColumns(ui->treeView, SectionsModel::ColumnCount, 0);
     refreshDocks();
+    refreshEntropy();
+}
+
+void SectionsWidget::refreshEntropy()
+{
+    FileDigestTask::cancelRequest(this);
+    digest = FileDigest();
+    QString path = Core()->getBinFilePath();
+    if (!QFileInfo(path).isFile()) {
+        // Not a local file, let rizin read the sections through io
+        QList<SectionDescription> withEntropy = Core()->getAllSections(true);
+        if (withEntropy.size() == sections.size()) {
+            for (int i = 0; i < sections.size(); i++) {
+                sections[i].entropy = withEntropy[i].entropy;
+            }
+            qhelpers::emitColumnChanged(sectionsModel, SectionsModel::EntropyColumn);
+        }
+        return;
+    }
+
+    FileDigest digest;
+    if (FileDigestTask::request(
+                path, this, [this](const FileDigest &digest) { showEntropy(digest); }, &digest)) {
+        showEntropy(digest);
+    }
+}
+
+void SectionsWidget::showEntropy(const FileDigest &digest)
+{
+    // The digest has the ranges of all sections of the file, in whatever order
+    QHash<FileDigestTask::Range, double> entropies;
+    for (int i = 0; i < digest.ranges.size(); i++) {
+        entropies.insert(digest.ranges[i], digest.rangeEntropy[i]);
+    }
+    for (SectionDescription &section : sections) {
+        auto it = entropies.constFind({ section.paddr, section.size });
+        if (it != entropies.constEnd()) {
+            section.entropy = QString::number(*it, 'f', 8);
+        }
+    }
+    this->digest = digest;
+    qhelpers::emitColumnChanged(sectionsModel, SectionsModel::EntropyColumn);
+    if (heatMapCheckBox->isChecked()) {
+        refreshDocks();
+    }
 }
 
 void SectionsWidget::refreshDocks()
@@ -266,6 +325,9 @@ void SectionsWidget::refreshDocks()
     if (!dockRefreshDeferrer->attemptRefresh(nullptr)) {
         return;
     }
+    const FileDigest *heatMapDigest = heatMapCheckBox->isChecked() ? &digest : nullptr;
+    rawAddrDock->setDigest(heatMapDigest);
+    virtualAddrDock->setDigest(heatMapDigest);
     rawAddrDock->updateDock();
     virtualAddrDock->updateDock();
     drawIndicatorOnAddrDocks();
@@ -367,6 +429,26 @@ void AbstractAddrDock::updateDock()
         QGraphicsRectItem *rect = new QGraphicsRectItem(rectOffset, y, rectWidth, drawSize);
         rect->setBrush(QBrush(idx.data(Qt::DecorationRole).value<QColor>()));
         addrDockScene->addItem(rect);
+        if (digest && !digest->blockLevels.isEmpty() && drawSize > 0) {
+            // One row per pixel, the rows past the file size of the section stay flat
+            QImage heatMap(1, drawSize, QImage::Format_ARGB32);
+            heatMap.fill(Qt::transparent);
+            double rowSize = static_cast<double>(size) / drawSize;
+            for (int row = 0; row < drawSize; row++) {
+                RVA offset = static_cast<RVA>(rowSize * row);
+                if (offset >= desc.size) {
+                    break;
+                }
+                RVA rowEnd = std::min(std::max(offset + 1, static_cast<RVA>(rowSize * (row + 1))),
+                                      desc.size);
+                heatMap.setPixel(0, row,
+                                 FileDigestTask::heatColor(digest->blockStats(
+                                         desc.paddr + offset, rowEnd - offset)));
+            }
+            QGraphicsPixmapItem *heatMapItem = addrDockScene->addPixmap(
+                    QPixmap::fromImage(heatMap.scaled(rectWidth, drawSize)));
+            heatMapItem->setPos(rectOffset, y);
+        }
 
         addTextItem(textColor, QPoint(0, y), RAddressString(addr));
         addTextItem(textColor, QPoint(rectOffset, y), RSizeString(size));
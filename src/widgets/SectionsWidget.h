@@ -5,6 +5,7 @@
 #include <map>
 
 #include <QtWidgets/QToolButton>
+#include <QCheckBox>
 #include <QAbstractListModel>
 #include <QSortFilterProxyModel>
 #include <QGraphicsScene>
@@ -12,6 +13,7 @@
 #include <QHash>
 
 #include "core/Cutter.h"
+#include "common/FileDigestTask.h"
 #include "CutterDockWidget.h"
 #include "widgets/ListDockWidget.h"
 
@@ -83,6 +85,7 @@ public:
 private slots:
     void refreshSections();
     void refreshDocks();
+    void showEntropy(const FileDigest &digest);
 
 protected:
     void resizeEvent(QResizeEvent *event) override;
@@ -107,7 +110,14 @@ private:
      */
     RefreshDeferrer *dockRefreshDeferrer;
 
+    /**
+     * Block statistics and entropy of the sections, computed from the file in the background
+     */
+    FileDigest digest;
+    QCheckBox *heatMapCheckBox;
+
     void initSectionsTable();
+    void refreshEntropy();
     void initQuickFilter();
     void initConnects();
     void initAddrMapDocks();
@@ -127,6 +137,12 @@ public:
 
     virtual void updateDock();
 
+    /**
+     * @brief Color the sections by the block statistics of \a digest instead of a flat color,
+     * nullptr to disable
+     */
+    void setDigest(const FileDigest *digest) { this->digest = digest; }
+
 protected:
     int indicatorHeight;
     int indicatorParamPosY;
@@ -140,6 +156,7 @@ protected:
     AddrDockScene *addrDockScene;
     QGraphicsView *graphicsView;
     SectionsProxyModel *proxyModel;
+    const FileDigest *digest = nullptr;
 
     void addTextItem(QColor color, QPoint pos, QString string);
     int getAdjustedSize(int size, int validMinSize);
@@ -58,6 +58,7 @@ void SimpleTextGraphView::refreshView()
 {
     initFont();
     setLayoutConfig(getLayoutConfig());
+    setCacheDirty();
     saveCurrentBlock();
     loadCurrentGraph();
     if (blocks.find(selectedBlock) == blocks.end()) {
@@ -72,6 +73,7 @@ void SimpleTextGraphView::selectBlockWithId(ut64 blockId)
     if (!enableBlockSelection) {
         return;
     }
+    setCacheDirty();
     auto contentIt = blockContent.find(blockId);
     if (contentIt != blockContent.end()) {
         selectedBlock = blockId;
@@ -143,6 +145,7 @@ void SimpleTextGraphView::setBlockSelectionEnabled(bool value)
     enableBlockSelection = value;
     if (!value) {
         selectedBlock = NO_BLOCK_SELECTED;
+        setCacheDirty();
     }
 }
 
@@ -244,10 +247,3 @@ void SimpleTextGraphView::restoreCurrentBlock()
         }
     }
 }
-
-void SimpleTextGraphView::paintEvent(QPaintEvent *event)
-{
-    // SimpleTextGraphView is always dirty
-    setCacheDirty();
-    GraphView::paintEvent(event);
-}
@@ -1,19 +1,20 @@
 #include "VisualNavbar.h"
 #include "core/MainWindow.h"
-#include "common/TempConfig.h"
 
 #include <QGraphicsView>
 #include <QComboBox>
 #include <QGraphicsScene>
 #include <QGraphicsRectItem>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
-#include <QJsonParseError>
+#include <QGraphicsPixmapItem>
+#include <QImage>
 #include <QToolTip>
 #include <QMouseEvent>
+#include <QContextMenuEvent>
+#include <QFileInfo>
+#include <QMenu>
+#include <QTimer>
 
-#include <array>
+#include <algorithm>
 #include <cmath>
 
 VisualNavbar::VisualNavbar(MainWindow *main, QWidget *parent)
@@ -21,7 +22,8 @@ VisualNavbar::VisualNavbar(MainWindow *main, QWidget *parent)
       graphicsView(new QGraphicsView),
       seekGraphicsItem(nullptr),
       PCGraphicsItem(nullptr),
-      main(main)
+      main(main),
+      sceneUpdateTimer(new QTimer(this))
 {
     Q_UNUSED(parent);
 
@@ -46,8 +48,38 @@ VisualNavbar::VisualNavbar(MainWindow *main, QWidget *parent)
     connect(Core(), &CutterCore::seekChanged, this, &VisualNavbar::on_seekChanged);
     connect(Core(), &CutterCore::registersChanged, this, &VisualNavbar::drawPCCursor);
     connect(Core(), &CutterCore::refreshAll, this, &VisualNavbar::fetchAndPaintData);
-    connect(Core(), &CutterCore::functionsChanged, this, &VisualNavbar::fetchAndPaintData);
-    connect(Core(), &CutterCore::flagsChanged, this, &VisualNavbar::fetchAndPaintData);
+    connect(Core(), &CutterCore::functionsChanged, this, &VisualNavbar::updateFunctions);
+    // Single changes patch the counts, the scene is rebuilt once for all changes of an iteration
+    // of the event loop
+    sceneUpdateTimer->setSingleShot(true);
+    sceneUpdateTimer->setInterval(0);
+    connect(sceneUpdateTimer, &QTimer::timeout, this, &VisualNavbar::updateGraphicsScene);
+    auto updateFunction = [this](const FunctionDescription &function) {
+        occupancy.updateFunction(function.offset);
+        sceneUpdateTimer->start();
+    };
+    connect(Core(), &CutterCore::functionAdded, this, updateFunction);
+    connect(Core(), &CutterCore::functionChanged, this, updateFunction);
+    connect(Core(), &CutterCore::functionRemoved, this,
+            [this](const FunctionDescription &function) {
+                occupancy.removeFunction(function.offset);
+                sceneUpdateTimer->start();
+            });
+    connect(Core(), &CutterCore::flagsReset, this, &VisualNavbar::updateFlags);
+    connect(Core(), &CutterCore::flagAdded, this,
+            [this](const FlagDescription &flag) { occupancy.addFlag(flag, 1); });
+    connect(Core(), &CutterCore::flagRemoved, this,
+            [this](const FlagDescription &flag) { occupancy.addFlag(flag, -1); });
+    connect(Core(), &CutterCore::flagChanged, this,
+            [this](const FlagDescription &oldFlag, const FlagDescription &flag) {
+                occupancy.addFlag(oldFlag, -1);
+                occupancy.addFlag(flag, 1);
+            });
+    connect(Core(), &CutterCore::flagsChanged, this, [this]() { sceneUpdateTimer->start(); });
+    connect(Config(), &Configuration::entropyHeatMapChanged, this, [this]() {
+        fetchDigest();
+        updateGraphicsScene();
+    });
 
     graphicsScene = new QGraphicsScene(this);
 
@@ -70,16 +102,6 @@ VisualNavbar::VisualNavbar(MainWindow *main, QWidget *parent)
     setMouseTracking(true);
 }
 
-unsigned int nextPow2(unsigned int n)
-{
-    unsigned int b = 0;
-    while (n) {
-        n >>= 1;
-        b++;
-    }
-    return (1u << b);
-}
-
 void VisualNavbar::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event);
@@ -87,18 +109,7 @@ void VisualNavbar::paintEvent(QPaintEvent *event)
     QPainter painter(this);
 
     auto w = static_cast<unsigned int>(width());
-    bool fetch = false;
-    if (statsWidth < w) {
-        statsWidth = nextPow2(w);
-        fetch = true;
-    } else if (statsWidth > w * 4) {
-        statsWidth = statsWidth > 0 ? statsWidth / 2 : 0;
-        fetch = true;
-    }
-
-    if (fetch) {
-        fetchAndPaintData();
-    } else if (previousWidth != w) {
+    if (previousWidth != w) {
         this->previousWidth = w;
         updateGraphicsScene();
     }
@@ -112,10 +123,46 @@ void VisualNavbar::fetchAndPaintData()
 
 void VisualNavbar::fetchStats()
 {
-    stats = Core()->getBlockStatistics(statsWidth);
+    occupancy.load();
+    fetchDigest();
+}
+
+void VisualNavbar::fetchDigest()
+{
+    FileDigestTask::cancelRequest(this);
+    digest = FileDigest();
+    fileSections.clear();
+
+    QString path = Core()->getBinFilePath();
+    if (!Config()->getEntropyHeatMapEnabled() || !QFileInfo(path).isFile()) {
+        return;
+    }
+    fileSections = Core()->getAllSections(false);
+    std::sort(fileSections.begin(), fileSections.end(),
+              [](const SectionDescription &a, const SectionDescription &b) {
+                  return a.vaddr < b.vaddr;
+              });
+
+    FileDigestTask::request(
+            path, this, [this](const FileDigest &digest) { setDigest(digest); }, &digest);
+}
+
+void VisualNavbar::setDigest(const FileDigest &digest)
+{
+    this->digest = digest;
+    updateGraphicsScene();
+}
+
+void VisualNavbar::updateFunctions()
+{
+    occupancy.loadFunctions();
+    updateGraphicsScene();
 }
 
-enum class DataType : int { Empty, Code, String, Symbol, Count };
+void VisualNavbar::updateFlags()
+{
+    occupancy.loadFlags();
+}
 
 void VisualNavbar::updateGraphicsScene()
 {
@@ -125,83 +172,88 @@ void VisualNavbar::updateGraphicsScene()
     PCGraphicsItem = nullptr;
     graphicsScene->setBackgroundBrush(QBrush(Config()->getColor("gui.navbar.empty")));
 
-    if (stats.to <= stats.from) {
-        return;
-    }
-
     int w = graphicsView->width();
     int h = graphicsView->height();
+    if (occupancy.isEmpty() || w <= 0) {
+        return;
+    }
 
-    RVA totalSize = stats.to - stats.from;
-    RVA beginAddr = stats.from;
+    sceneUpdateTimer->stop();
 
-    double widthPerByte = (double)w / (double)totalSize;
+    RVA beginAddr = occupancy.getFrom();
+    RVA totalSize = occupancy.getTo() - beginAddr;
+    auto addrFromX = [beginAddr, totalSize, w](int x) -> RVA {
+        return beginAddr + static_cast<RVA>(static_cast<double>(totalSize) * x / w);
+    };
+    double widthPerByte = static_cast<double>(w) / totalSize;
     auto xFromAddr = [widthPerByte, beginAddr](RVA addr) -> double {
         return (addr - beginAddr) * widthPerByte;
     };
 
-    std::array<QBrush, static_cast<int>(DataType::Count)> dataTypeBrushes;
-    dataTypeBrushes[static_cast<int>(DataType::Code)] =
-            QBrush(Config()->getColor("gui.navbar.code"));
-    dataTypeBrushes[static_cast<int>(DataType::String)] =
-            QBrush(Config()->getColor("gui.navbar.str"));
-    dataTypeBrushes[static_cast<int>(DataType::Symbol)] =
-            QBrush(Config()->getColor("gui.navbar.sym"));
-
-    DataType lastDataType = DataType::Empty;
-    QGraphicsRectItem *dataItem = nullptr;
-    QRectF dataItemRect(0.0, 0.0, 0.0, h);
-    for (const BlockDescription &block : stats.blocks) {
-        // Keep track of where which memory segment is mapped so we are able to convert from
-        // address to X coordinate and vice versa.
+    // Keep track of where which memory segment is mapped so we are able to convert from
+    // address to X coordinate and vice versa.
+    for (const auto &region : occupancy.getRegions()) {
         XToAddress x2a;
-        x2a.x_start = xFromAddr(block.addr);
-        x2a.x_end = xFromAddr(block.addr + block.size);
-        x2a.address_from = block.addr;
-        x2a.address_to = block.addr + block.size;
+        x2a.x_start = xFromAddr(region.first);
+        x2a.x_end = xFromAddr(region.first + region.second);
+        x2a.address_from = region.first;
+        x2a.address_to = region.first + region.second;
         xToAddress.append(x2a);
+    }
 
-        DataType dataType;
-        if (block.functions > 0) {
-            dataType = DataType::Code;
-        } else if (block.strings > 0) {
-            dataType = DataType::String;
-        } else if (block.symbols > 0) {
-            dataType = DataType::Symbol;
-        } else if (block.inFunctions > 0) {
-            dataType = DataType::Code;
-        } else {
-            lastDataType = DataType::Empty;
-            continue;
-        }
-
-        if (dataType == lastDataType) {
-            double r = xFromAddr(block.addr + block.size);
-            if (r > dataItemRect.right()) {
-                dataItemRect.setRight(r);
-                dataItem->setRect(dataItemRect);
-            }
-            dataItem->setRect(dataItemRect);
-            continue;
+    const QRgb codeColor = Config()->getColor("gui.navbar.code").rgba();
+    const QRgb stringColor = Config()->getColor("gui.navbar.str").rgba();
+    const QRgb symbolColor = Config()->getColor("gui.navbar.sym").rgba();
+    const QRgb emptyColor = Config()->getColor("gui.navbar.empty").rgba();
+
+    QImage image(w, 1, QImage::Format_ARGB32);
+    QRgb *pixels = reinterpret_cast<QRgb *>(image.scanLine(0));
+    const bool heatMap = !digest.blockLevels.isEmpty();
+    for (int x = 0; x < w; x++) {
+        RVA from = addrFromX(x);
+        RVA to = std::max(from + 1, addrFromX(x + 1));
+        QRgb color = emptyColor;
+        if (heatMap) {
+            color = heatColorForRange(from, to, emptyColor);
+        } else if (occupancy.count(AddressOccupancyMap::Functions, from, to) > 0) {
+            color = codeColor;
+        } else if (occupancy.count(AddressOccupancyMap::Strings, from, to) > 0) {
+            color = stringColor;
+        } else if (occupancy.count(AddressOccupancyMap::Symbols, from, to) > 0) {
+            color = symbolColor;
+        } else if (occupancy.count(AddressOccupancyMap::InFunctions, from, to) > 0) {
+            color = codeColor;
         }
-
-        dataItemRect.setX(xFromAddr(block.addr));
-        dataItemRect.setRight(xFromAddr(block.addr + block.size));
-
-        dataItem = new QGraphicsRectItem();
-        dataItem->setPen(Qt::NoPen);
-        dataItem->setBrush(dataTypeBrushes[static_cast<int>(dataType)]);
-        graphicsScene->addItem(dataItem);
-
-        lastDataType = dataType;
+        pixels[x] = color;
     }
 
+    QGraphicsPixmapItem *dataItem =
+            graphicsScene->addPixmap(QPixmap::fromImage(image.scaled(w, h)));
+    dataItem->setPos(0, 0);
+
     // Update scene width
     graphicsScene->setSceneRect(0, 0, w, h);
 
     drawSeekCursor();
 }
 
+QRgb VisualNavbar::heatColorForRange(RVA from, RVA to, QRgb emptyColor)
+{
+    // Color by the file contents of the first section mapped into the range
+    for (const SectionDescription &section : fileSections) {
+        if (section.vaddr >= to) {
+            break;
+        }
+        RVA begin = std::max(from, section.vaddr);
+        RVA end = std::min(to, section.vaddr + std::min(section.vsize, section.size));
+        if (begin < end) {
+            return FileDigestTask::heatColor(
+                    digest.blockStats(section.paddr + (begin - section.vaddr), end - begin));
+        }
+    }
+    return emptyColor;
+}
+
 void VisualNavbar::drawCursor(RVA addr, QColor color, QGraphicsRectItem *&graphicsItem)
 {
     double cursor_x = addressToLocalX(addr);
@@ -258,6 +310,18 @@ void VisualNavbar::mouseMoveEvent(QMouseEvent *event)
     mousePressEvent(event);
 }
 
+void VisualNavbar::contextMenuEvent(QContextMenuEvent *event)
+{
+    QMenu menu(this);
+    QAction *heatMapAction = menu.addAction(tr("Entropy Heat Map"));
+    heatMapAction->setCheckable(true);
+    heatMapAction->setChecked(Config()->getEntropyHeatMapEnabled());
+    connect(heatMapAction, &QAction::toggled, this,
+            [](bool checked) { Config()->setEntropyHeatMapEnabled(checked); });
+    menu.exec(event->globalPos());
+    event->accept();
+}
+
 RVA VisualNavbar::localXToAddress(double x)
 {
     for (const XToAddress &x2a : xToAddress) {
@@ -286,7 +350,7 @@ double VisualNavbar::addressToLocalX(RVA address)
 QList<QString> VisualNavbar::sectionsForAddress(RVA address)
 {
     QList<QString> ret;
-    QList<SectionDescription> sections = Core()->getAllSections();
+    QList<SectionDescription> sections = Core()->getAllSections(false);
     for (const SectionDescription &section : sections) {
         if (address >= section.vaddr && address < section.vaddr + section.vsize) {
             ret << section.name;
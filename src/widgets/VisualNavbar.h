@@ -5,9 +5,13 @@
 #include <QGraphicsScene>
 
 #include "core/Cutter.h"
+#include "common/AddressOccupancyMap.h"
+#include "common/FileDigestTask.h"
+
 
 class MainWindow;
 class QGraphicsView;
+class QTimer;
 
 class VisualNavbar : public QToolBar
 {
@@ -31,6 +35,10 @@ public slots:
 private slots:
     void fetchAndPaintData();
     void fetchStats();
+    void fetchDigest();
+    void setDigest(const FileDigest &digest);
+    void updateFunctions();
+    void updateFlags();
     void drawSeekCursor();
     void drawPCCursor();
     void drawCursor(RVA addr, QColor color, QGraphicsRectItem *&graphicsItem);
@@ -42,9 +50,16 @@ private:
     QGraphicsRectItem *seekGraphicsItem;
     QGraphicsRectItem *PCGraphicsItem;
     MainWindow *main;
+    QTimer *sceneUpdateTimer;
+
+    AddressOccupancyMap occupancy;
 
-    BlockStatistics stats;
-    unsigned int statsWidth = 0;
+    /**
+     * Block statistics of the file and the sections to map them to addresses, only loaded when
+     * the entropy heat map is enabled
+     */
+    FileDigest digest;
+    QList<SectionDescription> fileSections;
     unsigned int previousWidth = 0;
 
     QList<XToAddress> xToAddress;
@@ -53,9 +68,11 @@ private:
     double addressToLocalX(RVA address);
     QList<QString> sectionsForAddress(RVA address);
     QString toolTipForAddress(RVA address);
+    QRgb heatColorForRange(RVA from, RVA to, QRgb emptyColor);
 
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
+    void contextMenuEvent(QContextMenuEvent *event) override;
 };
 
 #endif // VISUALNAVBAR_H